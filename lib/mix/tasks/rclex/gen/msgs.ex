@@ -46,6 +46,34 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
   config :rclex, ros2_directories: ["/home/ros/workspace/install/example_msgs"]
   ```
 
+  Only the files whose content changed are rewritten, files of types which are no longer
+  configured are removed, and the parsed msg definitions are cached in the build directory.
+  So after a change of the configured types only the affected files are recompiled.
+  To regenerate all files
+
+  ```
+  mix rclex.gen.msgs --force
+  ```
+
+  ## How to reduce the generated C code
+
+  By default a converter between Elixir terms and ROS 2 messages is generated in C for every
+  message type. With the following configuration only the type support accessor is generated
+  per type and the conversion is done by a single generic converter which is driven by the
+  `rosidl_typesupport_introspection_c` member tables of the type.
+
+  ```
+  config :rclex, message_converter: :introspection
+  ```
+
+  With the introspection converter the type support accessors in C can be dropped as well.
+  The type support of each type is then resolved on first use from the installed library of its
+  package, which is only loaded once a type of the package is used.
+
+  ```
+  config :rclex, message_converter: :introspection, type_support: :lazy
+  ```
+
   ## How to clean
 
   ```
@@ -64,20 +92,21 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
   @doc false
   def run(args) do
     {valid_options, _, _} =
-      OptionParser.parse(args, strict: [from: :keep, clean: :boolean, show_types: :boolean])
+      OptionParser.parse(args,
+        strict: [from: :keep, clean: :boolean, show_types: :boolean, force: :boolean]
+      )
 
     {from, valid_options} = Keyword.pop_values(valid_options, :from)
+    {force, valid_options} = Keyword.pop(valid_options, :force, false)
 
     case valid_options do
       [] when from != [] ->
-        clean()
-        generate(from, rclex_dir_path!())
-        recompile!()
+        if force, do: clean()
+        recompile!(generate(from, rclex_dir_path!()))
 
       [] ->
-        clean()
-        generate(rclex_dir_path!())
-        recompile!()
+        if force, do: clean()
+        recompile!(generate(rclex_dir_path!()))
 
       [clean: true] when from == [] ->
         clean()
@@ -144,53 +173,102 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
       Enum.map(srv_types, fn type -> String.replace_suffix(type, "", "_Request") end) ++
         Enum.map(srv_types, fn type -> String.replace_suffix(type, "", "_Response") end)
 
-    ros2_message_type_map =
-      Enum.reduce(msg_types ++ srv_msg_types, %{}, fn type, acc ->
-        get_ros2_message_type_map(type, from, acc)
-      end)
+    cache = read_cache()
 
-    types = Map.keys(ros2_message_type_map)
+    {ros2_message_type_map, cache} =
+      get_ros2_message_type_map_async(msg_types ++ srv_msg_types, from, cache)
 
-    for {:msg_type, type} <- types do
-      [interfaces, interface_type, type_name] = String.split(type, "/")
+    write_cache(cache)
 
-      if interface_type != "msg" and interface_type != "srv" do
-        raise "unknown interface type #{interface_type}"
+    types = Map.keys(ros2_message_type_map)
+
+    files =
+      types
+      |> Task.async_stream(&generate_type(&1, ros2_message_type_map, to), timeout: :infinity)
+      |> Enum.flat_map(fn {:ok, files} -> files end)
+
+    files =
+      files ++
+        [
+          {Path.join(to, "lib/rclex/msg_funcs.ex"), generate_msg_funcs_ex(types)},
+          {Path.join(to, "src/msg_funcs.h"), generate_msg_funcs_h(types)},
+          {Path.join(to, "src/msg_funcs.ec"), generate_msg_funcs_c(types)}
+        ]
+
+    file_pathes = MapSet.new(files, fn {file_path, _binary} -> Path.expand(file_path) end)
+
+    removed =
+      for file_path <- generated_file_pathes(to),
+          not MapSet.member?(file_pathes, Path.expand(file_path)) do
+        File.rm!(file_path)
+        file_path
       end
 
-      type_name = Util.to_down_snake(type_name)
+    # The Makefile links the type support library of every package with a directory here.
+    for dir_path <- Path.wildcard(Path.join(to, "src/pkgs/*/msg")), File.ls!(dir_path) == [] do
+      File.rmdir!(dir_path)
+    end
+
+    written =
+      for {file_path, binary} <- files, write_if_changed!(file_path, binary), do: file_path
 
-      dir_path_ex = Path.join(to, "lib/rclex/pkgs/#{interfaces}/#{interface_type}")
-      dir_path_c = Path.join(to, "src/pkgs/#{interfaces}/#{interface_type}")
+    removed ++ written
+  end
 
-      File.mkdir_p!(dir_path_ex)
-      File.mkdir_p!(dir_path_c)
+  defp generate_type({:msg_type, type}, ros2_message_type_map, to) do
+    [interfaces, interface_type, type_name] = String.split(type, "/")
 
-      for {dir_path, file_name, binary} <- [
-            {dir_path_ex, "#{type_name}.ex", MsgEx.generate(type, ros2_message_type_map)},
-            {dir_path_c, "#{type_name}.h", MsgH.generate(type, ros2_message_type_map)},
-            {dir_path_c, "#{type_name}.c", MsgC.generate(type, ros2_message_type_map)}
-          ] do
-        File.write!(Path.join(dir_path, file_name), binary)
-      end
+    if interface_type != "msg" and interface_type != "srv" do
+      raise "unknown interface type #{interface_type}"
+    end
+
+    type_name = Util.to_down_snake(type_name)
+
+    dir_path_ex = Path.join(to, "lib/rclex/pkgs/#{interfaces}/#{interface_type}")
+    dir_path_c = Path.join(to, "src/pkgs/#{interfaces}/#{interface_type}")
+
+    file_ex = Path.join(dir_path_ex, "#{type_name}.ex")
+
+    case Util.type_support() do
+      :lazy ->
+        [{file_ex, MsgEx.generate(type, ros2_message_type_map)}]
+
+      :linked ->
+        [
+          {file_ex, MsgEx.generate(type, ros2_message_type_map)},
+          {Path.join(dir_path_c, "#{type_name}.h"), MsgH.generate(type, ros2_message_type_map)},
+          {Path.join(dir_path_c, "#{type_name}.c"), MsgC.generate(type, ros2_message_type_map)}
+        ]
+    end
+  end
+
+  # Leaves unchanged files untouched, so that their mtime does not trigger a rebuild.
+  defp write_if_changed!(file_path, binary) do
+    case File.read(file_path) do
+      {:ok, ^binary} ->
+        false
+
+      _ ->
+        File.mkdir_p!(Path.dirname(file_path))
+        File.write!(file_path, binary)
+        true
     end
+  end
 
-    File.write!(Path.join(to, "lib/rclex/msg_funcs.ex"), generate_msg_funcs_ex(types))
-    File.write!(Path.join(to, "src/msg_funcs.h"), generate_msg_funcs_h(types))
-    File.write!(Path.join(to, "src/msg_funcs.ec"), generate_msg_funcs_c(types))
+  defp generated_file_pathes(dir_path) do
+    Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/msg/*.ex")) ++
+      Path.wildcard(Path.join(dir_path, "src/pkgs/*/msg/*.{h,c}")) ++
+      Path.wildcard(Path.join(dir_path, "src/pkgs/*/srv/*___request.{h,c}")) ++
+      Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/srv/*_request.ex")) ++
+      Path.wildcard(Path.join(dir_path, "src/pkgs/*/srv/*___response.{h,c}")) ++
+      Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/srv/*_response.ex"))
   end
 
   @doc false
   def clean() do
     dir_path = rclex_dir_path!()
 
-    for file_path <-
-          Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/msg/*.ex")) ++
-            Path.wildcard(Path.join(dir_path, "src/pkgs/*/msg/*.{h,c}")) ++
-            Path.wildcard(Path.join(dir_path, "src/pkgs/*/srv/*___request.{h,c}")) ++
-            Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/srv/*_request.ex")) ++
-            Path.wildcard(Path.join(dir_path, "src/pkgs/*/srv/*___response.{h,c}")) ++
-            Path.wildcard(Path.join(dir_path, "lib/rclex/pkgs/*/srv/*_response.ex")) do
+    for file_path <- generated_file_pathes(dir_path) do
       File.rm!(file_path)
     end
 
@@ -212,6 +290,23 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
 
   @doc false
   def generate_msg_funcs_c(types) do
+    case Util.type_support() do
+      :lazy -> ""
+      :linked -> generate_msg_funcs_c(types, Util.message_converter())
+    end
+  end
+
+  defp generate_msg_funcs_c(types, :introspection) do
+    Enum.map_join(types, fn {:msg_type, type} ->
+      function_prefix = Util.type_down_snake(type)
+
+      """
+      {"#{function_prefix}_type_support!", 0, nif_#{function_prefix}_type_support, REGULAR_NIF},
+      """
+    end)
+  end
+
+  defp generate_msg_funcs_c(types, :generated) do
     Enum.map_join(types, fn {:msg_type, type} ->
       function_prefix = Util.type_down_snake(type)
 
@@ -221,12 +316,15 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
       {"#{function_prefix}_destroy!", 1, nif_#{function_prefix}_destroy, REGULAR_NIF},
       {"#{function_prefix}_set!", 2, nif_#{function_prefix}_set, REGULAR_NIF},
       {"#{function_prefix}_get!", 1, nif_#{function_prefix}_get, REGULAR_NIF},
+      {"#{function_prefix}_get_field!", 2, nif_#{function_prefix}_get_field, REGULAR_NIF},
       """
     end)
   end
 
   @doc false
   def generate_msg_funcs_h(types) do
+    types = if Util.type_support() == :lazy, do: [], else: types
+
     Enum.map_join(types, fn {:msg_type, type} ->
       [interfaces, interface_type, type] = String.split(type, "/")
       file_path = Path.join([interfaces, interface_type, Util.to_down_snake(type)]) <> ".h"
@@ -239,13 +337,24 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
 
   @doc false
   def generate_msg_funcs_ex(types) do
-    suffix_args_list = [
-      {"type_support!", ""},
-      {"create!", ""},
-      {"destroy!", "_msg"},
-      {"set!", "_msg, _data"},
-      {"get!", "_msg"}
-    ]
+    suffix_args_list =
+      case {Util.type_support(), Util.message_converter()} do
+        {:lazy, _converter} ->
+          []
+
+        {:linked, :generated} ->
+          [
+            {"type_support!", ""},
+            {"create!", ""},
+            {"destroy!", "_msg"},
+            {"set!", "_msg, _data"},
+            {"get!", "_msg"},
+            {"get_field!", "_msg, _path"}
+          ]
+
+        {:linked, :introspection} ->
+          [{"type_support!", ""}]
+      end
 
     msg_funcs =
       for {:msg_type, type} <- types, {suffix, args} <- suffix_args_list do
@@ -331,11 +440,9 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
 
   @doc false
   def get_ros2_message_type_map(ros2_message_type, from, acc \\ %{}) do
-    {:ok, fields, _rest, _context, _line, _column} =
+    fields =
       get_msg_definition(ros2_message_type, from)
-      |> MessageParser.parse()
-
-    fields = to_complete_fields(fields, ros2_message_type)
+      |> parse_fields(ros2_message_type)
 
     type_map = Map.put(acc, {:msg_type, ros2_message_type}, fields)
 
@@ -356,6 +463,86 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
     end)
   end
 
+  @doc false
+  # Same as get_ros2_message_type_map/3 for a list of types, but parses the types of each level
+  # of dependencies in parallel and reuses the fields of definitions found in the cache, which
+  # is keyed by type and definition. Returns the type map and the cache entries used.
+  def get_ros2_message_type_map_async(ros2_message_types, from, cache \\ %{}) do
+    collect_types(Enum.uniq(ros2_message_types), from, %{}, cache, %{})
+  end
+
+  defp collect_types([], _from, type_map, _cache, used_cache), do: {type_map, used_cache}
+
+  defp collect_types(ros2_message_types, from, type_map, cache, used_cache) do
+    parsed =
+      ros2_message_types
+      |> Task.async_stream(&parse_type(&1, from, cache), timeout: :infinity)
+      |> Enum.map(fn {:ok, result} -> result end)
+
+    type_map =
+      Enum.reduce(parsed, type_map, fn {type, _key, fields}, acc ->
+        Map.put(acc, {:msg_type, type}, fields)
+      end)
+
+    used_cache =
+      Enum.reduce(parsed, used_cache, fn {_type, key, fields}, acc ->
+        Map.put(acc, key, fields)
+      end)
+
+    parsed
+    |> Enum.flat_map(fn {_type, _key, fields} -> Enum.flat_map(fields, &dependency/1) end)
+    |> Enum.uniq()
+    |> Enum.reject(&Map.has_key?(type_map, {:msg_type, &1}))
+    |> collect_types(from, type_map, cache, used_cache)
+  end
+
+  defp parse_type(ros2_message_type, from, cache) do
+    definition = get_msg_definition(ros2_message_type, from)
+    key = {ros2_message_type, :erlang.md5(definition)}
+
+    case cache do
+      %{^key => fields} -> {ros2_message_type, key, fields}
+      _ -> {ros2_message_type, key, parse_fields(definition, ros2_message_type)}
+    end
+  end
+
+  defp parse_fields(definition, ros2_message_type) do
+    {:ok, fields, _rest, _context, _line, _column} = MessageParser.parse(definition)
+    to_complete_fields(fields, ros2_message_type)
+  end
+
+  defp dependency([{:msg_type, type} | _]), do: [type]
+  defp dependency([{:msg_type_array, type} | _]), do: [get_array_type(type)]
+  defp dependency(_field), do: []
+
+  defp cache_path() do
+    Path.join(Mix.Project.build_path(), "rclex.gen.msgs.cache")
+  end
+
+  # the parsed fields depend on the parser and on this task, a cache written by another version
+  # of either is discarded
+  defp cache_version() do
+    {MessageParser.module_info(:md5), __MODULE__.module_info(:md5)}
+  end
+
+  defp read_cache() do
+    version = cache_version()
+
+    with {:ok, binary} <- File.read(cache_path()),
+         {^version, %{} = cache} <- :erlang.binary_to_term(binary) do
+      cache
+    else
+      _ -> %{}
+    end
+  rescue
+    ArgumentError -> %{}
+  end
+
+  defp write_cache(cache) do
+    File.mkdir_p!(Path.dirname(cache_path()))
+    File.write!(cache_path(), :erlang.term_to_binary({cache_version(), cache}))
+  end
+
   defp rclex_dir_path!() do
     if Mix.Project.config()[:app] == :rclex do
       File.cwd!()
@@ -364,7 +551,9 @@ defmodule Mix.Tasks.Rclex.Gen.Msgs do
     end
   end
 
-  defp recompile!() do
+  defp recompile!([]), do: :ok
+
+  defp recompile!(_changed_file_pathes) do
     if Mix.Project.config()[:app] == :rclex do
       Mix.Task.rerun("compile.elixir_make")
     else
@@ -8,6 +8,7 @@ defmodule Rclex do
   @topic_name_doc "`topic_name` must lead with \"/\". See all [constraints](https://design.ros2.org/articles/topic_and_service_names.html#ros-2-topic-and-service-name-constraints)"
   @service_name_doc "`service_name` must lead with \"/\". See all [constraints](https://design.ros2.org/articles/topic_and_service_names.html#ros-2-topic-and-service-name-constraints)"
   @no_demangle_doc "`:no_demangle` if `true`, return all topics without any demangling. if not specified, the default is `false`"
+  @event_callback_doc "`:event_callback` - a function of arity 2, called with the event type and its status map, like `%{total_count: 3, total_count_change: 1}`, for each `:events` notification. The statuses are also emitted as `[:rclex, :publisher | :subscription, :event]` telemetry events, with the counts as measurements and the type, names and `:last_policy_kind` as metadata, when `:telemetry` is available"
   @no_mangle_doc "`:no_mangle` if `true`, `topic_name` needs to be a valid middleware topic name, otherwise it should be a valid ROS topic name. if not specified, the default is `false`"
 
   @typedoc "#{@topic_name_doc}."
@@ -16,6 +17,9 @@ defmodule Rclex do
   @typedoc "#{@service_name_doc}."
   @type service_name :: String.t()
 
+  @typedoc "`:ros` time follows the system time unless it is overridden, `:steady` is monotonic."
+  @type clock_type :: :ros | :system | :steady
+
   @doc """
   Start a ROS node. The name of the node must not be `nil` and cannot coincide with another node of the same name.
   Node names must follow these rules:
@@ -26,6 +30,12 @@ defmodule Rclex do
   ### opts
 
   - #{@namespace_doc}
+  - `:use_sim_time` - if `true`, the node subscribes to `/clock` and the ROS time, see `now/1`,
+    follows it instead of the system time, as with the `use_sim_time` parameter of ROS 2.
+    The ROS time is shared by all nodes, it is simulated while any node uses sim time and is 0
+    until the first clock message. Timers started with `clock: :ros` follow it, so that
+    recorded scenarios played back with `ros2 bag play --clock --rate` run faster than real
+    time. Defaults to `false`.
 
   ### Examples
 
@@ -33,15 +43,22 @@ defmodule Rclex do
       :ok
       iex> Rclex.start_node("node", namespace: "/example")
       {:error, :already_started}
+      iex> Rclex.start_node("sim", namespace: "/example", use_sim_time: true)
+      :ok
   """
   @doc section: :node
-  @spec start_node(name :: String.t(), opts :: [namespace: String.t()]) ::
+  @spec start_node(
+          name :: String.t(),
+          opts :: [namespace: String.t(), use_sim_time: boolean()]
+        ) ::
           :ok | {:error, :already_started} | {:error, term()}
   def start_node(name, opts \\ []) when is_binary(name) and is_list(opts) do
     context = Rclex.Context.get()
     namespace = Keyword.get(opts, :namespace, "/")
+    use_sim_time = Keyword.get(opts, :use_sim_time, false)
 
     case Rclex.NodesSupervisor.start_child(context, name, namespace) do
+      {:ok, _pid} when use_sim_time -> Rclex.Node.use_sim_time(name, namespace)
       {:ok, _pid} -> :ok
       {:error, {:already_started, _pid}} -> {:error, :already_started}
       {:error, reason} -> {:error, reason}
@@ -75,6 +92,18 @@ defmodule Rclex do
 
   - #{@topic_name_doc}
 
+  ### opts
+
+  - #{@namespace_doc}
+  - #{@qos_doc}
+  - `:stamp` - a clock type, `:ros`, `:system` or `:steady`, to write the `header.stamp` of every
+    published message natively with the current time of that clock, right before the message
+    is handed to the middleware. The message type must have a `std_msgs/msg/Header` `header`.
+    If not specified, the default is `false`, the message is published as given.
+  - `:events` - QoS event types to be notified of, `:offered_deadline_missed`,
+    `:liveliness_lost` and `:offered_incompatible_qos`. Defaults to `[]`.
+  - #{@event_callback_doc}
+
   ### Examples
 
       iex> alias Rclex.Pkgs.StdMsgs
@@ -88,7 +117,13 @@ defmodule Rclex do
           message_type :: module(),
           topic_name :: topic_name(),
           node_name :: String.t(),
-          opts :: [namespace: String.t(), qos: Rclex.QoS.t()]
+          opts :: [
+            namespace: String.t(),
+            qos: Rclex.QoS.t(),
+            stamp: clock_type() | false,
+            events: [atom()],
+            event_callback: (atom(), map() -> any())
+          ]
         ) ::
           :ok | {:error, :already_started} | {:error, term()}
   def start_publisher(message_type, topic_name, node_name, opts \\ [])
@@ -96,8 +131,14 @@ defmodule Rclex do
              is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
     qos = Keyword.get(opts, :qos, Rclex.QoS.profile_default())
+    stamp = Keyword.get(opts, :stamp, false)
+    events = Keyword.get(opts, :events, [])
+    event_callback = Keyword.get(opts, :event_callback)
+    true = Enum.all?(events, &(&1 in Rclex.Events.publisher_events()))
 
-    case Rclex.Node.start_publisher(message_type, topic_name, node_name, namespace, qos) do
+    opts = [qos: qos, stamp: stamp, events: events, event_callback: event_callback]
+
+    case Rclex.Node.start_publisher(message_type, topic_name, node_name, namespace, opts) do
       {:ok, _pid} -> :ok
       {:error, {:already_started, _pid}} -> {:error, :already_started}
       {:error, reason} -> {:error, reason}
@@ -174,12 +215,25 @@ defmodule Rclex do
   The message type module can to be generated from .msg files by calling `mix rclex.gen.msgs`,
   after adding the type to `config :rclex, ros2_message_types`.
 
+  The message type can also be given as a type string like `"std_msgs/msg/String"`, for types
+  discovered at runtime. Its type support is then loaded from the installed ROS 2 package and
+  the callback is given the message as a map with atom keys, and strings as binaries.
+  The decoding plan of the type is built on the first message and cached.
+
   - #{@topic_name_doc}
 
   ### opts
 
   - #{@namespace_doc}
   - #{@qos_doc}
+  - `:lazy` - if `true`, the callback is given the undecoded message handle instead of the
+    message struct, so that only the needed fields are decoded with
+    `message_type.get_field!(message, path)` (or the whole message with `get!/1`).
+    The handle is destroyed when the callback returns. Defaults to `false`.
+  - `:events` - QoS event types to be notified of, `:requested_deadline_missed`,
+    `:liveliness_changed`, `:requested_incompatible_qos` and `:message_lost`, which is not
+    available on foxy. Defaults to `[]`.
+  - #{@event_callback_doc}
 
   ### Examples
 
@@ -188,21 +242,35 @@ defmodule Rclex do
       :ok
       iex> Rclex.start_subscription(&IO.inspect/1, StdMsgs.Msg.String, "/chatter", "node", namespace: "/example")
       {:error, :already_started}
+      iex> Rclex.start_subscription(&IO.inspect/1, "std_msgs/msg/String", "/chatter", "node", namespace: "/example")
+      :ok
   """
   @doc section: :subscription
   @spec start_subscription(
           callback :: function(),
-          message_type :: module(),
+          message_type :: module() | String.t(),
           topic_name :: topic_name(),
           node_name :: String.t(),
-          opts :: [namespace: String.t(), qos: Rclex.QoS.t()]
+          opts :: [
+            namespace: String.t(),
+            qos: Rclex.QoS.t(),
+            lazy: boolean(),
+            events: [atom()],
+            event_callback: (atom(), map() -> any())
+          ]
         ) ::
           :ok | {:error, :already_started} | {:error, term()}
   def start_subscription(callback, message_type, topic_name, node_name, opts \\ [])
-      when is_function(callback) and is_atom(message_type) and is_binary(topic_name) and
-             is_binary(node_name) and is_list(opts) do
+      when is_function(callback) and (is_atom(message_type) or is_binary(message_type)) and
+             is_binary(topic_name) and is_binary(node_name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
     qos = Keyword.get(opts, :qos, Rclex.QoS.profile_default())
+    lazy = Keyword.get(opts, :lazy, false)
+    events = Keyword.get(opts, :events, [])
+    event_callback = Keyword.get(opts, :event_callback)
+    true = Enum.all?(events, &(&1 in Rclex.Events.subscription_events()))
+
+    opts = [qos: qos, lazy: lazy, events: events, event_callback: event_callback]
 
     case Rclex.Node.start_subscription(
            callback,
@@ -210,7 +278,7 @@ defmodule Rclex do
            topic_name,
            node_name,
            namespace,
-           qos
+           opts
          ) do
       {:ok, _pid} -> :ok
       {:error, {:already_started, _pid}} -> {:error, :already_started}
@@ -237,15 +305,15 @@ defmodule Rclex do
   """
   @doc section: :subscription
   @spec stop_subscription(
-          message_type :: module(),
+          message_type :: module() | String.t(),
           topic_name :: topic_name(),
           node_name :: String.t(),
           opts :: [namespace: String.t()]
         ) ::
           :ok | {:error, :not_found}
   def stop_subscription(message_type, topic_name, node_name, opts \\ [])
-      when is_atom(message_type) and is_binary(topic_name) and is_binary(node_name) and
-             is_list(opts) do
+      when (is_atom(message_type) or is_binary(message_type)) and is_binary(topic_name) and
+             is_binary(node_name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
     Rclex.Node.stop_subscription(message_type, topic_name, node_name, namespace)
   end
@@ -465,9 +533,20 @@ defmodule Rclex do
   @doc """
   Start a timer. A timer required a period in milliseconds, a callback function, a name and a node. The callback gets called, when the defined period passed.
 
+  The timer keeps the phase of its schedule, a late call doesn't shift the following ones and
+  periods that passed entirely while it was late are counted as missed, see `timer_stats/3`.
+
   ### opts
 
   - #{@namespace_doc}
+  - `:overrun` - what to do when the timer is due while its callback is still running.
+    `:concurrent` calls it again concurrently, `:skip_if_busy` skips the call and counts it as
+    skipped. Defaults to `:concurrent`.
+  - `:clock` - the clock type the period is measured with, `:steady` or `:ros`. A `:ros` timer
+    follows the simulated time of nodes started with `use_sim_time: true`.
+    Defaults to `:steady`.
+  - `:one_shot` - if `true`, the timer is canceled after its first call, `reset_timer/3` arms it
+    again. Defaults to `false`.
 
   ### Examples
 
@@ -478,19 +557,28 @@ defmodule Rclex do
   """
   @doc section: :time
   @spec start_timer(
-          period_ms :: non_neg_integer(),
+          period_ms :: pos_integer(),
           callback :: function(),
           timer_name :: String.t(),
           node_name :: String.t(),
-          opts :: [namespace: String.t()]
+          opts :: [
+            namespace: String.t(),
+            overrun: :concurrent | :skip_if_busy,
+            clock: :steady | :ros,
+            one_shot: boolean()
+          ]
         ) ::
           :ok | {:error, :already_started} | {:error, term()}
   def start_timer(period_ms, callback, timer_name, node_name, opts \\ [])
-      when is_integer(period_ms) and is_function(callback) and is_binary(timer_name) and
-             is_binary(node_name) and is_list(opts) do
+      when is_integer(period_ms) and period_ms > 0 and is_function(callback) and
+             is_binary(timer_name) and is_binary(node_name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
+    overrun = Keyword.get(opts, :overrun, :concurrent)
+    clock = Keyword.get(opts, :clock, :steady)
+    one_shot = Keyword.get(opts, :one_shot, false)
+    opts = [overrun: overrun, clock: clock, one_shot: one_shot]
 
-    case Rclex.Node.start_timer(period_ms, callback, timer_name, node_name, namespace) do
+    case Rclex.Node.start_timer(period_ms, callback, timer_name, node_name, namespace, opts) do
       {:ok, _pid} -> :ok
       {:error, {:already_started, _pid}} -> {:error, :already_started}
       {:error, reason} -> {:error, reason}
@@ -524,6 +612,137 @@ defmodule Rclex do
     Rclex.Node.stop_timer(timer_name, node_name, namespace)
   end
 
+  @doc """
+  Reset a timer, its next call is a period from now. A canceled timer is started again.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.reset_timer("tick", "node", namespace: "/example")
+      :ok
+  """
+  @doc section: :time
+  @spec reset_timer(
+          timer_name :: String.t(),
+          node_name :: String.t(),
+          opts :: [namespace: String.t()]
+        ) ::
+          :ok | {:error, :not_found}
+  def reset_timer(timer_name, node_name, opts \\ [])
+      when is_binary(timer_name) and is_binary(node_name) and is_list(opts) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Timer.reset(timer_name, node_name, namespace)
+  end
+
+  @doc """
+  Change the period of a timer without restarting it. The next call is kept as scheduled and the
+  following ones are the new period apart, so the timer keeps its phase.
+  Call `reset_timer/3` as well for the next call to be a new period from now.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.change_timer_period(500, "tick", "node", namespace: "/example")
+      :ok
+  """
+  @doc section: :time
+  @spec change_timer_period(
+          period_ms :: pos_integer(),
+          timer_name :: String.t(),
+          node_name :: String.t(),
+          opts :: [namespace: String.t()]
+        ) ::
+          :ok | {:error, :not_found}
+  def change_timer_period(period_ms, timer_name, node_name, opts \\ [])
+      when is_integer(period_ms) and period_ms > 0 and is_binary(timer_name) and
+             is_binary(node_name) and is_list(opts) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Timer.change_period(period_ms, timer_name, node_name, namespace)
+  end
+
+  @doc """
+  Cancel a timer, its callback is not called until it is reset with `reset_timer/3`.
+  Unlike `stop_timer/3` the timer is kept.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.cancel_timer("tick", "node", namespace: "/example")
+      :ok
+  """
+  @doc section: :time
+  @spec cancel_timer(
+          timer_name :: String.t(),
+          node_name :: String.t(),
+          opts :: [namespace: String.t()]
+        ) ::
+          :ok | {:error, :not_found}
+  def cancel_timer(timer_name, node_name, opts \\ [])
+      when is_binary(timer_name) and is_binary(node_name) and is_list(opts) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Timer.cancel(timer_name, node_name, namespace)
+  end
+
+  @doc """
+  Return the statistics of a timer since it was started, times are in nanoseconds.
+
+  - `:ticks` - the number of times the timer was due
+  - `:missed` - the number of whole periods that passed while a call was late
+  - `:skipped` - the number of calls skipped because of `overrun: :skip_if_busy`
+  - `:period_histogram` - the actual periods between calls, as a map of bucket upper bounds in
+    microseconds, powers of two, to counts
+  - `:jitter` - the `:max` and `:mean` of how late the calls were behind the schedule
+  - `:callback` - the `:count`, `:max` and `:mean` duration of the finished callbacks
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> %{ticks: _, missed: 0, jitter: %{max: _}} = Rclex.timer_stats("tick", "node", namespace: "/example")
+      iex> Rclex.timer_stats("tock", "node", namespace: "/example")
+      {:error, :not_found}
+  """
+  @doc section: :time
+  @spec timer_stats(
+          timer_name :: String.t(),
+          node_name :: String.t(),
+          opts :: [namespace: String.t()]
+        ) ::
+          map() | {:error, :not_found}
+  def timer_stats(timer_name, node_name, opts \\ [])
+      when is_binary(timer_name) and is_binary(node_name) and is_list(opts) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Timer.stats(timer_name, node_name, namespace)
+  end
+
+  @doc """
+  Return the current time of a clock in nanoseconds, as `rcl_clock_get_now` gives it.
+
+  The clock of each type is created on first use and shared, so the ROS time is the one used
+  to stamp headers with the `:stamp` option of `start_publisher/4`.
+
+  ### Examples
+
+      iex> Rclex.now(:system) > 0
+      true
+  """
+  @doc section: :time
+  @spec now(clock_type :: clock_type()) :: integer()
+  def now(clock_type \\ :ros) when clock_type in [:ros, :system, :steady] do
+    Rclex.Clock.now!(clock_type)
+  end
+
   @doc """
   Return the number of publishers on a given topic.
 
@@ -546,7 +765,7 @@ defmodule Rclex do
           name :: String.t(),
           topic_name :: topic_name(),
           opts :: [namespace: String.t()]
-        ) :: non_neg_integer()
+        ) :: non_neg_integer() | {:error, :not_found}
   def count_publishers(name, topic_name, opts \\ [])
       when is_binary(name) and is_binary(topic_name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
@@ -575,7 +794,7 @@ defmodule Rclex do
           name :: String.t(),
           topic_name :: topic_name(),
           opts :: [namespace: String.t()]
-        ) :: non_neg_integer()
+        ) :: non_neg_integer() | {:error, :not_found}
   def count_subscribers(name, topic_name, opts \\ [])
       when is_binary(name) and is_binary(topic_name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
@@ -600,7 +819,7 @@ defmodule Rclex do
           node_name :: String.t(),
           node_namespace :: String.t(),
           opts :: [namespace: String.t()]
-        ) :: list()
+        ) :: list() | {:error, :not_found}
   def get_client_names_and_types_by_node(
         name,
         node_name,
@@ -613,6 +832,31 @@ defmodule Rclex do
     Rclex.Node.get_client_names_and_types_by_node(name, namespace, node_name, node_namespace)
   end
 
+  @doc """
+  Return the whole ROS graph at once, in one native call instead of a query per node and topic.
+
+  - `:nodes` - the nodes as `{name, namespace, enclave}`
+  - `:topics`, `:services` - the names with their types
+  - `:endpoints` - the publishers and subscriptions of all topics, as returned by
+    `get_publishers_info_by_topic/3` and `get_subscribers_info_by_topic/3`, and `:topic_name`
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> %{nodes: [{"node", "/example", "/"}], endpoints: [%{topic_name: "/chatter"} | _]} =
+      ...>   Rclex.get_graph_snapshot("node", namespace: "/example")
+  """
+  @doc section: :graph
+  @spec get_graph_snapshot(name :: String.t(), opts :: [namespace: String.t()]) ::
+          map() | {:error, :not_found}
+  def get_graph_snapshot(name, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Node.get_graph_snapshot(name, namespace)
+  end
+
   @doc """
   Return a list of available nodes in the ROS graph.
 
@@ -626,9 +870,8 @@ defmodule Rclex do
       [{"node","/example"}]
   """
   @doc section: :graph
-  @spec get_node_names(name :: String.t(), opts :: [namespace: String.t()]) :: [
-          {String.t(), String.t()}
-        ]
+  @spec get_node_names(name :: String.t(), opts :: [namespace: String.t()]) ::
+          [{String.t(), String.t()}] | {:error, :not_found}
   def get_node_names(name, opts \\ [])
       when is_binary(name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
@@ -648,9 +891,8 @@ defmodule Rclex do
       [{"node", "/example", "/"}]
   """
   @doc section: :graph
-  @spec get_node_names_with_enclaves(name :: String.t(), opts :: [namespace: String.t()]) :: [
-          {String.t(), String.t(), String.t()}
-        ]
+  @spec get_node_names_with_enclaves(name :: String.t(), opts :: [namespace: String.t()]) ::
+          [{String.t(), String.t(), String.t()}] | {:error, :not_found}
   def get_node_names_with_enclaves(name, opts \\ [])
       when is_binary(name) and is_list(opts) do
     namespace = Keyword.get(opts, :namespace, "/")
@@ -717,7 +959,7 @@ defmodule Rclex do
           name :: String.t(),
           topic_name :: topic_name(),
           opts :: [namespace: String.t(), no_mangle: boolean()]
-        ) :: list()
+        ) :: list() | {:error, :not_found}
   def get_publishers_info_by_topic(name, topic_name, opts \\ []) do
     namespace = Keyword.get(opts, :namespace, "/")
     no_mangle = Keyword.get(opts, :no_mangle, false)
@@ -746,7 +988,7 @@ defmodule Rclex do
   @spec get_service_names_and_types(
           name :: String.t(),
           opts :: [namespace: String.t()]
-        ) :: list()
+        ) :: list() | {:error, :not_found}
   def get_service_names_and_types(name, opts \\ []) do
     namespace = Keyword.get(opts, :namespace, "/")
     Rclex.Node.get_service_names_and_types(name, namespace)
@@ -770,7 +1012,7 @@ defmodule Rclex do
           node_name :: String.t(),
           node_namespace :: String.t(),
           opts :: [namespace: String.t()]
-        ) :: list()
+        ) :: list() | {:error, :not_found}
   def get_service_names_and_types_by_node(name, node_name, node_namespace, opts \\ []) do
     namespace = Keyword.get(opts, :namespace, "/")
     Rclex.Node.get_service_names_and_types_by_node(name, namespace, node_name, node_namespace)
@@ -836,7 +1078,7 @@ defmodule Rclex do
           name :: String.t(),
           topic_name :: topic_name(),
           opts :: [namespace: String.t(), no_mangle: boolean()]
-        ) :: list()
+        ) :: list() | {:error, :not_found}
   def get_subscribers_info_by_topic(name, topic_name, opts \\ []) do
     namespace = Keyword.get(opts, :namespace, "/")
     no_mangle = Keyword.get(opts, :no_mangle, false)
@@ -866,13 +1108,152 @@ defmodule Rclex do
   @spec get_topic_names_and_types(
           name :: String.t(),
           opts :: [namespace: String.t(), no_demangle: boolean()]
-        ) :: [{String.t(), [String.t()]}]
+        ) :: [{String.t(), [String.t()]}] | {:error, :not_found}
   def get_topic_names_and_types(name, opts \\ []) do
     namespace = Keyword.get(opts, :namespace, "/")
     no_demangle = Keyword.get(opts, :no_demangle, false)
     Rclex.Node.get_topic_names_and_types(name, namespace, no_demangle)
   end
 
+  @doc """
+  Return the generation of the graph seen by the node.
+
+  The results of the graph queries of a node are cached and served without querying the
+  middleware until the graph changes, that is until the graph guard condition of the node is
+  triggered, which increases the generation.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.graph_generation("node", namespace: "/example")
+      2
+  """
+  @doc section: :graph
+  @spec graph_generation(name :: String.t(), opts :: [namespace: String.t()]) ::
+          non_neg_integer() | {:error, :not_found}
+  def graph_generation(name, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Node.graph_generation(name, namespace)
+  end
+
+  @doc """
+  Subscribe the calling process to the changes of the graph seen by the node.
+
+  Each time the graph guard condition of the node is triggered, the node compares the graph
+  with the one it saw before and sends the calling process a `{:graph_event, event}` message
+  per change, with `event` one of
+
+  - `{:node_added, name, namespace}`, `{:node_removed, name, namespace}`
+  - `{:topic_added, name, types}`, `{:topic_removed, name, types}`
+  - `{:endpoint_added, info}`, `{:endpoint_removed, info}` - with `info` as returned by
+    `get_publishers_info_by_topic/3` and `get_subscribers_info_by_topic/3`, and `:topic_name`
+
+  The current graph is sent first as added events. The subscription ends with
+  `unsubscribe_graph_events/2` or when the calling process exits.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.subscribe_graph_events("node", namespace: "/example")
+      :ok
+      iex> flush()
+      {:graph_event, {:node_added, "node", "/example"}}
+      {:graph_event, {:topic_added, "/rosout", ["rcl_interfaces/msg/Log"]}}
+  """
+  @doc section: :graph
+  @spec subscribe_graph_events(name :: String.t(), opts :: [namespace: String.t()]) ::
+          :ok | {:error, :already_subscribed}
+  def subscribe_graph_events(name, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Node.subscribe_graph_events(name, namespace)
+  end
+
+  @doc """
+  Unsubscribe the calling process from the changes of the graph seen by the node.
+
+  ### opts
+
+  - #{@namespace_doc}
+
+  ### Examples
+
+      iex> Rclex.unsubscribe_graph_events("node", namespace: "/example")
+      :ok
+  """
+  @doc section: :graph
+  @spec unsubscribe_graph_events(name :: String.t(), opts :: [namespace: String.t()]) ::
+          :ok | {:error, :not_found}
+  def unsubscribe_graph_events(name, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    Rclex.Node.unsubscribe_graph_events(name, namespace)
+  end
+
+  @wait_for_doc """
+  The function returns at once with a reference, the calling process is then sent
+  `{:graph_wait, ref, :ok}` when the count is reached, checked each time the graph guard
+  condition of the node is triggered, or `{:graph_wait, ref, {:error, :timeout}}` when the
+  timeout expires first.
+
+  ### opts
+
+  - #{@namespace_doc}
+  - `:timeout` - the timeout in milliseconds or `:infinity`, default `:infinity`
+  """
+
+  @doc """
+  Wait without blocking until the topic has at least `count` publishers.
+
+  #{@wait_for_doc}
+
+  ### Examples
+
+      iex> {:ok, ref} = Rclex.wait_for_publishers("node", "/chatter", 1, timeout: 1000)
+      iex> receive do {:graph_wait, ^ref, result} -> result end
+      :ok
+  """
+  @doc section: :graph
+  @spec wait_for_publishers(
+          name :: String.t(),
+          topic_name :: topic_name(),
+          count :: non_neg_integer(),
+          opts :: [namespace: String.t(), timeout: timeout()]
+        ) :: {:ok, reference()}
+  def wait_for_publishers(name, topic_name, count, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    timeout = Keyword.get(opts, :timeout, :infinity)
+    Rclex.Node.wait_for(:publishers, topic_name, count, timeout, name, namespace)
+  end
+
+  @doc """
+  Wait without blocking until the topic has at least `count` subscribers.
+
+  #{@wait_for_doc}
+
+  ### Examples
+
+      iex> {:ok, ref} = Rclex.wait_for_subscribers("node", "/chatter", 1, timeout: 1000)
+      iex> receive do {:graph_wait, ^ref, result} -> result end
+      :ok
+  """
+  @doc section: :graph
+  @spec wait_for_subscribers(
+          name :: String.t(),
+          topic_name :: topic_name(),
+          count :: non_neg_integer(),
+          opts :: [namespace: String.t(), timeout: timeout()]
+        ) :: {:ok, reference()}
+  def wait_for_subscribers(name, topic_name, count, opts \\ []) do
+    namespace = Keyword.get(opts, :namespace, "/")
+    timeout = Keyword.get(opts, :timeout, :infinity)
+    Rclex.Node.wait_for(:subscribers, topic_name, count, timeout, name, namespace)
+  end
+
   @doc """
   Check if a service server is available for the given service client.
   This function will return true, if there is a service server available for the given client.
@@ -899,4 +1280,67 @@ defmodule Rclex do
     namespace = Keyword.get(opts, :namespace, "/")
     Rclex.Client.service_server_available?(service_type, service_name, name, namespace)
   end
+
+  @doc """
+  Return the statistics of the pool allocator which backs the short-lived buffers of the
+  `serialize!/1` of the message modules. Message bodies, strings and sequences are not allocated from it.
+
+  - `:allocations`, `:deallocations` - the numbers of blocks allocated and freed
+  - `:reuses` - the number of allocations served by a freed block instead of `enif_alloc`
+  - `:bytes_in_use` - the bytes of the allocated blocks, rounded up to their size class
+  - `:cached_bytes` - the bytes of the freed blocks kept for reuse
+  - `:size_classes` - the `:size`, `:allocations`, `:reuses` and `:cached` blocks of each size
+    class, larger blocks are not pooled
+
+  ### Examples
+
+      iex> %{reuses: _, bytes_in_use: _, size_classes: [%{size: 16} | _]} = Rclex.allocator_stats()
+  """
+  @doc section: :memory
+  @spec allocator_stats() :: map()
+  def allocator_stats() do
+    Rclex.Nif.pool_allocator_stats!()
+  end
+
+  @doc """
+  Return the native memory held by rclex, by what it is used for.
+
+  - `:messages` - the message structs created by rclex, not their strings and sequences which
+    the typesupport allocates itself
+  - `:graph` - the results of graph queries, until they are converted
+  - `:entities` - contexts, nodes, publishers, subscriptions, services, clients, timers, wait sets
+    and guard conditions, as allocated by rcl
+  - `:middleware` - the serialization buffers
+
+  Each is a map of `:live_bytes` and `:live_allocations`, what is held now, and `:total_bytes`
+  and `:total_allocations`, what was allocated since rclex was loaded.
+
+  ### Examples
+
+      iex> %{messages: %{live_bytes: _, total_allocations: _}, entities: _} = Rclex.memory_stats()
+  """
+  @doc section: :memory
+  @spec memory_stats() :: %{atom() => %{atom() => non_neg_integer()}}
+  def memory_stats() do
+    Rclex.Nif.memory_stats!()
+  end
+
+  @doc """
+  Emit `memory_stats/0` as `[:rclex, :memory]` telemetry events, one per subsystem with its
+  counts as measurements and `:subsystem` as metadata, when `:telemetry` is available.
+
+  It is meant to be polled, e.g. as a `:telemetry_poller` measurement
+  `{Rclex, :emit_memory_stats, []}`.
+  """
+  @doc section: :memory
+  @spec emit_memory_stats() :: :ok
+  def emit_memory_stats() do
+    if Code.ensure_loaded?(:telemetry) do
+      for {subsystem, measurements} <- memory_stats() do
+        apply(:telemetry, :execute, [[:rclex, :memory], measurements, %{subsystem: subsystem}])
+      end
+    end
+
+    :ok
+  end
 end
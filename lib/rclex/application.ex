@@ -4,12 +4,18 @@ defmodule Rclex.Application do
   use Application
 
   def start(_type, _args) do
+    :ok = Rclex.Clock.init!()
+
     children = [
+      {Rclex.Registry, []},
       {Rclex.Context, []},
+      {Rclex.TimerService, []},
       {Rclex.NodesSupervisor, []},
       {PartitionSupervisor, child_spec: Task.Supervisor, name: Rclex.TaskSupervisors}
     ]
 
-    Supervisor.start_link(children, strategy: :one_for_one)
+    # The timers are registered with the timer service of the context, so a restart of either
+    # restarts the nodes, and with them their timers, after it.
+    Supervisor.start_link(children, strategy: :rest_for_one)
   end
 end
@@ -0,0 +1,170 @@
+defmodule Rclex.CDR do
+  @moduledoc false
+
+  # Runtime for the CDR (de)serializers generated by `mix rclex.gen.msgs`.
+  #
+  # Produces and consumes little-endian plain CDR with its 4 bytes encapsulation header.
+  # Primitives are aligned to their size relative to the start of the payload, strings are a
+  # uint32 length including the terminating NUL followed by the bytes, and sequences are a
+  # uint32 element count followed by the elements. wstrings are a uint32 count of UTF-16 code
+  # units, without a terminating NUL, followed by the little-endian code units. char is a uint8
+  # like in rosidl.
+
+  @encapsulation_cdr_le <<0, 1, 0, 0>>
+
+  def encode(struct, put) do
+    @encapsulation_cdr_le <> put.(<<>>, struct)
+  end
+
+  def decode(<<0, 1, _options::binary-size(2), payload::binary>>, take) do
+    {struct, _cursor} = take.({payload, 0})
+    struct
+  end
+
+  def decode(_binary, _take) do
+    raise ArgumentError, "only little-endian plain CDR payloads are supported"
+  end
+
+  def put(acc, :bool, true), do: <<acc::binary, 1>>
+  def put(acc, :bool, false), do: <<acc::binary, 0>>
+  def put(acc, :byte, value), do: <<acc::binary, value::8>>
+  def put(acc, :char, value), do: <<acc::binary, value::8>>
+  def put(acc, :int8, value), do: <<acc::binary, value::signed-8>>
+  def put(acc, :uint8, value), do: <<acc::binary, value::8>>
+  def put(acc, :int16, value), do: <<align(acc, 2)::binary, value::signed-little-16>>
+  def put(acc, :uint16, value), do: <<align(acc, 2)::binary, value::little-16>>
+  def put(acc, :int32, value), do: <<align(acc, 4)::binary, value::signed-little-32>>
+  def put(acc, :uint32, value), do: <<align(acc, 4)::binary, value::little-32>>
+  def put(acc, :int64, value), do: <<align(acc, 8)::binary, value::signed-little-64>>
+  def put(acc, :uint64, value), do: <<align(acc, 8)::binary, value::little-64>>
+  def put(acc, :float32, value), do: <<align(acc, 4)::binary, value::float-little-32>>
+  def put(acc, :float64, value), do: <<align(acc, 8)::binary, value::float-little-64>>
+
+  def put(acc, :string, value) do
+    <<align(acc, 4)::binary, byte_size(value) + 1::little-32, value::binary, 0>>
+  end
+
+  def put(acc, :wstring, value) do
+    units = :unicode.characters_to_binary(value, :utf8, {:utf16, :little})
+    <<put(acc, :uint32, div(byte_size(units), 2))::binary, units::binary>>
+  end
+
+  def put_array(acc, put, values) when is_function(put, 2) do
+    Enum.reduce(values, acc, &put.(&2, &1))
+  end
+
+  def put_array(acc, type, values) do
+    Enum.reduce(values, acc, &put(&2, type, &1))
+  end
+
+  def put_sequence(acc, put_or_type, values) do
+    acc |> put(:uint32, length(values)) |> put_array(put_or_type, values)
+  end
+
+  def put_bytes(acc, bytes) do
+    <<put(acc, :uint32, byte_size(bytes))::binary, bytes::binary>>
+  end
+
+  def take({<<value, rest::binary>>, offset}, :bool), do: {value != 0, {rest, offset + 1}}
+  def take({<<value::8, rest::binary>>, offset}, :byte), do: {value, {rest, offset + 1}}
+  def take({<<value::8, rest::binary>>, offset}, :char), do: {value, {rest, offset + 1}}
+  def take({<<value::signed-8, rest::binary>>, offset}, :int8), do: {value, {rest, offset + 1}}
+  def take({<<value::8, rest::binary>>, offset}, :uint8), do: {value, {rest, offset + 1}}
+
+  def take(cursor, :int16) do
+    {<<value::signed-little-16, rest::binary>>, offset} = skip(cursor, 2)
+    {value, {rest, offset + 2}}
+  end
+
+  def take(cursor, :uint16) do
+    {<<value::little-16, rest::binary>>, offset} = skip(cursor, 2)
+    {value, {rest, offset + 2}}
+  end
+
+  def take(cursor, :int32) do
+    {<<value::signed-little-32, rest::binary>>, offset} = skip(cursor, 4)
+    {value, {rest, offset + 4}}
+  end
+
+  def take(cursor, :uint32) do
+    {<<value::little-32, rest::binary>>, offset} = skip(cursor, 4)
+    {value, {rest, offset + 4}}
+  end
+
+  def take(cursor, :int64) do
+    {<<value::signed-little-64, rest::binary>>, offset} = skip(cursor, 8)
+    {value, {rest, offset + 8}}
+  end
+
+  def take(cursor, :uint64) do
+    {<<value::little-64, rest::binary>>, offset} = skip(cursor, 8)
+    {value, {rest, offset + 8}}
+  end
+
+  def take(cursor, :float32) do
+    {<<value::float-little-32, rest::binary>>, offset} = skip(cursor, 4)
+    {value, {rest, offset + 4}}
+  end
+
+  def take(cursor, :float64) do
+    {<<value::float-little-64, rest::binary>>, offset} = skip(cursor, 8)
+    {value, {rest, offset + 8}}
+  end
+
+  def take(cursor, :string) do
+    {length, {rest, offset}} = take(cursor, :uint32)
+    size = max(length - 1, 0)
+    <<value::binary-size(size), _nul::binary-size(length - size), rest::binary>> = rest
+    {value, {rest, offset + length}}
+  end
+
+  def take(cursor, :wstring) do
+    {count, {rest, offset}} = take(cursor, :uint32)
+    <<units::binary-size(count * 2), rest::binary>> = rest
+    value = :unicode.characters_to_binary(units, {:utf16, :little}, :utf8)
+    {value, {rest, offset + count * 2}}
+  end
+
+  def take_array(cursor, take_or_type, count) do
+    {values, cursor} =
+      Enum.reduce(1..count//1, {[], cursor}, fn _, {values, cursor} ->
+        {value, cursor} = take_one(cursor, take_or_type)
+        {[value | values], cursor}
+      end)
+
+    {Enum.reverse(values), cursor}
+  end
+
+  def take_sequence(cursor, take_or_type) do
+    {count, cursor} = take(cursor, :uint32)
+    take_array(cursor, take_or_type, count)
+  end
+
+  def take_bytes(cursor) do
+    {size, {rest, offset}} = take(cursor, :uint32)
+    <<bytes::binary-size(size), rest::binary>> = rest
+    {bytes, {rest, offset + size}}
+  end
+
+  defp take_one(cursor, take) when is_function(take, 1), do: take.(cursor)
+  defp take_one(cursor, type), do: take(cursor, type)
+
+  defp align(acc, size) do
+    case rem(byte_size(acc), size) do
+      0 -> acc
+      rem -> <<acc::binary, 0::size((size - rem) * 8)>>
+    end
+  end
+
+  defp skip({rest, offset} = cursor, size) do
+    case rem(offset, size) do
+      0 ->
+        cursor
+
+      rem ->
+        padding = size - rem
+        <<_::binary-size(padding), rest::binary>> = rest
+        {rest, offset + padding}
+    end
+  end
+end
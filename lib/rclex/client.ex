@@ -17,7 +17,7 @@ defmodule Rclex.Client do
   end
 
   def name(service_type, service_name, name, namespace \\ "/") do
-    {:global, {:client, service_type, service_name, name, namespace}}
+    Rclex.Registry.via({:client, service_type, service_name, name, namespace})
   end
 
   def call_async(%request_type{} = request, service_name, name, namespace \\ "/") do
@@ -75,8 +75,12 @@ defmodule Rclex.Client do
 
   case System.fetch_env!("ROS_DISTRO") do
     "foxy" ->
+      # there is no on new response callback, a waiter thread waits for responses instead and
+      # sends the same {:new_response, 1}, it is armed again once they are taken
       def terminate(reason, state) do
-        Nif.rcl_wait_set_fini!(state.callback_resource)
+        {waiter, guard_condition} = state.callback_resource
+        Nif.waiter_stop!(waiter)
+        Nif.rcl_guard_condition_fini!(guard_condition)
         Nif.rcl_client_fini!(state.client, state.node)
 
         Logger.debug(
@@ -85,89 +89,12 @@ defmodule Rclex.Client do
       end
 
       def handle_continue(nil, %{context: context} = state) do
-        callback_resource = Nif.rcl_wait_set_init_client!(context)
-        {:noreply, %{state | callback_resource: callback_resource}}
-      end
-
-      def handle_call(
-            {:call, request_struct},
-            _from,
-            %{
-              client: client,
-              request_type: request_type,
-              requests: requests
-            } = state
-          ) do
-        request_message = apply(request_type, :create!, [])
-
-        {:ok, sequence_number} =
-          try do
-            :ok = apply(request_type, :set!, [request_message, request_struct])
-            Nif.rcl_send_request!(client, request_message)
-          after
-            :ok = apply(request_type, :destroy!, [request_message])
-          end
-
-        send(self(), :take_response)
-
-        requests = Map.put_new(requests, sequence_number, request_struct)
-        {:reply, :ok, Map.put(state, :requests, requests)}
+        guard_condition = Nif.rcl_guard_condition_init!(context)
+        waiter = Nif.waiter_start!(context, state.client, guard_condition)
+        {:noreply, %{state | callback_resource: {waiter, guard_condition}}}
       end
 
-      def handle_call(
-            {:service_server_available},
-            _from,
-            %{
-              node: node,
-              client: client
-            } = state
-          ) do
-        is_available = Nif.rcl_service_server_is_available!(node, client)
-        {:reply, is_available, state}
-      end
-
-      def handle_info(
-            :take_response,
-            %{
-              client: client,
-              callback: callback,
-              response_type: response_type,
-              callback_resource: callback_resource,
-              requests: requests
-            } = state
-          ) do
-        case Nif.rcl_wait_client!(callback_resource, 1000, client) do
-          :ok ->
-            response_message = apply(response_type, :create!, [])
-
-            try do
-              {:ok, response_sequence_number} =
-                Nif.rcl_take_response_with_info!(client, response_message)
-
-              response_struct = apply(response_type, :get!, [response_message])
-
-              {request_struct, requests} = Map.pop(requests, response_sequence_number)
-
-              if request_struct do
-                {:ok, _pid} =
-                  Task.Supervisor.start_child(
-                    {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                    fn ->
-                      callback.(request_struct, response_struct)
-                    end
-                  )
-              end
-
-              {:noreply, Map.put(state, :requests, requests)}
-            after
-              :ok = apply(response_type, :destroy!, [response_message])
-            end
-
-          :timeout ->
-            send(self(), :take_response)
-            {:noreply, state}
-        end
-      end
+      defp rearm(%{callback_resource: {waiter, _guard_condition}}), do: Nif.waiter_arm!(waiter)
 
     _ ->
       def terminate(
@@ -187,80 +114,84 @@ defmodule Rclex.Client do
         {:noreply, %{state | callback_resource: callback_resource}}
       end
 
-      def handle_call(
-            {:call, request_struct},
-            _from,
-            %{
-              client: client,
-              request_type: request_type,
-              requests: requests
-            } = state
-          ) do
-        request_message = apply(request_type, :create!, [])
-
-        {:ok, sequence_number} =
-          try do
-            :ok = apply(request_type, :set!, [request_message, request_struct])
-            Nif.rcl_send_request!(client, request_message)
-          after
-            :ok = apply(request_type, :destroy!, [request_message])
-          end
+      defp rearm(_state), do: :ok
+  end
 
-        requests = Map.put_new(requests, sequence_number, request_struct)
-        {:reply, :ok, Map.put(state, :requests, requests)}
+  def handle_call(
+        {:call, request_struct},
+        _from,
+        %{
+          client: client,
+          request_type: request_type,
+          requests: requests
+        } = state
+      ) do
+    request_message = apply(request_type, :create!, [])
+
+    {:ok, sequence_number} =
+      try do
+        :ok = apply(request_type, :set!, [request_message, request_struct])
+        Nif.rcl_send_request!(client, request_message)
+      after
+        :ok = apply(request_type, :destroy!, [request_message])
       end
 
-      def handle_call(
-            {:service_server_available},
-            _from,
-            %{
-              node: node,
-              client: client
-            } = state
-          ) do
-        is_available = Nif.rcl_service_server_is_available!(node, client)
-        {:reply, is_available, state}
-      end
+    requests = Map.put_new(requests, sequence_number, request_struct)
+    {:reply, :ok, Map.put(state, :requests, requests)}
+  end
 
-      def handle_info(
-            {:new_response, number_of_events},
-            %{
-              client: client,
-              callback: callback,
-              response_type: response_type,
-              requests: requests
-            } = state
-          )
-          when number_of_events > 0 do
-        requests =
-          Enum.reduce(1..number_of_events, requests, fn _i, requests ->
-            response_message = apply(response_type, :create!, [])
-
-            try do
-              {:ok, response_sequence_number} =
-                Nif.rcl_take_response_with_info!(client, response_message)
-
-              response_struct = apply(response_type, :get!, [response_message])
-
-              {request_struct, requests} = Map.pop(requests, response_sequence_number)
-
-              if request_struct do
-                {:ok, _pid} =
-                  Task.Supervisor.start_child(
-                    {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                    fn ->
-                      callback.(request_struct, response_struct)
-                    end
-                  )
-              end
-
-              requests
-            after
-              :ok = apply(response_type, :destroy!, [response_message])
-            end
-          end)
-
-        {:noreply, Map.put(state, :requests, requests)}
-      end
+  def handle_call(
+        {:service_server_available},
+        _from,
+        %{
+          node: node,
+          client: client
+        } = state
+      ) do
+    is_available = Nif.rcl_service_server_is_available!(node, client)
+    {:reply, is_available, state}
+  end
+
+  def handle_info(
+        {:new_response, number_of_events},
+        %{
+          client: client,
+          callback: callback,
+          response_type: response_type,
+          requests: requests
+        } = state
+      )
+      when number_of_events > 0 do
+    requests =
+      Enum.reduce(1..number_of_events, requests, fn _i, requests ->
+        response_message = apply(response_type, :create!, [])
+
+        try do
+          {:ok, response_sequence_number} =
+            Nif.rcl_take_response_with_info!(client, response_message)
+
+          response_struct = apply(response_type, :get!, [response_message])
+
+          {request_struct, requests} = Map.pop(requests, response_sequence_number)
+
+          if request_struct do
+            {:ok, _pid} =
+              Task.Supervisor.start_child(
+                {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
+                fn ->
+                  callback.(request_struct, response_struct)
+                end
+              )
+          end
+
+          requests
+        after
+          :ok = apply(response_type, :destroy!, [response_message])
+        end
+      end)
+
+    :ok = rearm(state)
+
+    {:noreply, Map.put(state, :requests, requests)}
   end
 end
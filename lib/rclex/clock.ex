@@ -0,0 +1,62 @@
+defmodule Rclex.Clock do
+  @moduledoc false
+
+  alias Rclex.Nif
+
+  # One clock per type is shared by Rclex.now/1, the publishers stamping headers and the timers.
+  # rcl clocks are cheap to read but not to create, so they are created once, when the
+  # application starts, and kept for the lifetime of the VM.
+  #
+  # The ROS time is overridden by the /clock topic while at least one node uses sim time, the
+  # nodes are counted so that it follows the system time again once the last of them stops.
+
+  @clock_types [:ros, :system, :steady]
+
+  # Called by Rclex.Application before any process can use the clocks, so that they are not
+  # created concurrently. A restart of the application keeps those already created.
+  def init!() do
+    for clock_type <- @clock_types, is_nil(:persistent_term.get(key(clock_type), nil)) do
+      :persistent_term.put(key(clock_type), Nif.rcl_clock_init!(clock_type))
+    end
+
+    if is_nil(:persistent_term.get(key(:sim_time_users), nil)) do
+      :persistent_term.put(key(:sim_time_users), :atomics.new(1, signed: true))
+    end
+
+    :ok
+  end
+
+  def now!(clock_type) do
+    Nif.rcl_clock_get_now!(get!(clock_type))
+  end
+
+  def get!(clock_type) when clock_type in @clock_types do
+    :persistent_term.get(key(clock_type))
+  end
+
+  def enable_sim_time!() do
+    if :atomics.add_get(sim_time_users(), 1, 1) == 1 do
+      :ok = Nif.rcl_enable_ros_time_override!(get!(:ros))
+    end
+
+    :ok
+  end
+
+  def disable_sim_time!() do
+    if :atomics.sub_get(sim_time_users(), 1, 1) == 0 do
+      :ok = Nif.rcl_disable_ros_time_override!(get!(:ros))
+    end
+
+    :ok
+  end
+
+  def set_ros_time!(time) do
+    Nif.rcl_set_ros_time_override!(get!(:ros), time)
+  end
+
+  defp sim_time_users() do
+    :persistent_term.get(key(:sim_time_users))
+  end
+
+  defp key(name), do: {__MODULE__, name}
+end
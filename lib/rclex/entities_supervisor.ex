@@ -11,10 +11,10 @@ defmodule Rclex.EntitiesSupervisor do
   end
 
   def name(name, namespace \\ "/") do
-    {:global, {:entities_supervisor, name, namespace}}
+    Rclex.Registry.via({:entities_supervisor, name, namespace})
   end
 
-  def start_publisher(node, message_type, topic_name, name, namespace, qos) do
+  def start_publisher(node, message_type, topic_name, name, namespace, opts) do
     DynamicSupervisor.start_child(
       name(name, namespace),
       {Rclex.Publisher,
@@ -23,9 +23,8 @@ defmodule Rclex.EntitiesSupervisor do
          message_type: message_type,
          topic_name: topic_name,
          name: name,
-         namespace: namespace,
-         qos: qos
-       ]}
+         namespace: namespace
+       ] ++ opts}
     )
   end
 
@@ -37,7 +36,7 @@ defmodule Rclex.EntitiesSupervisor do
         topic_name,
         name,
         namespace,
-        qos
+        opts
       ) do
     DynamicSupervisor.start_child(
       name(name, namespace),
@@ -49,9 +48,8 @@ defmodule Rclex.EntitiesSupervisor do
          message_type: message_type,
          topic_name: topic_name,
          name: name,
-         namespace: namespace,
-         qos: qos
-       ]}
+         namespace: namespace
+       ] ++ opts}
     )
   end
 
@@ -99,7 +97,7 @@ defmodule Rclex.EntitiesSupervisor do
     stop_entity(entity_name, name, namespace)
   end
 
-  def start_timer(context, period_ms, callback, timer_name, name, namespace \\ "/") do
+  def start_timer(context, period_ms, callback, timer_name, name, namespace, opts) do
     DynamicSupervisor.start_child(
       name(name, namespace),
       {Rclex.Timer,
@@ -110,7 +108,7 @@ defmodule Rclex.EntitiesSupervisor do
          timer_name: timer_name,
          name: name,
          namespace: namespace
-       ]}
+       ] ++ opts}
     )
   end
 
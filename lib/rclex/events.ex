@@ -0,0 +1,121 @@
+defmodule Rclex.Events do
+  @moduledoc false
+
+  # QoS events of a publisher or a subscription, kept by its process in a map of event type to
+  # handle. The process is sent {:new_event, type, number_of_events} for each of them and then
+  # takes the status once, its *_change counts cover all events since the last take.
+  # Each status is emitted as the [:rclex, kind, :event] telemetry event, when :telemetry is
+  # available, and given to the event callback, if any, with the type.
+
+  require Logger
+
+  alias Rclex.Nif
+
+  @publisher_events [:offered_deadline_missed, :liveliness_lost, :offered_incompatible_qos]
+  @subscription_events [
+    :requested_deadline_missed,
+    :liveliness_changed,
+    :requested_incompatible_qos
+  ]
+
+  # rcl has no message lost event on foxy
+  if System.fetch_env!("ROS_DISTRO") != "foxy" do
+    @subscription_events @subscription_events ++ [:message_lost]
+  end
+
+  def publisher_events(), do: @publisher_events
+  def subscription_events(), do: @subscription_events
+
+  def init!(_context, _entity, []), do: %{}
+
+  def init!(context, {:publisher, publisher}, types) do
+    init!(context, types, &Nif.rcl_publisher_event_init!(publisher, &1))
+  end
+
+  def init!(context, {:subscription, subscription}, types) do
+    init!(context, types, &Nif.rcl_subscription_event_init!(subscription, &1))
+  end
+
+  defp init!(context, types, event_init!) do
+    Enum.reduce(types, %{}, fn type, events ->
+      event =
+        try do
+          event_init!.(type)
+        rescue
+          error ->
+            fini!(events)
+            reraise error, __STACKTRACE__
+        end
+
+      Map.put(events, type, start!(context, event))
+    end)
+  end
+
+  def fini!(events) do
+    for {_type, handle} <- events, do: :ok = stop!(handle)
+    :ok
+  end
+
+  case System.fetch_env!("ROS_DISTRO") do
+    "foxy" ->
+      # there is no event callback, a waiter thread per event waits for it instead and sends the
+      # same {:new_event, type, 1}, it is armed again once the status is taken
+      defp start!(context, event) do
+        guard_condition = Nif.rcl_guard_condition_init!(context)
+        waiter = Nif.waiter_start!(context, event, guard_condition)
+        {event, {waiter, guard_condition}}
+      end
+
+      defp stop!({event, {waiter, guard_condition}}) do
+        :ok = Nif.waiter_stop!(waiter)
+        :ok = Nif.rcl_guard_condition_fini!(guard_condition)
+        Nif.rcl_event_fini!(event)
+      end
+
+      defp rearm({_event, {waiter, _guard_condition}}), do: Nif.waiter_arm!(waiter)
+
+    _ ->
+      defp start!(_context, event) do
+        :ok = Nif.rcl_event_set_callback!(event)
+        {event, nil}
+      end
+
+      # rcl_event_fini! clears the callback
+      defp stop!({event, nil}), do: Nif.rcl_event_fini!(event)
+
+      defp rearm(_handle), do: :ok
+  end
+
+  def handle(events, type, kind, metadata, callback) do
+    {event, _} = handle = Map.fetch!(events, type)
+    result = Nif.rcl_take_event!(event)
+    :ok = rearm(handle)
+
+    case result do
+      :event_take_failed ->
+        Logger.debug("#{__MODULE__}: take failed but no error occurred in the middleware")
+
+      status ->
+        {status_metadata, measurements} = Map.split(status, [:last_policy_kind])
+        metadata = metadata |> Map.merge(status_metadata) |> Map.put(:type, type)
+        execute_telemetry([:rclex, kind, :event], measurements, metadata)
+        if callback, do: start_callback(fn -> callback.(type, status) end)
+    end
+
+    :ok
+  end
+
+  defp execute_telemetry(event_name, measurements, metadata) do
+    if Code.ensure_loaded?(:telemetry) do
+      apply(:telemetry, :execute, [event_name, measurements, metadata])
+    end
+  end
+
+  defp start_callback(fun) do
+    {:ok, _pid} =
+      Task.Supervisor.start_child(
+        {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
+        fun
+      )
+  end
+end
@@ -5,18 +5,50 @@ defmodule Rclex.Generators.MsgC do
   alias Rclex.Parsers.TypeParser
 
   def generate(type, ros2_message_type_map) do
+    case Util.message_converter() do
+      :generated -> generate_converter(type, ros2_message_type_map)
+      :introspection -> generate_type_support(type)
+    end
+  end
+
+  defp generate_type_support(type) do
+    EEx.eval_file(Path.join(Util.templates_dir_path(), "msg_type_support_c.eex"),
+      header_name: to_header_name(type),
+      header_prefix: to_header_prefix(type),
+      function_prefix: "nif_" <> Util.type_down_snake(type),
+      rosidl_get_msg_type_support: rosidl_get_msg_type_support(type)
+    )
+  end
+
+  defp generate_converter(type, ros2_message_type_map) do
     set_fun_fragments = set_fun_fragments(type, ros2_message_type_map)
     is_empty_type? = set_fun_fragments == ""
+    size_hint_fragments = size_hint_fragments(type, ros2_message_type_map)
+    function_prefix = "nif_" <> Util.type_down_snake(type)
+
+    # with sequences, the set, get and get_field NIFs schedule their _impl by the size hint
+    nif_signature = fn name ->
+      case size_hint_fragments do
+        "" -> "ERL_NIF_TERM #{function_prefix}_#{name}"
+        _ -> "static ERL_NIF_TERM #{function_prefix}_#{name}_impl"
+      end
+    end
 
     EEx.eval_file(Path.join(Util.templates_dir_path(), "msg_c.eex"),
       header_name: to_header_name(type),
+      deps_nif_header_list: to_deps_nif_header_list(type, ros2_message_type_map),
       deps_header_prefix_list: to_deps_header_prefix_list(type, ros2_message_type_map),
       header_prefix: to_header_prefix(type),
-      function_prefix: "nif_" <> Util.type_down_snake(type),
+      function_prefix: function_prefix,
       rosidl_get_msg_type_support: rosidl_get_msg_type_support(type),
       c_type: to_c_type(type),
       set_fun_fragments: set_fun_fragments,
       get_fun_fragments: get_fun_fragments(type, ros2_message_type_map),
+      set_fun_signature: nif_signature.("set"),
+      get_fun_signature: nif_signature.("get"),
+      get_field_fun_signature: nif_signature.("get_field"),
+      make_field_fun_fragments: make_field_fun_fragments(type, ros2_message_type_map),
+      size_hint_fragments: size_hint_fragments,
       is_empty_type?: is_empty_type?
     )
   end
@@ -34,6 +66,24 @@ defmodule Rclex.Generators.MsgC do
     end)
   end
 
+  @doc """
+  Returns the relative paths of the generated headers of the message types used directly
+  by the fields, whose `_make_field` functions are called for nested field access.
+  """
+  def to_deps_nif_header_list(ros2_message_type, ros2_message_type_map) do
+    get_fields(ros2_message_type, ros2_message_type_map)
+    |> Enum.flat_map(fn
+      [{:msg_type, type} | _] -> [type]
+      [{:msg_type_array, type} | _] -> [get_array_type(type).type]
+      _ -> []
+    end)
+    |> Enum.uniq()
+    |> Enum.map(fn ros2_message_type ->
+      [interfaces, interface_type, type] = ros2_message_type |> String.split("/")
+      Path.join(["..", "..", interfaces, interface_type, Util.to_down_snake(type) <> ".h"])
+    end)
+  end
+
   def to_header_prefix(ros2_message_type) do
     [interfaces, interface_type, type] = ros2_message_type |> String.split("/")
 
@@ -178,28 +228,19 @@ defmodule Rclex.Generators.MsgC do
     end
   end
 
-  def enif_get({:builtin_type_array_unbounded, type}, acc, ros2_message_type_map) do
+  def enif_get({:builtin_type_array_unbounded, type}, acc, _ros2_message_type_map) do
     var = Enum.join(acc.vars, "_")
     mbr = Enum.join(acc.mbrs, ".")
     term = Enum.join(acc.terms, "_")
 
     sequence =
       case type do
-        "string" -> "rosidl_runtime_c__String__Sequence"
+        "string" <> _ -> "rosidl_runtime_c__String__Sequence"
+        "wstring" -> "rosidl_runtime_c__U16String__Sequence"
+        "char" -> "rosidl_runtime_c__uint8__Sequence"
         _ -> "rosidl_runtime_c__#{type}__Sequence"
       end
 
-    vars = acc.vars ++ [type]
-    mbrs = acc.mbrs ++ ["data[#{var}_i]"]
-    terms = acc.vars ++ ["head"]
-
-    binary =
-      (fn ->
-         acc = %Acc{acc | vars: vars, mbrs: mbrs, terms: terms}
-         enif_get({:builtin_type, type}, acc, ros2_message_type_map)
-       end).()
-      |> format()
-
     """
     unsigned int #{var}_length;
     if (!enif_get_list_length(env, #{term}, &#{var}_length))
@@ -210,57 +251,29 @@ defmodule Rclex.Generators.MsgC do
       return enif_make_badarg(env);
     message_p->#{mbr} = #{var};
 
-    unsigned int #{var}_i;
-    ERL_NIF_TERM #{var}_left, #{var}_head, #{var}_tail;
-    for (#{var}_i = 0, #{var}_left = #{term}; #{var}_i < #{var}_length; ++#{var}_i, #{var}_left = #{var}_tail)
-    {
-      if (!enif_get_list_cell(env, #{var}_left, &#{var}_head, &#{var}_tail))
-        return enif_make_badarg(env);
-
-    #{binary}
-    }
+    conversion_ret_t #{var}_ret = get_#{array_kind(type)}_array(env, #{term}, message_p->#{mbr}.data, #{var}_length);
+    if (#{var}_ret != CONVERSION_OK)
+      return conversion_error(env, #{var}_ret);
     """
   end
 
-  def enif_get({:builtin_type_array_static, type, size}, acc, ros2_message_type_map) do
+  def enif_get({:builtin_type_array_static, type, size}, acc, _ros2_message_type_map) do
     var = Enum.join(acc.vars, "_")
+    mbr = Enum.join(acc.mbrs, ".")
     term = Enum.join(acc.terms, "_")
 
-    vars = acc.vars ++ [type]
-    mbrs = List.pop_at(acc.mbrs, -1) |> then(fn {mbr, mbrs} -> mbrs ++ ["#{mbr}[#{var}_i]"] end)
-    terms = acc.vars ++ ["head"]
-
-    binary =
-      (fn ->
-         acc = %Acc{acc | vars: vars, mbrs: mbrs, terms: terms}
-         enif_get({:builtin_type, type}, acc, ros2_message_type_map)
-       end).()
-      |> format()
-
     """
-    unsigned int #{var}_i;
-    ERL_NIF_TERM #{var}_left, #{var}_head, #{var}_tail;
-    for (#{var}_i = 0, #{var}_left = #{term}; #{var}_i < #{size}; ++#{var}_i, #{var}_left = #{var}_tail)
-    {
-      if (!enif_get_list_cell(env, #{var}_left, &#{var}_head, &#{var}_tail))
-        return enif_make_badarg(env);
-
-    #{binary}
-    }
+    conversion_ret_t #{var}_ret = get_#{array_kind(type)}_array(env, #{term}, message_p->#{mbr}, #{size});
+    if (#{var}_ret != CONVERSION_OK)
+      return conversion_error(env, #{var}_ret);
     """
   end
 
   defp enif_get_builtin("bool", var, mbr, term) do
     """
-    unsigned int #{var}_length;
-    if (!enif_get_atom_length(env, #{term}, &#{var}_length, ERL_NIF_LATIN1))
-      return enif_make_badarg(env);
-
-    char #{var}[#{var}_length + 1];
-    if (enif_get_atom(env, #{term}, #{var}, #{var}_length + 1, ERL_NIF_LATIN1) <= 0)
-      return enif_make_badarg(env);
-
-    message_p->#{mbr} = (strncmp(#{var}, "true", 4) == 0);
+    conversion_ret_t #{var}_ret = get_bool(env, #{term}, &(message_p->#{mbr}));
+    if (#{var}_ret != CONVERSION_OK)
+      return conversion_error(env, #{var}_ret);
     """
   end
 
@@ -273,7 +286,7 @@ defmodule Rclex.Generators.MsgC do
     """
   end
 
-  defp enif_get_builtin("byte", var, mbr, term) do
+  defp enif_get_builtin(type, var, mbr, term) when type in ["byte", "char"] do
     """
     unsigned int #{var};
     if (!enif_get_uint(env, #{term}, &#{var}))
@@ -327,32 +340,34 @@ defmodule Rclex.Generators.MsgC do
     """
   end
 
-  defp enif_get_builtin("string", var, mbr, term) do
+  defp enif_get_builtin("string" <> _, var, mbr, term) do
     """
-    unsigned int #{var}_length;
-    #if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-    if (!enif_get_string_length(env, #{term}, &#{var}_length, ERL_NIF_LATIN1))
-      return enif_make_badarg(env);
-    #else
-    if (!enif_get_list_length(env, #{term}, &#{var}_length))
-      return enif_make_badarg(env);
-    #endif
-
-    char #{var}[#{var}_length + 1];
-    if (enif_get_string(env, #{term}, #{var}, #{var}_length + 1, ERL_NIF_LATIN1) <= 0)
-      return enif_make_badarg(env);
+    conversion_ret_t #{var}_ret = get_string(env, #{term}, &(message_p->#{mbr}));
+    if (#{var}_ret != CONVERSION_OK)
+      return conversion_error(env, #{var}_ret);
+    """
+  end
 
-    if (!rosidl_runtime_c__String__assign(&(message_p->#{mbr}), #{var}))
-      return raise(env, __FILE__, __LINE__);
+  defp enif_get_builtin("wstring", var, mbr, term) do
+    """
+    conversion_ret_t #{var}_ret = get_wstring(env, #{term}, &(message_p->#{mbr}));
+    if (#{var}_ret != CONVERSION_OK)
+      return conversion_error(env, #{var}_ret);
     """
   end
 
+  # The element kind of the shared array conversions of conversion.h, char is a uint8 in rosidl
+  # and a bounded string a plain string.
+  defp array_kind(type) when type in ["byte", "char"], do: "uint8"
+  defp array_kind("string<=" <> _), do: "string"
+  defp array_kind(type), do: type
+
   def get_fun_fragments(ros2_message_type, ros2_message_type_map) do
     build_get_fun_fragments(%Acc{type: {:msg_type, ros2_message_type}}, ros2_message_type_map)
     |> format()
   end
 
-  def build_get_fun_fragments(acc, lhs \\ "return", ros2_message_type_map) do
+  def build_get_fun_fragments(acc, statement \\ &"return #{&1};", ros2_message_type_map) do
     {binary, accs} = enif_make(acc.type, acc, ros2_message_type_map)
 
     rhs = binary |> String.replace_suffix("\n", "")
@@ -360,12 +375,12 @@ defmodule Rclex.Generators.MsgC do
     array_accs =
       Enum.filter(accs, fn acc ->
         {type_atom, _} = acc.type
-        type_atom in [:msg_type_array, :builtin_type_array]
+        type_atom == :msg_type_array
       end)
 
     Enum.map_join(array_accs, fn acc ->
       build_get_fun_fragments_array(acc.type, acc, ros2_message_type_map)
-    end) <> "#{lhs} #{rhs};"
+    end) <> statement.(rhs)
   end
 
   def build_get_fun_fragments_array({:msg_type_array, type}, acc, ros2_message_type_map) do
@@ -379,24 +394,6 @@ defmodule Rclex.Generators.MsgC do
     end
   end
 
-  def build_get_fun_fragments_array({:builtin_type_array, type}, acc, ros2_message_type_map) do
-    case get_array_type(type) do
-      %{type: type, kind: :unbounded_dynamic} ->
-        array_for(
-          {:unbounded, type},
-          %Acc{acc | type: {:builtin_type, type}},
-          ros2_message_type_map
-        )
-
-      %{type: type, kind: :static, size: size} ->
-        array_for(
-          {:static, type, size},
-          %Acc{acc | type: {:builtin_type, type}},
-          ros2_message_type_map
-        )
-    end
-  end
-
   defp array_for({:unbounded, _type}, acc, ros2_message_type_map) do
     var = Enum.join(acc.vars, "_")
     mbr = Enum.join(acc.mbrs, ".")
@@ -405,36 +402,21 @@ defmodule Rclex.Generators.MsgC do
 
     acc = %Acc{acc | mbrs: mbrs}
 
-    binary =
-      build_get_fun_fragments(acc, "#{var}[#{var}_i] =", ros2_message_type_map)
-      |> format()
-
-    """
-    ERL_NIF_TERM #{var}[message_p->#{mbr}.size];
-
-    for (size_t #{var}_i = 0; #{var}_i < message_p->#{mbr}.size; ++#{var}_i)
-    {
-    #{binary}
-    }
-
-    """
-  end
-
-  defp array_for({:static, _type, size}, acc, ros2_message_type_map) do
-    var = Enum.join(acc.vars, "_")
-
-    mbrs = List.pop_at(acc.mbrs, -1) |> then(fn {mbr, mbrs} -> mbrs ++ ["#{mbr}[#{var}_i]"] end)
-
-    acc = %Acc{acc | mbrs: mbrs}
+    # The list is built from its tail so that no scratch array sized by the sequence, which
+    # can be arbitrarily large, has to live on the scheduler's stack.
+    statement = fn rhs ->
+      "ERL_NIF_TERM #{var}_i_term = #{rhs};\n" <>
+        "#{var} = enif_make_list_cell(env, #{var}_i_term, #{var});"
+    end
 
     binary =
-      build_get_fun_fragments(acc, "#{var}[#{var}_i] =", ros2_message_type_map)
+      build_get_fun_fragments(acc, statement, ros2_message_type_map)
       |> format()
 
     """
-    ERL_NIF_TERM #{var}[#{size}];
+    ERL_NIF_TERM #{var} = enif_make_list(env, 0);
 
-    for (size_t #{var}_i = 0; #{var}_i < #{size}; ++#{var}_i)
+    for (size_t #{var}_i = message_p->#{mbr}.size; #{var}_i-- > 0;)
     {
     #{binary}
     }
@@ -484,24 +466,29 @@ defmodule Rclex.Generators.MsgC do
   end
 
   def enif_make({:builtin_type_array, type}, acc, _ros2_message_type_map) do
+    mbr = Enum.join(acc.mbrs, ".")
+
     case get_array_type(type) do
       %{type: type, kind: :unbounded_dynamic} ->
-        {enif_make_array({:unbounded, type}, acc), [acc]}
+        data = "message_p->#{mbr}.data"
+        {make_list(type, data, "0", "message_p->#{mbr}.size"), []}
 
       %{type: type, kind: :static, size: size} ->
-        {enif_make_array({:static, type, size}, acc), [acc]}
+        {make_list(type, "message_p->#{mbr}", "0", size), []}
     end
   end
 
+  defp make_list(type, data, start, length) do
+    "make_#{array_kind(type)}_list(env, #{data}, #{start}, #{length})"
+  end
+
   def enif_make({:builtin_type, type}, acc, _ros2_message_type_map) do
     mbr = Enum.join(acc.mbrs, ".")
     {enif_make_builtin(type, mbr), [acc]}
   end
 
   defp enif_make_array({:unbounded, _type}, acc) do
-    var = Enum.join(acc.vars, "_")
-    mbr = Enum.join(acc.mbrs, ".")
-    "enif_make_list_from_array(env, #{var}, message_p->#{mbr}.size)"
+    Enum.join(acc.vars, "_")
   end
 
   defp enif_make_array({:static, _type, size}, acc) do
@@ -517,7 +504,7 @@ defmodule Rclex.Generators.MsgC do
     "enif_make_int64(env, message_p->#{mbr})"
   end
 
-  defp enif_make_builtin("byte", mbr) do
+  defp enif_make_builtin(type, mbr) when type in ["byte", "char"] do
     "enif_make_uint(env, message_p->#{mbr})"
   end
 
@@ -537,10 +524,241 @@ defmodule Rclex.Generators.MsgC do
     "enif_make_double(env, message_p->#{mbr})"
   end
 
-  defp enif_make_builtin("string", mbr) do
+  defp enif_make_builtin("string" <> _, mbr) do
     "enif_make_string(env, message_p->#{mbr}.data, ERL_NIF_LATIN1)"
   end
 
+  defp enif_make_builtin("wstring", mbr) do
+    "make_wstring(env, &(message_p->#{mbr}))"
+  end
+
+  def make_field_fun_fragments(ros2_message_type, ros2_message_type_map) do
+    case get_fields(ros2_message_type, ros2_message_type_map) do
+      [] ->
+        """
+        ignore_unused(ros_message_p);
+        ignore_unused(path);
+
+        return enif_make_badarg(env);
+        """
+
+      fields ->
+        c_type = to_c_type(ros2_message_type)
+
+        cases =
+          Enum.with_index(fields)
+          |> Enum.map_join("\n", fn {[type, name | _], index} ->
+            acc = %Acc{vars: [name], mbrs: [name], type: type}
+            binary = make_field(type, acc, ros2_message_type_map) |> format()
+
+            """
+            case #{index}: {
+            #{binary}
+            }
+            """
+          end)
+          |> String.replace_suffix("\n", "")
+
+        """
+        const #{c_type} *message_p = (const #{c_type} *)ros_message_p;
+
+        int index;
+        ERL_NIF_TERM head, rest;
+        if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+          return enif_make_badarg(env);
+
+        switch (index) {
+        #{cases}
+        }
+
+        return enif_make_badarg(env);
+        """
+    end
+    |> format()
+  end
+
+  defp make_field({:builtin_type, _type} = type, acc, ros2_message_type_map) do
+    {binary, _accs} = enif_make(type, acc, ros2_message_type_map)
+
+    """
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return #{binary};
+    """
+  end
+
+  defp make_field({:msg_type, ros2_message_type}, acc, ros2_message_type_map) do
+    mbr = Enum.join(acc.mbrs, ".")
+    binary = build_get_fun_fragments(acc, ros2_message_type_map)
+
+    """
+    if (!enif_is_empty_list(env, rest))
+      return #{make_field_function(ros2_message_type)}(env, &message_p->#{mbr}, rest);
+
+    #{binary}
+    """
+  end
+
+  defp make_field({:msg_type_array, type}, acc, ros2_message_type_map) do
+    %{type: type} = array_type = get_array_type(type)
+
+    nested_return = fn mbr, rest ->
+      "#{make_field_function(type)}(env, &message_p->#{mbr}, #{rest})"
+    end
+
+    make_array_field({:msg_type, type}, array_type, nested_return, acc, ros2_message_type_map)
+  end
+
+  defp make_field({:builtin_type_array, type}, acc, ros2_message_type_map) do
+    %{type: type} = array_type = get_array_type(type)
+    nested_return = fn _mbr, _rest -> "enif_make_badarg(env)" end
+
+    make_array_field({:builtin_type, type}, array_type, nested_return, acc, ros2_message_type_map)
+  end
+
+  defp make_array_field(element_type, array_type, nested_return, acc, ros2_message_type_map) do
+    var = Enum.join(acc.vars, "_")
+    mbr = Enum.join(acc.mbrs, ".")
+
+    {data, size, element_mbrs} =
+      case array_type do
+        %{kind: :unbounded_dynamic} ->
+          {"message_p->#{mbr}.data", "message_p->#{mbr}.size", acc.mbrs ++ ["data[#{var}_i]"]}
+
+        %{kind: :static, size: size} ->
+          {last, mbrs} = List.pop_at(acc.mbrs, -1)
+          {"message_p->#{mbr}", size, mbrs ++ ["#{last}[#{var}_i]"]}
+      end
+
+    element_acc = %Acc{acc | mbrs: element_mbrs, type: element_type}
+
+    whole = build_get_fun_fragments(acc, ros2_message_type_map) |> format()
+    element = build_get_fun_fragments(element_acc, ros2_message_type_map) |> format()
+
+    slice =
+      case element_type do
+        {:builtin_type, type} ->
+          "return #{make_list(type, data, "#{var}_start", "#{var}_length")};"
+
+        {:msg_type, _type} ->
+          statement = fn rhs ->
+            "ERL_NIF_TERM #{var}_i_term = #{rhs};\n" <>
+              "#{var} = enif_make_list_cell(env, #{var}_i_term, #{var});"
+          end
+
+          elements =
+            build_get_fun_fragments(element_acc, statement, ros2_message_type_map) |> format()
+
+          """
+          ERL_NIF_TERM #{var} = enif_make_list(env, 0);
+
+          for (#{var}_i = #{var}_start + #{var}_length; #{var}_i-- > #{var}_start;)
+          {
+          #{elements}
+          }
+
+          return #{var};\
+          """
+      end
+
+    """
+    size_t #{var}_size = #{size};
+
+    if (enif_is_empty_list(env, rest)) {
+    #{whole}
+    }
+
+    ERL_NIF_TERM #{var}_head, #{var}_rest;
+    if (!enif_get_list_cell(env, rest, &#{var}_head, &#{var}_rest))
+      return enif_make_badarg(env);
+
+    size_t #{var}_i;
+    unsigned long #{var}_index;
+    if (enif_get_ulong(env, #{var}_head, &#{var}_index)) {
+      if (#{var}_index >= #{var}_size) return enif_make_badarg(env);
+      #{var}_i = #{var}_index;
+
+      if (!enif_is_empty_list(env, #{var}_rest))
+        return #{nested_return.(Enum.join(element_mbrs, "."), "#{var}_rest")};
+
+    #{element}
+    }
+
+    int #{var}_arity;
+    const ERL_NIF_TERM *#{var}_slice;
+    unsigned long #{var}_start, #{var}_length;
+    if (!enif_get_tuple(env, #{var}_head, &#{var}_arity, &#{var}_slice) || #{var}_arity != 2 ||
+        !enif_get_ulong(env, #{var}_slice[0], &#{var}_start) ||
+        !enif_get_ulong(env, #{var}_slice[1], &#{var}_length) ||
+        !enif_is_empty_list(env, #{var}_rest))
+      return enif_make_badarg(env);
+
+    if (#{var}_start > #{var}_size) #{var}_start = #{var}_size;
+    if (#{var}_length > #{var}_size - #{var}_start) #{var}_length = #{var}_size - #{var}_start;
+
+    #{slice}
+    """
+  end
+
+  defp make_field_function(ros2_message_type) do
+    "nif_#{Util.type_down_snake(ros2_message_type)}_make_field"
+  end
+
+  @doc """
+  Returns the C statements adding the sizes of the unbounded sequences of the message to
+  `elements`, those of nested messages and of the elements of message arrays included,
+  "" if the message has none.
+
+  The generated `_get` and `_get_field` use it to decide whether the conversion should leave
+  the normal scheduler.
+  """
+  def size_hint_fragments(ros2_message_type, ros2_message_type_map) do
+    size_hint_lines({:msg_type, ros2_message_type}, "message_p->", 0, ros2_message_type_map)
+    |> Enum.join("\n")
+    |> format()
+  end
+
+  defp size_hint_lines({:msg_type, ros2_message_type}, prefix, depth, ros2_message_type_map) do
+    get_fields(ros2_message_type, ros2_message_type_map)
+    |> Enum.flat_map(fn [type, name | _] ->
+      case type do
+        {:msg_type, _type} ->
+          size_hint_lines(type, "#{prefix}#{name}.", depth, ros2_message_type_map)
+
+        {:msg_type_array, array_type} ->
+          %{type: type, kind: kind, size: size} = get_array_type(array_type)
+          index = "i_#{depth}"
+
+          {count, element_prefix} =
+            case kind do
+              :static -> {size, "#{prefix}#{name}[#{index}]."}
+              _ -> {"#{prefix}#{name}.size", "#{prefix}#{name}.data[#{index}]."}
+            end
+
+          element_lines =
+            size_hint_lines({:msg_type, type}, element_prefix, depth + 1, ros2_message_type_map)
+
+          sequence_size(kind, "#{prefix}#{name}") ++
+            if element_lines == [] do
+              []
+            else
+              ["for (size_t #{index} = 0; #{index} < #{count}; ++#{index}) {"] ++
+                Enum.map(element_lines, &("  " <> &1)) ++ ["}"]
+            end
+
+        {:builtin_type_array, array_type} ->
+          sequence_size(get_array_type(array_type).kind, "#{prefix}#{name}")
+
+        _ ->
+          []
+      end
+    end)
+  end
+
+  defp sequence_size(:unbounded_dynamic, mbr), do: ["elements += #{mbr}.size;"]
+  defp sequence_size(_kind, _mbr), do: []
+
   defp format(binary) do
     indent = String.duplicate(" ", 2)
 
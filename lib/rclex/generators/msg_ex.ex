@@ -7,7 +7,7 @@ defmodule Rclex.Generators.MsgEx do
   @ros2_elixir_type_map %{
     "bool" => "boolean()",
     "byte" => "0..255",
-    "char" => "-128..127",
+    "char" => "0..255",
     "float32" => "float()",
     "float64" => "float()",
     "int8" => "-128..127",
@@ -28,10 +28,17 @@ defmodule Rclex.Generators.MsgEx do
       defstruct_fields: defstruct_fields(type, ros2_message_type_map),
       type_fields: type_fields(type, ros2_message_type_map),
       function_prefix: Util.type_down_snake(type),
+      converter: Util.message_converter(),
+      type_support: Util.type_support(),
+      ros2_message_type: type,
       to_tuple_args_fields: to_tuple_args_fields(type, ros2_message_type_map),
       to_struct_args_fields: to_struct_args_fields(type, ros2_message_type_map),
       to_tuple_return_fields: to_tuple_return_fields(type, ros2_message_type_map),
-      to_struct_return_fields: to_struct_return_fields(type, ros2_message_type_map)
+      to_struct_return_fields: to_struct_return_fields(type, ros2_message_type_map),
+      field_path_clauses: field_path_clauses(type, ros2_message_type_map),
+      field_value_clauses: field_value_clauses(type, ros2_message_type_map),
+      cdr_put_fields: cdr_put_fields(type, ros2_message_type_map),
+      cdr_take_fields: cdr_take_fields(type, ros2_message_type_map)
     )
     |> Code.format_string!()
     |> IO.iodata_to_binary()
@@ -212,6 +219,261 @@ defmodule Rclex.Generators.MsgEx do
     end
   end
 
+  @doc """
+  Returns the `field_path/1` clauses which translate a path of field names, array indices
+  and `{start, length}` slices into the field indices taken by the `_get_field!` NIF.
+  """
+  def field_path_clauses(ros2_message_type, ros2_message_type_map) do
+    get_fields(ros2_message_type, ros2_message_type_map)
+    |> Enum.with_index()
+    |> Enum.flat_map(fn {[type_tuple, name | _], index} ->
+      # credo:disable-for-next-line Credo.Check.Refactor.Nesting
+      case type_tuple do
+        {:msg_type, type} ->
+          module_name = module_name(type)
+
+          [
+            """
+            def field_path([:#{name} | rest]) do
+              [#{index} | Rclex.Pkgs.#{module_name}.field_path(rest)]
+            end
+            """
+          ]
+
+        {:msg_type_array, type} ->
+          module_name = type |> get_array_type() |> module_name()
+
+          [
+            """
+            def field_path([:#{name}, index | rest]) when is_integer(index) do
+              [#{index}, index | Rclex.Pkgs.#{module_name}.field_path(rest)]
+            end
+            """,
+            """
+            def field_path([:#{name} | rest]) do
+              [#{index} | rest]
+            end
+            """
+          ]
+
+        _builtin_type ->
+          [
+            """
+            def field_path([:#{name} | rest]) do
+              [#{index} | rest]
+            end
+            """
+          ]
+      end
+    end)
+    |> then(fn clauses ->
+      [
+        """
+        def field_path([]) do
+          []
+        end
+        """
+        | clauses
+      ]
+    end)
+    |> Enum.join("\n")
+    |> String.replace_suffix("\n", "")
+  end
+
+  @doc """
+  Returns the `field_value/2` clauses which convert the term returned by the `_get_field!`
+  NIF for a path into the same representation `get!/1` gives that field.
+  """
+  def field_value_clauses(ros2_message_type, ros2_message_type_map) do
+    get_fields(ros2_message_type, ros2_message_type_map)
+    |> Enum.flat_map(fn [type_tuple, name | _] ->
+      # credo:disable-for-next-line Credo.Check.Refactor.Nesting
+      case type_tuple do
+        {:builtin_type, "string" <> _} ->
+          [
+            """
+            def field_value([:#{name}], term) do
+              "\#{term}"
+            end
+            """
+          ]
+
+        {:builtin_type, _type} ->
+          [
+            """
+            def field_value([:#{name}], term) do
+              term
+            end
+            """
+          ]
+
+        {:builtin_type_array, "uint8[]"} ->
+          [
+            """
+            def field_value([:#{name}, index], term) when is_integer(index) do
+              term
+            end
+            """,
+            """
+            def field_value([:#{name} | _], term) do
+              IO.iodata_to_binary(term)
+            end
+            """
+          ]
+
+        {:builtin_type_array, _type} ->
+          [
+            """
+            def field_value([:#{name} | _], term) do
+              term
+            end
+            """
+          ]
+
+        {:msg_type, type} ->
+          module_name = module_name(type)
+
+          [
+            """
+            def field_value([:#{name} | rest], term) do
+              Rclex.Pkgs.#{module_name}.field_value(rest, term)
+            end
+            """
+          ]
+
+        {:msg_type_array, type} ->
+          module_name = type |> get_array_type() |> module_name()
+
+          [
+            """
+            def field_value([:#{name}, index | rest], term) when is_integer(index) do
+              Rclex.Pkgs.#{module_name}.field_value(rest, term)
+            end
+            """,
+            """
+            def field_value([:#{name} | _], term) do
+              Enum.map(term, &Rclex.Pkgs.#{module_name}.to_struct/1)
+            end
+            """
+          ]
+      end
+    end)
+    |> then(fn clauses ->
+      [
+        """
+        def field_value([], term) do
+          to_struct(term)
+        end
+        """
+        | clauses
+      ]
+    end)
+    |> Enum.join("\n")
+    |> String.replace_suffix("\n", "")
+  end
+
+  @doc """
+  Returns the body of `cdr_put/2`, which appends the CDR encoding of the struct fields,
+  bound by `to_tuple_args_fields/2`, to `acc`.
+  """
+  def cdr_put_fields(ros2_message_type, ros2_message_type_map) do
+    fields = get_fields(ros2_message_type, ros2_message_type_map)
+
+    if Enum.empty?(fields) do
+      # an empty message is serialized with the dummy member added by rosidl
+      "Rclex.CDR.put(acc, :uint8, 0)"
+    else
+      fields
+      |> Enum.map_join("\n", fn [type_tuple, name | _] ->
+        # credo:disable-for-next-line Credo.Check.Refactor.Nesting
+        case type_tuple do
+          {:builtin_type, type} ->
+            "|> Rclex.CDR.put(#{cdr_type(type)}, #{name})"
+
+          {:builtin_type_array, "uint8[]"} ->
+            "|> Rclex.CDR.put_bytes(#{name})"
+
+          {:builtin_type_array, type} ->
+            cdr_put_array(type, cdr_type(get_array_type(type)), name)
+
+          {:msg_type, type} ->
+            "|> Rclex.Pkgs.#{module_name(type)}.cdr_put(#{name})"
+
+          {:msg_type_array, type} ->
+            module_name = type |> get_array_type() |> module_name()
+            cdr_put_array(type, "&Rclex.Pkgs.#{module_name}.cdr_put/2", name)
+        end
+      end)
+      |> then(&"acc\n#{&1}")
+    end
+  end
+
+  @doc """
+  Returns the body of `cdr_take/1`, which decodes the struct from the CDR `cursor`.
+  """
+  def cdr_take_fields(ros2_message_type, ros2_message_type_map) do
+    fields = get_fields(ros2_message_type, ros2_message_type_map)
+
+    if Enum.empty?(fields) do
+      """
+      {_structure_needs_at_least_one_member, cursor} = Rclex.CDR.take(cursor, :uint8)
+      {%__MODULE__{}, cursor}
+      """
+    else
+      fields
+      |> Enum.map_join(fn [type_tuple, name | _] ->
+        # credo:disable-for-next-line Credo.Check.Refactor.Nesting
+        case type_tuple do
+          {:builtin_type, type} ->
+            "{#{name}, cursor} = Rclex.CDR.take(cursor, #{cdr_type(type)})\n"
+
+          {:builtin_type_array, "uint8[]"} ->
+            "{#{name}, cursor} = Rclex.CDR.take_bytes(cursor)\n"
+
+          {:builtin_type_array, type} ->
+            cdr_take_array(type, cdr_type(get_array_type(type)), name)
+
+          {:msg_type, type} ->
+            "{#{name}, cursor} = Rclex.Pkgs.#{module_name(type)}.cdr_take(cursor)\n"
+
+          {:msg_type_array, type} ->
+            module_name = type |> get_array_type() |> module_name()
+            cdr_take_array(type, "&Rclex.Pkgs.#{module_name}.cdr_take/1", name)
+        end
+      end)
+      |> then(fn binary ->
+        args = to_tuple_args_fields(ros2_message_type, ros2_message_type_map)
+        "#{binary}{%__MODULE__{#{args}}, cursor}\n"
+      end)
+    end
+    |> String.replace_suffix("\n", "")
+  end
+
+  defp cdr_put_array(type, put, name) do
+    case static_array_size(type) do
+      nil -> "|> Rclex.CDR.put_sequence(#{put}, #{name})"
+      _size -> "|> Rclex.CDR.put_array(#{put}, #{name})"
+    end
+  end
+
+  defp cdr_take_array(type, take, name) do
+    case static_array_size(type) do
+      nil -> "{#{name}, cursor} = Rclex.CDR.take_sequence(cursor, #{take})\n"
+      size -> "{#{name}, cursor} = Rclex.CDR.take_array(cursor, #{take}, #{size})\n"
+    end
+  end
+
+  defp cdr_type("string" <> _), do: ":string"
+  defp cdr_type("wstring" <> _), do: ":wstring"
+  defp cdr_type(type), do: ":#{type}"
+
+  defp static_array_size(type) do
+    case Regex.run(~r/\[(\d+)\]$/, type) do
+      [_, size] -> size
+      nil -> nil
+    end
+  end
+
   @doc """
   iex> Rclex.Generators.MsgEx.module_name("std_msgs/msg/String")
   "StdMsgs.Msg.String"
@@ -4,7 +4,13 @@ defmodule Rclex.Generators.MsgH do
   alias Rclex.Generators.Util
 
   def generate(type, _ros2_message_type_map) do
-    EEx.eval_file(Path.join(Util.templates_dir_path(), "msg_h.eex"),
+    template =
+      case Util.message_converter() do
+        :generated -> "msg_h.eex"
+        :introspection -> "msg_type_support_h.eex"
+      end
+
+    EEx.eval_file(Path.join(Util.templates_dir_path(), template),
       function_prefix: "nif_" <> Util.type_down_snake(type)
     )
   end
@@ -9,6 +9,38 @@ defmodule Rclex.Generators.Util do
     end
   end
 
+  @doc """
+  Returns how the generated message modules convert between Elixir terms and ROS 2 messages,
+  `:generated` (per-type C, the default) or `:introspection`.
+  """
+  def message_converter() do
+    case Application.get_env(:rclex, :message_converter, :generated) do
+      converter when converter in [:generated, :introspection] -> converter
+      converter -> raise "unknown message_converter #{inspect(converter)}"
+    end
+  end
+
+  @doc """
+  Returns how the generated message modules get their type support, `:linked` (generated in C
+  and linked into the NIF library, the default) or `:lazy` (resolved on first use from the
+  library of the package by `Rclex.TypeSupport`). `:lazy` requires the introspection converter.
+  """
+  def type_support() do
+    case {Application.get_env(:rclex, :type_support, :linked), message_converter()} do
+      {:linked, _converter} ->
+        :linked
+
+      {:lazy, :introspection} ->
+        :lazy
+
+      {:lazy, _converter} ->
+        raise "type_support: :lazy requires message_converter: :introspection"
+
+      {type_support, _converter} ->
+        raise "unknown type_support #{inspect(type_support)}"
+    end
+  end
+
   @doc """
   iex> Rclex.Generators.Util.type_down_snake("std_msgs/msg/String")
   "std_msgs_msg_string"
@@ -17,6 +17,10 @@ defmodule Rclex.Graph do
     Nif.rcl_get_client_names_and_types_by_node!(node, node_name, namespace)
   end
 
+  def get_graph_snapshot(node) do
+    Nif.rcl_get_graph_snapshot!(node)
+  end
+
   def get_node_names(node) do
     Nif.rcl_get_node_names!(node)
   end
@@ -0,0 +1,39 @@
+defmodule Rclex.GraphCache do
+  @moduledoc false
+
+  # The results of graph queries of a node, kept in an ETS table of the node process and read
+  # by the processes that ask them. The table has a generation, bumped by the node process each
+  # time the graph guard condition of the node fires, and each result is tagged with the
+  # generation it was queried in, so that only results of the current generation are served.
+  # A result queried while the graph changed is stored with the old generation and ignored.
+
+  def new() do
+    table = :ets.new(__MODULE__, [:set, :public, read_concurrency: true])
+    true = :ets.insert(table, {:generation, 0})
+    table
+  end
+
+  def generation(table) do
+    :ets.lookup_element(table, :generation, 2)
+  end
+
+  def invalidate(table) do
+    generation = :ets.update_counter(table, :generation, 1)
+    :ets.select_delete(table, [{{{:query, :_}, :"$1", :_}, [{:<, :"$1", generation}], [true]}])
+    generation
+  end
+
+  def fetch(table, key, query) do
+    generation = generation(table)
+
+    case :ets.lookup(table, {:query, key}) do
+      [{_key, ^generation, result}] ->
+        result
+
+      _ ->
+        result = query.()
+        true = :ets.insert(table, {{:query, key}, generation, result})
+        result
+    end
+  end
+end
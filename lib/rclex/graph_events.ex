@@ -0,0 +1,45 @@
+defmodule Rclex.GraphEvents do
+  @moduledoc false
+
+  # Changes of the graph seen by a node, for the processes subscribed to them. While there are
+  # subscribers, the graph watcher of the node keeps a snapshot of the nodes, the topics with
+  # their types and the publisher and subscription endpoints of each topic, takes a new one from
+  # the graph snapshot of the node each time its graph guard condition fires and sends the
+  # difference as {:graph_event, event}, with event one of
+  #
+  #   {:node_added, name, namespace}, {:node_removed, name, namespace}
+  #   {:topic_added, name, types}, {:topic_removed, name, types}
+  #   {:endpoint_added, info}, {:endpoint_removed, info}
+  #
+  # A new subscriber is first sent the current graph as added events.
+
+  def empty(), do: %{nodes: MapSet.new(), topics: %{}, endpoints: MapSet.new()}
+
+  def snapshot(graph) do
+    %{
+      nodes: MapSet.new(graph.nodes, fn {name, namespace, _enclave} -> {name, namespace} end),
+      topics: Map.new(graph.topics),
+      endpoints: MapSet.new(graph.endpoints)
+    }
+  end
+
+  # a topic whose types changed is both removed and added
+  def diff(old, new) do
+    Enum.concat([
+      for({name, ns} <- removed(old.nodes, new.nodes), do: {:node_removed, name, ns}),
+      for({name, ns} <- added(old.nodes, new.nodes), do: {:node_added, name, ns}),
+      for({name, types} <- removed(old.topics, new.topics), do: {:topic_removed, name, types}),
+      for({name, types} <- added(old.topics, new.topics), do: {:topic_added, name, types}),
+      for(info <- removed(old.endpoints, new.endpoints), do: {:endpoint_removed, info}),
+      for(info <- added(old.endpoints, new.endpoints), do: {:endpoint_added, info})
+    ])
+  end
+
+  def notify(subscribers, events) do
+    for pid <- subscribers, event <- events, do: send(pid, {:graph_event, event})
+    :ok
+  end
+
+  defp added(old, new), do: Enum.reject(new, &(&1 in old))
+  defp removed(old, new), do: Enum.reject(old, &(&1 in new))
+end
@@ -0,0 +1,165 @@
+defmodule Rclex.GraphWatcher do
+  @moduledoc false
+
+  use GenServer
+
+  alias Rclex.Graph
+  alias Rclex.GraphEvents
+
+  # Follows the graph for a node, so that its snapshots, diffs and waits don't hold up the start
+  # and stop of entities in the node process. The node process only forwards the firing of its
+  # graph guard condition with graph_changed/2. Started after the node by the node supervisor,
+  # it uses the node handle registered by the node, see Rclex.Registry.
+
+  def start_link(args) do
+    name = Keyword.fetch!(args, :name)
+    namespace = Keyword.fetch!(args, :namespace)
+
+    GenServer.start_link(__MODULE__, args, name: name(name, namespace))
+  end
+
+  def name(name, namespace \\ "/") do
+    Rclex.Registry.via({:graph_watcher, name, namespace})
+  end
+
+  def graph_changed(name, namespace) do
+    GenServer.cast(name(name, namespace), :graph_changed)
+  end
+
+  def subscribe_graph_events(name, namespace) do
+    GenServer.call(name(name, namespace), :subscribe_graph_events)
+  end
+
+  def unsubscribe_graph_events(name, namespace) do
+    GenServer.call(name(name, namespace), :unsubscribe_graph_events)
+  end
+
+  def wait_for(kind, topic_name, count, timeout, name, namespace) do
+    GenServer.call(name(name, namespace), {:wait_for, kind, topic_name, count, timeout})
+  end
+
+  # callbacks
+
+  def init(args) do
+    name = Keyword.fetch!(args, :name)
+    namespace = Keyword.fetch!(args, :namespace)
+    {:ok, {node, _cache}} = Rclex.Registry.lookup_node_handle(name, namespace)
+
+    {:ok, %{node: node, subscribers: %{}, snapshot: nil, waits: %{}}}
+  end
+
+  def handle_call(:subscribe_graph_events, {pid, _tag}, state) do
+    if Map.has_key?(state.subscribers, pid) do
+      {:reply, {:error, :already_subscribed}, state}
+    else
+      snapshot = state.snapshot || take_snapshot(state.node)
+      :ok = GraphEvents.notify([pid], GraphEvents.diff(GraphEvents.empty(), snapshot))
+      subscribers = Map.put(state.subscribers, pid, Process.monitor(pid))
+
+      {:reply, :ok, %{state | subscribers: subscribers, snapshot: snapshot}}
+    end
+  end
+
+  def handle_call(:unsubscribe_graph_events, {pid, _tag}, state) do
+    case Map.pop(state.subscribers, pid) do
+      {nil, _subscribers} ->
+        {:reply, {:error, :not_found}, state}
+
+      {monitor, subscribers} ->
+        true = Process.demonitor(monitor, [:flush])
+        {:reply, :ok, put_subscribers(state, subscribers)}
+    end
+  end
+
+  def handle_call({:wait_for, kind, topic_name, count, timeout}, {pid, _tag}, state) do
+    ref = make_ref()
+    wait = {pid, kind, topic_name, count}
+
+    if wait_done?(state.node, wait) do
+      send(pid, {:graph_wait, ref, :ok})
+      {:reply, {:ok, ref}, state}
+    else
+      timer = if timeout != :infinity, do: Process.send_after(self(), {:graph_wait, ref}, timeout)
+      waits = Map.put(state.waits, ref, {wait, timer})
+
+      {:reply, {:ok, ref}, %{state | waits: waits}}
+    end
+  end
+
+  def handle_cast(:graph_changed, state) do
+    state = check_waits(state)
+
+    if is_nil(state.snapshot) do
+      {:noreply, state}
+    else
+      snapshot = take_snapshot(state.node)
+      events = GraphEvents.diff(state.snapshot, snapshot)
+      :ok = GraphEvents.notify(Map.keys(state.subscribers), events)
+
+      {:noreply, %{state | snapshot: snapshot}}
+    end
+  end
+
+  def handle_info({:graph_wait, ref}, state) do
+    case Map.pop(state.waits, ref) do
+      {nil, _waits} ->
+        {:noreply, state}
+
+      {{{pid, _kind, _topic_name, _count}, _timer}, waits} ->
+        send(pid, {:graph_wait, ref, {:error, :timeout}})
+        {:noreply, %{state | waits: waits}}
+    end
+  end
+
+  def handle_info({:DOWN, _monitor, :process, pid, _reason}, state) do
+    {:noreply, put_subscribers(state, Map.delete(state.subscribers, pid))}
+  end
+
+  defp take_snapshot(node) do
+    GraphEvents.snapshot(Rclex.Node.take_graph_snapshot(node))
+  end
+
+  # the waits are checked each time the graph changes, those of exited processes are dropped
+  defp check_waits(state) when map_size(state.waits) == 0, do: state
+
+  defp check_waits(state) do
+    waits =
+      Enum.reject(state.waits, fn {ref, {{pid, _, _, _} = wait, timer}} ->
+        cond do
+          not Process.alive?(pid) ->
+            :ok = cancel_timer(timer)
+            true
+
+          wait_done?(state.node, wait) ->
+            :ok = cancel_timer(timer)
+            send(pid, {:graph_wait, ref, :ok})
+            true
+
+          true ->
+            false
+        end
+      end)
+
+    %{state | waits: Map.new(waits)}
+  end
+
+  defp wait_done?(node, {_pid, :publishers, topic_name, count}) do
+    Graph.count_publishers(node, ~c"#{topic_name}") >= count
+  end
+
+  defp wait_done?(node, {_pid, :subscribers, topic_name, count}) do
+    Graph.count_subscribers(node, ~c"#{topic_name}") >= count
+  end
+
+  defp cancel_timer(nil), do: :ok
+  defp cancel_timer(timer), do: Process.cancel_timer(timer, info: false)
+
+  # the snapshot is only kept while there are subscribers
+  defp put_subscribers(state, subscribers) when map_size(subscribers) == 0 do
+    %{state | subscribers: subscribers, snapshot: nil}
+  end
+
+  defp put_subscribers(state, subscribers) do
+    %{state | subscribers: subscribers}
+  end
+end
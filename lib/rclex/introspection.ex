@@ -0,0 +1,62 @@
+defmodule Rclex.Introspection do
+  @moduledoc false
+
+  # Generic message conversion driven by the rosidl_typesupport_introspection_c member tables.
+  #
+  # The member tables of a message type are flattened into a native plan once, on first use,
+  # and the plan is cached in :persistent_term keyed by the message module. Terms are exchanged
+  # in the same tuple shape as the generated per-type NIFs, so to_tuple/1 and to_struct/1 of
+  # the message module can be used unchanged.
+  #
+  # A message type may also be given as a type string like "std_msgs/msg/String", in which case
+  # its type support is resolved at runtime by Rclex.TypeSupport and no code needs to be
+  # generated for it. Such messages are read with get_map!/2.
+
+  alias Rclex.Nif
+
+  def type_support!(message_type) when is_atom(message_type) do
+    message_type.type_support!()
+  end
+
+  def type_support!(message_type) when is_binary(message_type) do
+    Rclex.TypeSupport.fetch!(message_type)
+  end
+
+  def plan!(message_type) when is_atom(message_type) or is_binary(message_type) do
+    key = {__MODULE__, message_type}
+
+    case :persistent_term.get(key, nil) do
+      nil ->
+        plan = Nif.introspection_plan!(type_support!(message_type))
+        :persistent_term.put(key, plan)
+        plan
+
+      plan ->
+        plan
+    end
+  end
+
+  def create!(message_type) do
+    Nif.introspection_create!(plan!(message_type))
+  end
+
+  def destroy!(message_type, message) do
+    Nif.introspection_destroy!(plan!(message_type), message)
+  end
+
+  def set!(message_type, message, data) when is_tuple(data) do
+    Nif.introspection_set!(plan!(message_type), message, data)
+  end
+
+  def get!(message_type, message) do
+    Nif.introspection_get!(plan!(message_type), message)
+  end
+
+  def get_field!(message_type, message, path) when is_list(path) do
+    Nif.introspection_get_field!(plan!(message_type), message, path)
+  end
+
+  def get_map!(message_type, message) do
+    Nif.introspection_get_map!(plan!(message_type), message)
+  end
+end
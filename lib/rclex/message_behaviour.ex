@@ -6,6 +6,9 @@ defmodule Rclex.MessageBehaviour do
   @callback destroy!(message :: reference()) :: :ok
   @callback set!(message :: reference(), data :: any()) :: :ok
   @callback get!(message :: reference()) :: data :: any()
+  @callback get_field!(message :: reference(), path :: list()) :: data :: any()
+  @callback serialize!(struct()) :: binary()
+  @callback deserialize!(binary()) :: struct()
   @callback to_tuple(struct()) :: tuple()
   @callback to_struct(tuple()) :: struct()
 end
@@ -52,6 +52,10 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def rcl_publish_with_stamp!(_publisher, _message, _clock, _offset) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   def rcl_subscription_init!(_node, _type_support, _topic_name, _qos) do
     :erlang.nif_error(:nif_not_loaded)
   end
@@ -68,7 +72,7 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
-  def rcl_clock_init!() do
+  def rcl_clock_init!(_clock_type) do
     :erlang.nif_error(:nif_not_loaded)
   end
 
@@ -76,6 +80,22 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def rcl_clock_get_now!(_clock) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_enable_ros_time_override!(_clock) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_disable_ros_time_override!(_clock) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_set_ros_time_override!(_clock, _time) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   def rcl_timer_init!(_context, _clock, _period_ms) do
     :erlang.nif_error(:nif_not_loaded)
   end
@@ -92,6 +112,42 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def rcl_timer_exchange_period!(_timer, _period_ms) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_timer_reset!(_timer) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_timer_cancel!(_timer) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_timer_is_canceled!(_timer) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def timer_service_start!(_context) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def timer_service_stop!(_service) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def timer_service_add!(_service, _timer) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def timer_service_remove!(_service, _timer) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def timer_service_wake!(_service) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   def rcl_take!(_subscription, _message) do
     :erlang.nif_error(:nif_not_loaded)
   end
@@ -132,6 +188,54 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def rcl_guard_condition_init!(_context) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_guard_condition_fini!(_guard_condition) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_trigger_guard_condition!(_guard_condition) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def waiter_start!(_context, _entity, _guard_condition) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def waiter_arm!(_waiter) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def waiter_stop!(_waiter) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_publisher_event_init!(_publisher, _type) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_subscription_event_init!(_subscription, _type) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_event_fini!(_event) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_take_event!(_event) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_event_set_callback!(_event) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rcl_event_clear_callback!(_event) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   def rcl_service_init!(_node, _type_support, _service_name, _qos) do
     :erlang.nif_error(:nif_not_loaded)
   end
@@ -192,6 +296,10 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def rcl_get_graph_snapshot!(_node) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   def rcl_get_node_names!(_node) do
     :erlang.nif_error(:nif_not_loaded)
   end
@@ -264,6 +372,58 @@ defmodule Rclex.Nif do
     :erlang.nif_error(:nif_not_loaded)
   end
 
+  def pool_allocator_stats!() do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def memory_stats!() do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rmw_serialize!(_type_support, _message) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def rmw_deserialize!(_type_support, _message, _binary) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_plan!(_type_support) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_header_stamp_offset!(_type_support) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_create!(_plan) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_destroy!(_plan, _message) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_set!(_plan, _message, _data) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_get!(_plan, _message) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_get_map!(_plan, _message) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def introspection_get_field!(_plan, _message, _path) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
+  def dynamic_message_type_support!(_package, _interface_type, _type) do
+    :erlang.nif_error(:nif_not_loaded)
+  end
+
   @before_compile Rclex.MsgFuncs
   @before_compile Rclex.SrvFuncs
 end
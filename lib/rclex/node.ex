@@ -8,6 +8,8 @@ defmodule Rclex.Node do
   alias Rclex.Nif
   alias Rclex.EntitiesSupervisor, as: ES
   alias Rclex.Graph, as: Graph
+  alias Rclex.GraphCache
+  alias Rclex.GraphWatcher
 
   def start_link(args) do
     name = Keyword.fetch!(args, :name)
@@ -17,12 +19,17 @@ defmodule Rclex.Node do
   end
 
   def name(name, namespace \\ "/") do
-    {:global, {name, namespace}}
+    Rclex.Registry.via({name, namespace})
   end
 
-  def start_publisher(message_type, topic_name, name, namespace, qos) do
+  def use_sim_time(name, namespace \\ "/") do
     server = name(name, namespace)
-    GenServer.call(server, {:start_publisher, message_type, topic_name, qos})
+    GenServer.call(server, :use_sim_time)
+  end
+
+  def start_publisher(message_type, topic_name, name, namespace, opts) do
+    server = name(name, namespace)
+    GenServer.call(server, {:start_publisher, message_type, topic_name, opts})
   end
 
   def stop_publisher(message_type, topic_name, name, namespace \\ "/") do
@@ -30,9 +37,9 @@ defmodule Rclex.Node do
     GenServer.call(server, {:stop_publisher, message_type, topic_name})
   end
 
-  def start_subscription(callback, message_type, topic_name, name, namespace, qos) do
+  def start_subscription(callback, message_type, topic_name, name, namespace, opts) do
     server = name(name, namespace)
-    GenServer.call(server, {:start_subscription, callback, message_type, topic_name, qos})
+    GenServer.call(server, {:start_subscription, callback, message_type, topic_name, opts})
   end
 
   def stop_subscription(message_type, topic_name, name, namespace \\ "/") do
@@ -60,9 +67,9 @@ defmodule Rclex.Node do
     GenServer.call(server, {:stop_client, service_type, service_name})
   end
 
-  def start_timer(period_ms, callback, timer_name, name, namespace \\ "/") do
+  def start_timer(period_ms, callback, timer_name, name, namespace, opts) do
     server = name(name, namespace)
-    GenServer.call(server, {:start_timer, period_ms, callback, timer_name})
+    GenServer.call(server, {:start_timer, period_ms, callback, timer_name, opts})
   end
 
   def stop_timer(timer_name, name, namespace \\ "/") do
@@ -71,28 +78,42 @@ defmodule Rclex.Node do
   end
 
   def count_publishers(name, namespace, topic_name) do
-    server = name(name, namespace)
-    GenServer.call(server, {:count_publishers, topic_name})
+    query(name, namespace, {:count_publishers, topic_name}, fn node ->
+      Graph.count_publishers(node, ~c"#{topic_name}")
+    end)
   end
 
   def count_subscribers(name, namespace, topic_name) do
-    server = name(name, namespace)
-    GenServer.call(server, {:count_subscribers, topic_name})
+    query(name, namespace, {:count_subscribers, topic_name}, fn node ->
+      Graph.count_subscribers(node, ~c"#{topic_name}")
+    end)
   end
 
   def get_client_names_and_types_by_node(name, namespace, node_name, node_namespace) do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_client_names_and_types_by_node, node_name, node_namespace})
+    key = {:get_client_names_and_types_by_node, node_name, node_namespace}
+
+    query(name, namespace, key, fn node ->
+      Graph.get_client_names_and_types_by_node(node, ~c"#{node_name}", ~c"#{node_namespace}")
+      |> names_and_types_charlist_to_string()
+    end)
+  end
+
+  def get_graph_snapshot(name, namespace \\ "/") do
+    query(name, namespace, :get_graph_snapshot, &take_graph_snapshot/1)
   end
 
   def get_node_names(name, namespace \\ "/") do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_node_names})
+    query(name, namespace, :get_node_names, fn node ->
+      Graph.get_node_names(node)
+      |> Enum.map(&{"#{elem(&1, 0)}", "#{elem(&1, 1)}"})
+    end)
   end
 
   def get_node_names_with_enclaves(name, namespace \\ "/") do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_node_names_with_enclaves})
+    query(name, namespace, :get_node_names_with_enclaves, fn node ->
+      Graph.get_node_names_with_enclaves(node)
+      |> Enum.map(&{"#{elem(&1, 0)}", "#{elem(&1, 1)}", "#{elem(&1, 2)}"})
+    end)
   end
 
   def get_publisher_names_and_types_by_node(
@@ -102,12 +123,17 @@ defmodule Rclex.Node do
         node_namespace,
         no_demangle \\ false
       ) do
-    server = name(name, namespace)
+    key = {:get_publisher_names_and_types_by_node, node_name, node_namespace, no_demangle}
 
-    GenServer.call(
-      server,
-      {:get_publisher_names_and_types_by_node, node_name, node_namespace, no_demangle}
-    )
+    query(name, namespace, key, fn node ->
+      Graph.get_publisher_names_and_types_by_node(
+        node,
+        ~c"#{node_name}",
+        ~c"#{node_namespace}",
+        no_demangle
+      )
+      |> names_and_types_charlist_to_string()
+    end)
   end
 
   def get_publishers_info_by_topic(
@@ -116,22 +142,26 @@ defmodule Rclex.Node do
         topic_name,
         no_mangle \\ false
       ) do
-    server = name(name, namespace)
-
-    GenServer.call(
-      server,
-      {:get_publishers_info_by_topic, topic_name, no_mangle}
-    )
+    query(name, namespace, {:get_publishers_info_by_topic, topic_name, no_mangle}, fn node ->
+      Graph.get_publishers_info_by_topic(node, ~c"#{topic_name}", no_mangle)
+      |> topic_endpoint_info_list_charlist_to_string()
+    end)
   end
 
   def get_service_names_and_types(name, namespace) do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_service_names_and_types})
+    query(name, namespace, :get_service_names_and_types, fn node ->
+      Graph.get_service_names_and_types(node)
+      |> names_and_types_charlist_to_string()
+    end)
   end
 
   def get_service_names_and_types_by_node(name, namespace, node_name, node_namespace) do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_service_names_and_types_by_node, node_name, node_namespace})
+    key = {:get_service_names_and_types_by_node, node_name, node_namespace}
+
+    query(name, namespace, key, fn node ->
+      Graph.get_service_names_and_types_by_node(node, ~c"#{node_name}", ~c"#{node_namespace}")
+      |> names_and_types_charlist_to_string()
+    end)
   end
 
   def get_subscriber_names_and_types_by_node(
@@ -141,12 +171,17 @@ defmodule Rclex.Node do
         node_namespace,
         no_demangle \\ false
       ) do
-    server = name(name, namespace)
+    key = {:get_subscriber_names_and_types_by_node, node_name, node_namespace, no_demangle}
 
-    GenServer.call(
-      server,
-      {:get_subscriber_names_and_types_by_node, node_name, node_namespace, no_demangle}
-    )
+    query(name, namespace, key, fn node ->
+      Graph.get_subscriber_names_and_types_by_node(
+        node,
+        ~c"#{node_name}",
+        ~c"#{node_namespace}",
+        no_demangle
+      )
+      |> names_and_types_charlist_to_string()
+    end)
   end
 
   def get_subscribers_info_by_topic(
@@ -155,21 +190,67 @@ defmodule Rclex.Node do
         topic_name,
         no_mangle \\ false
       ) do
-    server = name(name, namespace)
-
-    GenServer.call(
-      server,
-      {:get_subscribers_info_by_topic, topic_name, no_mangle}
-    )
+    query(name, namespace, {:get_subscribers_info_by_topic, topic_name, no_mangle}, fn node ->
+      Graph.get_subscribers_info_by_topic(node, ~c"#{topic_name}", no_mangle)
+      |> topic_endpoint_info_list_charlist_to_string()
+    end)
   end
 
   def get_topic_names_and_types(name, namespace, no_demangle \\ false) do
-    server = name(name, namespace)
-    GenServer.call(server, {:get_topic_names_and_types, no_demangle})
+    query(name, namespace, {:get_topic_names_and_types, no_demangle}, fn node ->
+      Graph.get_topic_names_and_types(node, no_demangle)
+      |> names_and_types_charlist_to_string()
+    end)
+  end
+
+  def subscribe_graph_events(name, namespace \\ "/") do
+    GraphWatcher.subscribe_graph_events(name, namespace)
+  end
+
+  def unsubscribe_graph_events(name, namespace \\ "/") do
+    GraphWatcher.unsubscribe_graph_events(name, namespace)
+  end
+
+  def wait_for(kind, topic_name, count, timeout, name, namespace \\ "/") do
+    GraphWatcher.wait_for(kind, topic_name, count, timeout, name, namespace)
+  end
+
+  def graph_generation(name, namespace \\ "/") do
+    case Rclex.Registry.lookup_node_handle(name, namespace) do
+      {:ok, {_node, cache}} -> GraphCache.generation(cache)
+      {:error, :not_found} = error -> error
+    end
   end
 
   # helpers
 
+  # Graph queries run in the caller with the node handle, which the node process registers, so
+  # that polling the graph neither waits for nor holds up the start and stop of entities. Their
+  # results are cached until the graph changes, see Rclex.GraphCache. The handle is only
+  # registered locally, see Rclex.Registry.
+  defp query(name, namespace, key, query) do
+    case Rclex.Registry.lookup_node_handle(name, namespace) do
+      {:ok, {node, cache}} -> GraphCache.fetch(cache, key, fn -> query.(node) end)
+      {:error, :not_found} = error -> error
+    end
+  end
+
+  def take_graph_snapshot(node) do
+    %{nodes: nodes, topics: topics, services: services, endpoints: endpoints} =
+      Graph.get_graph_snapshot(node)
+
+    %{
+      nodes: Enum.map(nodes, fn {name, ns, enclave} -> {"#{name}", "#{ns}", "#{enclave}"} end),
+      topics: names_and_types_charlist_to_string(topics),
+      services: names_and_types_charlist_to_string(services),
+      endpoints:
+        for {topic_name, publishers, subscribers} <- endpoints,
+            info <- topic_endpoint_info_list_charlist_to_string(publishers ++ subscribers) do
+          Map.put(info, :topic_name, "#{topic_name}")
+        end
+    }
+  end
+
   defp names_and_types_charlist_to_string({:error, term}) do
     {:error, term}
   end
@@ -214,19 +295,46 @@ defmodule Rclex.Node do
     namespace = Keyword.fetch!(args, :namespace)
 
     node = Nif.rcl_node_init!(context, ~c"#{name}", ~c"#{namespace}")
+    cache = GraphCache.new()
+    {:ok, _owner} = Rclex.Registry.register_node_handle(name, namespace, {node, cache})
+
+    # sends {:graph_changed, 1} each time the graph guard condition of the node fires
+    guard_condition = Nif.rcl_guard_condition_init!(context)
+    graph_waiter = Nif.waiter_start!(context, node, guard_condition)
 
-    {:ok, %{context: context, node: node, name: name, namespace: namespace}}
+    {:ok,
+     %{
+       context: context,
+       node: node,
+       name: name,
+       namespace: namespace,
+       use_sim_time: false,
+       graph_cache: cache,
+       graph_waiter: {graph_waiter, guard_condition}
+     }}
   end
 
   def terminate(reason, state) do
+    if state.use_sim_time, do: Rclex.Clock.disable_sim_time!()
+    :ok = Rclex.Registry.unregister_node_handle(state.name, state.namespace)
+    {graph_waiter, guard_condition} = state.graph_waiter
+    :ok = Nif.waiter_stop!(graph_waiter)
+    :ok = Nif.rcl_guard_condition_fini!(guard_condition)
     Nif.rcl_node_fini!(state.node)
 
     Logger.debug("#{__MODULE__}: #{inspect(reason)} #{Path.join(state.namespace, state.name)}")
   end
 
-  def handle_call({:start_publisher, message_type, topic_name, qos}, _from, state) do
+  def handle_call({:start_publisher, message_type, topic_name, opts}, _from, state) do
     return =
-      ES.start_publisher(state.node, message_type, topic_name, state.name, state.namespace, qos)
+      ES.start_publisher(
+        state.node,
+        message_type,
+        topic_name,
+        state.name,
+        state.namespace,
+        [context: state.context] ++ opts
+      )
 
     {:reply, return, state}
   end
@@ -281,7 +389,11 @@ defmodule Rclex.Node do
     {:reply, return, state}
   end
 
-  def handle_call({:start_subscription, callback, message_type, topic_name, qos}, _from, state) do
+  def handle_call(
+        {:start_subscription, callback, message_type, topic_name, opts},
+        _from,
+        state
+      ) do
     return =
       ES.start_subscription(
         state.context,
@@ -291,7 +403,7 @@ defmodule Rclex.Node do
         topic_name,
         state.name,
         state.namespace,
-        qos
+        opts
       )
 
     {:reply, return, state}
@@ -303,156 +415,70 @@ defmodule Rclex.Node do
     {:reply, return, state}
   end
 
-  def handle_call({:start_timer, period_ms, callback, timer_name}, _from, state) do
-    return =
-      ES.start_timer(state.context, period_ms, callback, timer_name, state.name, state.namespace)
-
-    {:reply, return, state}
-  end
-
-  def handle_call({:stop_timer, timer_name}, _from, state) do
-    return = ES.stop_timer(timer_name, state.name, state.namespace)
-
-    {:reply, return, state}
+  # The ROS time follows the /clock topic from now on, it stays at 0 until the first message.
+  # Like rclcpp, the subscription keeps only the latest and best effort clock message.
+  def handle_call(:use_sim_time, _from, %{use_sim_time: true} = state) do
+    {:reply, :ok, state}
   end
 
-  def handle_call({:count_publishers, topic_name}, _from, state) do
-    return = Graph.count_publishers(state.node, ~c"#{topic_name}")
+  def handle_call(:use_sim_time, _from, state) do
+    me = self()
 
-    {:reply, return, state}
-  end
-
-  def handle_call({:count_subscribers, topic_name}, _from, state) do
-    return = Graph.count_subscribers(state.node, ~c"#{topic_name}")
-
-    {:reply, return, state}
-  end
-
-  def handle_call({:get_client_names_and_types_by_node, node_name, node_namespace}, _from, state) do
     return =
-      Graph.get_client_names_and_types_by_node(
-        state.node,
-        ~c"#{node_name}",
-        ~c"#{node_namespace}"
-      )
-      |> names_and_types_charlist_to_string()
-
-    {:reply, return, state}
-  end
-
-  def handle_call({:get_node_names}, _from, state) do
-    return =
-      Graph.get_node_names(state.node)
-      |> Enum.map(&{"#{elem(&1, 0)}", "#{elem(&1, 1)}"})
-
-    {:reply, return, state}
-  end
-
-  def handle_call({:get_node_names_with_enclaves}, _from, state) do
-    return =
-      Graph.get_node_names_with_enclaves(state.node)
-      |> Enum.map(&{"#{elem(&1, 0)}", "#{elem(&1, 1)}", "#{elem(&1, 2)}"})
-
-    {:reply, return, state}
-  end
-
-  def handle_call(
-        {:get_publisher_names_and_types_by_node, node_name, node_namespace, no_demangle},
-        _from,
-        state
-      ) do
-    return =
-      Graph.get_publisher_names_and_types_by_node(
-        state.node,
-        ~c"#{node_name}",
-        ~c"#{node_namespace}",
-        no_demangle
-      )
-      |> names_and_types_charlist_to_string()
-
-    {:reply, return, state}
-  end
-
-  def handle_call(
-        {:get_publishers_info_by_topic, topic_name, no_mangle},
-        _from,
-        state
-      ) do
-    return =
-      Graph.get_publishers_info_by_topic(
+      ES.start_subscription(
+        state.context,
         state.node,
-        ~c"#{topic_name}",
-        no_mangle
+        &send(me, {:clock, &1}),
+        "rosgraph_msgs/msg/Clock",
+        "/clock",
+        state.name,
+        state.namespace,
+        qos: %{Rclex.QoS.profile_sensor_data() | depth: 1}
       )
-      |> topic_endpoint_info_list_charlist_to_string()
 
-    {:reply, return, state}
-  end
-
-  def handle_call({:get_service_names_and_types}, _form, state) do
-    return =
-      Graph.get_service_names_and_types(state.node)
-      |> names_and_types_charlist_to_string()
-
-    {:reply, return, state}
-  end
-
-  def handle_call({:get_service_names_and_types_by_node, node_name, node_namespace}, _from, state) do
-    return =
-      Graph.get_service_names_and_types_by_node(
-        state.node,
-        ~c"#{node_name}",
-        ~c"#{node_namespace}"
-      )
-      |> names_and_types_charlist_to_string()
+    case return do
+      {:ok, _pid} ->
+        :ok = Rclex.Clock.enable_sim_time!()
+        {:reply, :ok, %{state | use_sim_time: true}}
 
-    {:reply, return, state}
+      {:error, reason} ->
+        {:reply, {:error, reason}, state}
+    end
   end
 
-  def handle_call(
-        {:get_subscriber_names_and_types_by_node, node_name, node_namespace, no_demangle},
-        _from,
-        state
-      ) do
+  def handle_call({:start_timer, period_ms, callback, timer_name, opts}, _from, state) do
     return =
-      Graph.get_subscriber_names_and_types_by_node(
-        state.node,
-        ~c"#{node_name}",
-        ~c"#{node_namespace}",
-        no_demangle
+      ES.start_timer(
+        state.context,
+        period_ms,
+        callback,
+        timer_name,
+        state.name,
+        state.namespace,
+        opts
       )
-      |> names_and_types_charlist_to_string()
 
     {:reply, return, state}
   end
 
-  def handle_call(
-        {:get_subscribers_info_by_topic, topic_name, no_mangle},
-        _from,
-        state
-      ) do
-    return =
-      Graph.get_subscribers_info_by_topic(
-        state.node,
-        ~c"#{topic_name}",
-        no_mangle
-      )
-      |> topic_endpoint_info_list_charlist_to_string()
+  def handle_call({:stop_timer, timer_name}, _from, state) do
+    return = ES.stop_timer(timer_name, state.name, state.namespace)
 
     {:reply, return, state}
   end
 
-  def handle_call({:get_topic_names_and_types, no_demangle}, _from, state) do
-    return =
-      Graph.get_topic_names_and_types(state.node, no_demangle)
-      |> names_and_types_charlist_to_string()
+  def handle_info({:graph_changed, _}, state) do
+    GraphCache.invalidate(state.graph_cache)
+    {graph_waiter, _guard_condition} = state.graph_waiter
+    :ok = Nif.waiter_arm!(graph_waiter)
+    :ok = GraphWatcher.graph_changed(state.name, state.namespace)
 
-    {:reply, return, state}
+    {:noreply, state}
   end
 
-  def handle_call({:service_server_is_available, client}, _from, state) do
-    return = Graph.service_server_is_available(state.node, client)
+  def handle_info({:clock, %{clock: %{sec: sec, nanosec: nanosec}}}, state) do
+    :ok = Rclex.Clock.set_ros_time!(sec * 1_000_000_000 + nanosec)
 
-    {:reply, return, state}
+    {:noreply, state}
   end
 end
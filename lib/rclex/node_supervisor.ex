@@ -5,6 +5,7 @@ defmodule Rclex.NodeSupervisor do
 
   alias Rclex.Node
   alias Rclex.EntitiesSupervisor
+  alias Rclex.GraphWatcher
 
   def start_link(args) do
     name = Keyword.fetch!(args, :name)
@@ -14,7 +15,7 @@ defmodule Rclex.NodeSupervisor do
   end
 
   def name(name, namespace \\ "/") do
-    {:global, {:supervisor, name, namespace}}
+    Rclex.Registry.via({:supervisor, name, namespace})
   end
 
   # callbacks
@@ -22,6 +23,7 @@ defmodule Rclex.NodeSupervisor do
   def init(args) do
     children = [
       {Node, args},
+      {GraphWatcher, args},
       {EntitiesSupervisor, args}
     ]
 
@@ -5,6 +5,7 @@ defmodule Rclex.Publisher do
 
   require Logger
 
+  alias Rclex.Events
   alias Rclex.Nif
 
   def start_link(args) do
@@ -17,7 +18,7 @@ defmodule Rclex.Publisher do
   end
 
   def name(message_type, topic_name, name, namespace \\ "/") do
-    {:global, {:publisher, message_type, topic_name, name, namespace}}
+    Rclex.Registry.via({:publisher, message_type, topic_name, name, namespace})
   end
 
   def publish(%message_type{} = message, topic_name, name, namespace \\ "/") do
@@ -33,28 +34,56 @@ defmodule Rclex.Publisher do
   def init(args) do
     Process.flag(:trap_exit, true)
 
+    context = Keyword.fetch!(args, :context)
     node = Keyword.fetch!(args, :node)
     message_type = Keyword.fetch!(args, :message_type)
     topic_name = Keyword.fetch!(args, :topic_name)
     name = Keyword.fetch!(args, :name)
     namespace = Keyword.fetch!(args, :namespace)
     qos = Keyword.get(args, :qos, Rclex.QoS.profile_default())
+    stamp = Keyword.get(args, :stamp, false)
+    events = Keyword.get(args, :events, [])
+    event_callback = Keyword.get(args, :event_callback)
+
+    if event_callback, do: 2 = :erlang.fun_info(event_callback)[:arity]
 
     type_support = apply(message_type, :type_support!, [])
+
+    stamp =
+      if stamp do
+        {Rclex.Clock.get!(stamp), Nif.introspection_header_stamp_offset!(type_support)}
+      else
+        false
+      end
+
     publisher = Nif.rcl_publisher_init!(node, type_support, ~c"#{topic_name}", qos)
 
+    events =
+      try do
+        Events.init!(context, {:publisher, publisher}, events)
+      rescue
+        error ->
+          Nif.rcl_publisher_fini!(publisher, node)
+          reraise error, __STACKTRACE__
+      end
+
     {:ok,
      %{
+       context: context,
        node: node,
        publisher: publisher,
+       stamp: stamp,
        message_type: message_type,
        topic_name: topic_name,
        name: name,
-       namespace: namespace
+       namespace: namespace,
+       events: events,
+       event_callback: event_callback
      }}
   end
 
   def terminate(reason, state) do
+    :ok = Events.fini!(state.events)
     Nif.rcl_publisher_fini!(state.publisher, state.node)
 
     Logger.debug("#{__MODULE__}: #{inspect(reason)} #{Path.join(state.namespace, state.name)}")
@@ -65,11 +94,26 @@ defmodule Rclex.Publisher do
 
     try do
       :ok = apply(message_type, :set!, [message, data])
-      :ok = Nif.rcl_publish!(state.publisher, message)
+      :ok = publish!(state, message)
     after
       :ok = apply(message_type, :destroy!, [message])
     end
 
     {:reply, :ok, state}
   end
+
+  defp publish!(%{stamp: false} = state, message) do
+    Nif.rcl_publish!(state.publisher, message)
+  end
+
+  defp publish!(%{stamp: {clock, offset}} = state, message) do
+    Nif.rcl_publish_with_stamp!(state.publisher, message, clock, offset)
+  end
+
+  def handle_info({:new_event, type, number_of_events}, state) when number_of_events > 0 do
+    metadata = %{topic_name: state.topic_name, name: state.name, namespace: state.namespace}
+    :ok = Events.handle(state.events, type, :publisher, metadata, state.event_callback)
+
+    {:noreply, state}
+  end
 end
@@ -0,0 +1,37 @@
+defmodule Rclex.Registry do
+  @moduledoc false
+
+  # Names of the node, supervisor and entity processes. They are registered in a local Registry
+  # by default, so that a lookup is an ETS read and a registration takes no lock. With
+  # `config :rclex, registry: :global` they are registered with :global instead, unique across
+  # the connected BEAM nodes, at the cost of cluster wide locks on every registration.
+
+  @mode Application.compile_env(:rclex, :registry, :local)
+
+  def child_spec(_args) do
+    Registry.child_spec(keys: :unique, name: __MODULE__, partitions: System.schedulers_online())
+  end
+
+  case @mode do
+    :local -> def via(key), do: {:via, Registry, {__MODULE__, key}}
+    :global -> def via(key), do: {:global, key}
+  end
+
+  # The node handles, registered by the node processes for the graph queries, are NIF resources
+  # which are only valid on the BEAM node that created them. They stay in the local Registry in
+  # both modes, so the graph queries are local-only, a node on another BEAM node is not found.
+  def register_node_handle(name, namespace, value) do
+    Registry.register(__MODULE__, {:node, name, namespace}, value)
+  end
+
+  def unregister_node_handle(name, namespace) do
+    Registry.unregister(__MODULE__, {:node, name, namespace})
+  end
+
+  def lookup_node_handle(name, namespace) do
+    case Registry.lookup(__MODULE__, {:node, name, namespace}) do
+      [{_pid, value}] -> {:ok, value}
+      [] -> {:error, :not_found}
+    end
+  end
+end
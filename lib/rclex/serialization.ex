@@ -0,0 +1,33 @@
+defmodule Rclex.Serialization do
+  @moduledoc false
+
+  # Runtime for the `serialize!/1` and `deserialize!/1` of the modules generated by
+  # `mix rclex.gen.msgs`.
+  #
+  # The message is (de)serialized by the rmw implementation in use, so the binary is the CDR
+  # payload including its encapsulation header as it goes over the wire, without a publisher.
+
+  alias Rclex.Nif
+
+  def serialize!(module, struct) do
+    message = module.create!()
+
+    try do
+      :ok = module.set!(message, struct)
+      Nif.rmw_serialize!(module.type_support!(), message)
+    after
+      :ok = module.destroy!(message)
+    end
+  end
+
+  def deserialize!(module, binary) when is_binary(binary) do
+    message = module.create!()
+
+    try do
+      :ok = Nif.rmw_deserialize!(module.type_support!(), message, binary)
+      module.get!(message)
+    after
+      :ok = module.destroy!(message)
+    end
+  end
+end
@@ -17,7 +17,7 @@ defmodule Rclex.Service do
   end
 
   def name(service_type, service_name, name, namespace \\ "/") do
-    {:global, {:service, service_type, service_name, name, namespace}}
+    Rclex.Registry.via({:service, service_type, service_name, name, namespace})
   end
 
   # callbacks
@@ -57,8 +57,12 @@ defmodule Rclex.Service do
 
   case System.fetch_env!("ROS_DISTRO") do
     "foxy" ->
+      # there is no on new request callback, a waiter thread waits for requests instead and sends
+      # the same {:new_request, 1}, it is armed again once they are taken
       def terminate(reason, state) do
-        Nif.rcl_wait_set_fini!(state.callback_resource)
+        {waiter, guard_condition} = state.callback_resource
+        Nif.waiter_stop!(waiter)
+        Nif.rcl_guard_condition_fini!(guard_condition)
         Nif.rcl_service_fini!(state.service, state.node)
 
         Logger.debug(
@@ -67,55 +71,12 @@ defmodule Rclex.Service do
       end
 
       def handle_continue(nil, %{context: context} = state) do
-        send(self(), :take_request)
-        callback_resource = Nif.rcl_wait_set_init_service!(context)
-        {:noreply, %{state | callback_resource: callback_resource}}
+        guard_condition = Nif.rcl_guard_condition_init!(context)
+        waiter = Nif.waiter_start!(context, state.service, guard_condition)
+        {:noreply, %{state | callback_resource: {waiter, guard_condition}}}
       end
 
-      def handle_info(:take_request, state) do
-        case Nif.rcl_wait_service!(state.callback_resource, 1000, state.service) do
-          :ok ->
-            request_message = apply(state.request_type, :create!, [])
-
-            try do
-              case Nif.rcl_take_request_with_info!(state.service, request_message) do
-                {:ok, request_header} ->
-                  request_message_struct = apply(state.request_type, :get!, [request_message])
-
-                  {:ok, _pid} =
-                    Task.Supervisor.start_child(
-                      {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                      fn ->
-                        response_message_struct = state.callback.(request_message_struct)
-                        response_message = apply(state.response_type, :create!, [])
-
-                        apply(state.response_type, :set!, [
-                          response_message,
-                          response_message_struct
-                        ])
-
-                        :ok =
-                          Nif.rcl_send_response!(state.service, request_header, response_message)
-                      end
-                    )
-
-                :service_take_failed ->
-                  Logger.debug(
-                    "#{__MODULE__}: take failed but no error occurred in the middleware"
-                  )
-              end
-            after
-              :ok = apply(state.request_type, :destroy!, [request_message])
-            end
-
-          :timeout ->
-            nil
-        end
-
-        send(self(), :take_request)
-
-        {:noreply, state}
-      end
+      defp rearm(%{callback_resource: {waiter, _guard_condition}}), do: Nif.waiter_arm!(waiter)
 
     _ ->
       def terminate(
@@ -135,49 +96,53 @@ defmodule Rclex.Service do
         {:noreply, %{state | callback_resource: callback_resource}}
       end
 
-      def handle_info(
-            {:new_request, number_of_events},
-            %{
-              service: service,
-              request_type: request_type,
-              response_type: response_type,
-              callback: callback
-            } = state
-          )
-          when number_of_events > 0 do
-        for _ <- 1..number_of_events do
-          request_message = apply(request_type, :create!, [])
-
-          try do
-            case Nif.rcl_take_request_with_info!(service, request_message) do
-              {:ok, request_header} ->
-                request_message_struct = apply(request_type, :get!, [request_message])
-
-                {:ok, _pid} =
-                  Task.Supervisor.start_child(
-                    {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                    fn ->
-                      response_message_struct = callback.(request_message_struct)
-                      response_message = apply(response_type, :create!, [])
-
-                      apply(response_type, :set!, [
-                        response_message,
-                        response_message_struct
-                      ])
-
-                      :ok = Nif.rcl_send_response!(service, request_header, response_message)
-                    end
-                  )
-
-              :service_take_failed ->
-                Logger.debug("#{__MODULE__}: take failed but no error occurred in the middleware")
-            end
-          after
-            :ok = apply(request_type, :destroy!, [request_message])
-          end
-        end
+      defp rearm(_state), do: :ok
+  end
 
-        {:noreply, state}
+  def handle_info(
+        {:new_request, number_of_events},
+        %{
+          service: service,
+          request_type: request_type,
+          response_type: response_type,
+          callback: callback
+        } = state
+      )
+      when number_of_events > 0 do
+    for _ <- 1..number_of_events do
+      request_message = apply(request_type, :create!, [])
+
+      try do
+        case Nif.rcl_take_request_with_info!(service, request_message) do
+          {:ok, request_header} ->
+            request_message_struct = apply(request_type, :get!, [request_message])
+
+            {:ok, _pid} =
+              Task.Supervisor.start_child(
+                {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
+                fn ->
+                  response_message_struct = callback.(request_message_struct)
+                  response_message = apply(response_type, :create!, [])
+
+                  apply(response_type, :set!, [
+                    response_message,
+                    response_message_struct
+                  ])
+
+                  :ok = Nif.rcl_send_response!(service, request_header, response_message)
+                end
+              )
+
+          :service_take_failed ->
+            Logger.debug("#{__MODULE__}: take failed but no error occurred in the middleware")
+        end
+      after
+        :ok = apply(request_type, :destroy!, [request_message])
       end
+    end
+
+    :ok = rearm(state)
+
+    {:noreply, state}
   end
 end
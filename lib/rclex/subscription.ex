@@ -5,6 +5,8 @@ defmodule Rclex.Subscription do
 
   require Logger
 
+  alias Rclex.Events
+  alias Rclex.Introspection
   alias Rclex.Nif
 
   def start_link(args) do
@@ -17,7 +19,7 @@ defmodule Rclex.Subscription do
   end
 
   def name(message_type, topic_name, name, namespace \\ "/") do
-    {:global, {:subscription, message_type, topic_name, name, namespace}}
+    Rclex.Registry.via({:subscription, message_type, topic_name, name, namespace})
   end
 
   # callbacks
@@ -33,12 +35,25 @@ defmodule Rclex.Subscription do
     name = Keyword.fetch!(args, :name)
     namespace = Keyword.fetch!(args, :namespace)
     qos = Keyword.get(args, :qos, Rclex.QoS.profile_default())
+    lazy = Keyword.get(args, :lazy, false)
+    events = Keyword.get(args, :events, [])
+    event_callback = Keyword.get(args, :event_callback)
 
     1 = :erlang.fun_info(callback)[:arity]
+    if event_callback, do: 2 = :erlang.fun_info(event_callback)[:arity]
 
-    type_support = apply(message_type, :type_support!, [])
+    type_support = Introspection.type_support!(message_type)
     subscription = Nif.rcl_subscription_init!(node, type_support, ~c"#{topic_name}", qos)
 
+    events =
+      try do
+        Events.init!(context, {:subscription, subscription}, events)
+      rescue
+        error ->
+          Nif.rcl_subscription_fini!(subscription, node)
+          reraise error, __STACKTRACE__
+      end
+
     {:ok,
      %{
        context: context,
@@ -49,14 +64,22 @@ defmodule Rclex.Subscription do
        name: name,
        namespace: namespace,
        subscription: subscription,
-       callback_resource: nil
+       lazy: lazy,
+       callback_resource: nil,
+       events: events,
+       event_callback: event_callback
      }, {:continue, nil}}
   end
 
   case System.fetch_env!("ROS_DISTRO") do
     "foxy" ->
+      # there is no on new message callback, a waiter thread waits for messages instead and sends
+      # the same {:new_message, 1}, it is armed again once they are taken
       def terminate(reason, state) do
-        Nif.rcl_wait_set_fini!(state.callback_resource)
+        {waiter, guard_condition} = state.callback_resource
+        Nif.waiter_stop!(waiter)
+        Nif.rcl_guard_condition_fini!(guard_condition)
+        :ok = Events.fini!(state.events)
         Nif.rcl_subscription_fini!(state.subscription, state.node)
 
         Logger.debug(
@@ -65,48 +88,17 @@ defmodule Rclex.Subscription do
       end
 
       def handle_continue(nil, state) do
-        send(self(), :take)
-        callback_resource = Nif.rcl_wait_set_init_subscription!(state.context)
-        {:noreply, %{state | callback_resource: callback_resource}}
+        guard_condition = Nif.rcl_guard_condition_init!(state.context)
+        waiter = Nif.waiter_start!(state.context, state.subscription, guard_condition)
+        {:noreply, %{state | callback_resource: {waiter, guard_condition}}}
       end
 
-      def handle_info(:take, state) do
-        case Nif.rcl_wait_subscription!(state.callback_resource, 1000, state.subscription) do
-          :ok ->
-            message = apply(state.message_type, :create!, [])
-
-            try do
-              case Nif.rcl_take!(state.subscription, message) do
-                :ok ->
-                  message_struct = apply(state.message_type, :get!, [message])
-
-                  {:ok, _pid} =
-                    Task.Supervisor.start_child(
-                      {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                      fn -> state.callback.(message_struct) end
-                    )
-
-                :subscription_take_failed ->
-                  Logger.debug(
-                    "#{__MODULE__}: take failed but no error occurred in the middleware"
-                  )
-              end
-            after
-              :ok = apply(state.message_type, :destroy!, [message])
-            end
-
-          :timeout ->
-            nil
-        end
-
-        send(self(), :take)
-
-        {:noreply, state}
-      end
+      defp rearm(%{callback_resource: {waiter, _guard_condition}}), do: Nif.waiter_arm!(waiter)
 
     _ ->
       def terminate(reason, state) do
         Nif.rcl_subscription_clear_message_callback!(state.subscription, state.callback_resource)
+        :ok = Events.fini!(state.events)
         Nif.rcl_subscription_fini!(state.subscription, state.node)
 
         Logger.debug(
@@ -119,30 +111,87 @@ defmodule Rclex.Subscription do
         {:noreply, %{state | callback_resource: callback_resource}}
       end
 
-      def handle_info({:new_message, number_of_events}, state) when number_of_events > 0 do
-        for _ <- 1..number_of_events do
-          message = apply(state.message_type, :create!, [])
-
-          try do
-            case Nif.rcl_take!(state.subscription, message) do
-              :ok ->
-                message_struct = apply(state.message_type, :get!, [message])
-
-                {:ok, _pid} =
-                  Task.Supervisor.start_child(
-                    {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-                    fn -> state.callback.(message_struct) end
-                  )
-
-              :subscription_take_failed ->
-                Logger.debug("#{__MODULE__}: take failed but no error occurred in the middleware")
-            end
-          after
-            :ok = apply(state.message_type, :destroy!, [message])
-          end
-        end
-
-        {:noreply, state}
+      defp rearm(_state), do: :ok
+  end
+
+  def handle_info({:new_message, number_of_events}, state) when number_of_events > 0 do
+    for _ <- 1..number_of_events do
+      take(state)
+    end
+
+    :ok = rearm(state)
+
+    {:noreply, state}
+  end
+
+  def handle_info({:new_event, type, number_of_events}, state) when number_of_events > 0 do
+    metadata = %{topic_name: state.topic_name, name: state.name, namespace: state.namespace}
+    :ok = Events.handle(state.events, type, :subscription, metadata, state.event_callback)
+
+    {:noreply, state}
+  end
+
+  defp take(state) do
+    message = create!(state.message_type)
+
+    result =
+      try do
+        Nif.rcl_take!(state.subscription, message)
+      rescue
+        error ->
+          :ok = destroy!(state.message_type, message)
+          reraise error, __STACKTRACE__
+      end
+
+    case result do
+      :ok ->
+        dispatch(state, message)
+
+      :subscription_take_failed ->
+        :ok = destroy!(state.message_type, message)
+        Logger.debug("#{__MODULE__}: take failed but no error occurred in the middleware")
+    end
+  end
+
+  # In lazy mode the callback owns the message handle until it returns, so the handle is
+  # destroyed by the task instead of here.
+  defp dispatch(%{lazy: true} = state, message) do
+    start_callback(fn ->
+      try do
+        state.callback.(message)
+      after
+        :ok = destroy!(state.message_type, message)
+      end
+    end)
+  end
+
+  defp dispatch(state, message) do
+    message_struct =
+      try do
+        get!(state.message_type, message)
+      after
+        :ok = destroy!(state.message_type, message)
       end
+
+    start_callback(fn -> state.callback.(message_struct) end)
+  end
+
+  # Message types given as a type string have no generated module and are converted by the
+  # introspection converter, to maps.
+  defp create!(type) when is_binary(type), do: Introspection.create!(type)
+  defp create!(type), do: type.create!()
+
+  defp destroy!(type, message) when is_binary(type), do: Introspection.destroy!(type, message)
+  defp destroy!(type, message), do: type.destroy!(message)
+
+  defp get!(type, message) when is_binary(type), do: Introspection.get_map!(type, message)
+  defp get!(type, message), do: type.get!(message)
+
+  defp start_callback(fun) do
+    {:ok, _pid} =
+      Task.Supervisor.start_child(
+        {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
+        fun
+      )
   end
 end
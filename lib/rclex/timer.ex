@@ -16,7 +16,31 @@ defmodule Rclex.Timer do
   end
 
   def name(timer_name, name, namespace \\ "/") do
-    {:global, {:timer, timer_name, name, namespace}}
+    Rclex.Registry.via({:timer, timer_name, name, namespace})
+  end
+
+  def stats(timer_name, name, namespace \\ "/") do
+    call(timer_name, name, namespace, :stats)
+  end
+
+  def reset(timer_name, name, namespace \\ "/") do
+    call(timer_name, name, namespace, :reset)
+  end
+
+  def change_period(period_ms, timer_name, name, namespace \\ "/") do
+    call(timer_name, name, namespace, {:change_period, period_ms})
+  end
+
+  def cancel(timer_name, name, namespace \\ "/") do
+    call(timer_name, name, namespace, :cancel)
+  end
+
+  defp call(timer_name, name, namespace, request) do
+    case GenServer.whereis(name(timer_name, name, namespace)) do
+      nil -> {:error, :not_found}
+      {_atom, _node} -> raise("should not happen")
+      pid -> GenServer.call(pid, request)
+    end
   end
 
   # callbacks
@@ -28,53 +52,172 @@ defmodule Rclex.Timer do
     callback = Keyword.fetch!(args, :callback)
     name = Keyword.fetch!(args, :name)
     namespace = Keyword.fetch!(args, :namespace)
+    overrun = Keyword.get(args, :overrun, :concurrent)
+    clock_type = Keyword.get(args, :clock, :steady)
+    one_shot = Keyword.get(args, :one_shot, false)
 
     0 = :erlang.fun_info(callback)[:arity]
+    true = overrun in [:concurrent, :skip_if_busy]
 
-    clock = Nif.rcl_clock_init!()
-    timer = Nif.rcl_timer_init!(context, clock, period_ms)
-    wait_set = Nif.rcl_wait_set_init_timer!(context)
+    # the ROS clock is shared so that the timer follows its overrides, e.g. by use_sim_time
+    clock =
+      case clock_type do
+        :steady -> Nif.rcl_clock_init!(:steady)
+        :ros -> Rclex.Clock.get!(:ros)
+      end
 
-    send(self(), :tick)
+    timer = Nif.rcl_timer_init!(context, clock, period_ms)
+    service = Rclex.TimerService.get()
+    :ok = Nif.timer_service_add!(service, timer)
 
     {:ok,
      %{
        callback: callback,
+       period_ns: period_ms * 1_000_000,
+       overrun: overrun,
+       one_shot: one_shot,
+       canceled: false,
+       running: MapSet.new(),
+       stats: %{
+         ticks: 0,
+         missed: 0,
+         skipped: 0,
+         period_histogram: %{},
+         jitter_max: 0,
+         jitter_sum: 0,
+         callback_count: 0,
+         callback_max: 0,
+         callback_sum: 0
+       },
        name: name,
        namespace: namespace,
+       clock_type: clock_type,
        clock: clock,
        timer: timer,
-       wait_set: wait_set
+       service: service
      }}
   end
 
   def terminate(reason, state) do
-    Nif.rcl_wait_set_fini!(state.wait_set)
+    Nif.timer_service_remove!(state.service, state.timer)
     Nif.rcl_timer_fini!(state.timer)
-    Nif.rcl_clock_fini!(state.clock)
+    if state.clock_type == :steady, do: Nif.rcl_clock_fini!(state.clock)
 
     Logger.debug("#{__MODULE__}: #{inspect(reason)} #{Path.join(state.namespace, state.name)}")
   end
 
-  def handle_info(:tick, state) do
-    case Nif.rcl_wait_timer!(state.wait_set, 1000, state.timer) do
-      :ok ->
-        if Nif.rcl_timer_is_ready!(state.timer) do
-          {:ok, _pid} =
-            Task.Supervisor.start_child(
-              {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
-              fn -> state.callback.() end
-            )
+  def handle_call(:stats, _from, state) do
+    %{stats: stats} = state
+
+    reply = %{
+      ticks: stats.ticks,
+      missed: stats.missed,
+      skipped: stats.skipped,
+      period_histogram: stats.period_histogram,
+      jitter: %{max: stats.jitter_max, mean: mean(stats.jitter_sum, stats.ticks)},
+      callback: %{
+        count: stats.callback_count,
+        max: stats.callback_max,
+        mean: mean(stats.callback_sum, stats.callback_count)
+      }
+    }
+
+    {:reply, reply, state}
+  end
 
-          :ok = Nif.rcl_timer_call!(state.timer)
-        end
+  # The timer service waits with the schedule of its timers at the time, it has to be woken to
+  # wait for a reset or changed timer. A canceled timer is just not ready when the wait ends.
+  def handle_call(:reset, _from, state) do
+    :ok = Nif.rcl_timer_reset!(state.timer)
+    :ok = Nif.timer_service_wake!(state.service)
 
-      :timeout ->
-        nil
-    end
+    {:reply, :ok, %{state | canceled: false}}
+  end
 
-    send(self(), :tick)
+  def handle_call({:change_period, period_ms}, _from, state) do
+    _old_period_ms = Nif.rcl_timer_exchange_period!(state.timer, period_ms)
+    :ok = Nif.timer_service_wake!(state.service)
 
+    {:reply, :ok, %{state | period_ns: period_ms * 1_000_000}}
+  end
+
+  def handle_call(:cancel, _from, state) do
+    :ok = Nif.rcl_timer_cancel!(state.timer)
+
+    {:reply, :ok, %{state | canceled: true}}
+  end
+
+  # sent by the timer service once the timer is due, it has already been called. since_last_call
+  # is the actual period and lateness how far the call is behind the schedule, whole periods of
+  # which were missed, the schedule itself stays in phase. Ticks sent before the timer was
+  # canceled are dropped.
+  def handle_info({:tick, _since_last_call, _lateness}, %{canceled: true} = state) do
     {:noreply, state}
   end
+
+  def handle_info({:tick, since_last_call, lateness}, state) do
+    missed = if state.period_ns > 0, do: div(lateness, state.period_ns), else: 0
+    bucket = bucket(since_last_call)
+
+    stats =
+      state.stats
+      |> Map.update!(:ticks, &(&1 + 1))
+      |> Map.update!(:missed, &(&1 + missed))
+      |> Map.update!(:period_histogram, &Map.update(&1, bucket, 1, fn count -> count + 1 end))
+      |> Map.update!(:jitter_max, &max(&1, lateness))
+      |> Map.update!(:jitter_sum, &(&1 + lateness))
+
+    state = %{state | stats: stats}
+
+    state =
+      if state.one_shot do
+        :ok = Nif.rcl_timer_cancel!(state.timer)
+        %{state | canceled: true}
+      else
+        state
+      end
+
+    if state.overrun == :skip_if_busy and MapSet.size(state.running) > 0 do
+      {:noreply, update_in(state.stats.skipped, &(&1 + 1))}
+    else
+      callback = state.callback
+
+      %Task{ref: ref} =
+        Task.Supervisor.async_nolink(
+          {:via, PartitionSupervisor, {Rclex.TaskSupervisors, self()}},
+          fn ->
+            started = System.monotonic_time(:nanosecond)
+            callback.()
+            System.monotonic_time(:nanosecond) - started
+          end
+        )
+
+      {:noreply, %{state | running: MapSet.put(state.running, ref)}}
+    end
+  end
+
+  def handle_info({ref, duration}, state) when is_reference(ref) do
+    Process.demonitor(ref, [:flush])
+
+    stats =
+      state.stats
+      |> Map.update!(:callback_count, &(&1 + 1))
+      |> Map.update!(:callback_max, &max(&1, duration))
+      |> Map.update!(:callback_sum, &(&1 + duration))
+
+    {:noreply, %{state | running: MapSet.delete(state.running, ref), stats: stats}}
+  end
+
+  # the callback crashed, which has been logged by its task
+  def handle_info({:DOWN, ref, :process, _pid, _reason}, state) do
+    {:noreply, %{state | running: MapSet.delete(state.running, ref)}}
+  end
+
+  # upper bound in microseconds of the power of two bucket of a period in nanoseconds
+  defp bucket(ns), do: bucket(div(ns + 999, 1000), 1)
+  defp bucket(us, bound) when us <= bound, do: bound
+  defp bucket(us, bound), do: bucket(us, bound * 2)
+
+  defp mean(_sum, 0), do: 0
+  defp mean(sum, count), do: div(sum, count)
 end
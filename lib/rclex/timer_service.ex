@@ -0,0 +1,40 @@
+defmodule Rclex.TimerService do
+  @moduledoc false
+
+  use GenServer
+
+  require Logger
+
+  alias Rclex.Nif
+
+  # Owns the native thread which waits on all the timers of the context at once and sends
+  # `:tick` to the `Rclex.Timer` of each timer that is due.
+
+  def start_link(args) do
+    GenServer.start_link(__MODULE__, args, name: __MODULE__)
+  end
+
+  def get() do
+    GenServer.call(__MODULE__, :get)
+  end
+
+  # callbacks
+
+  def init(_args) do
+    Process.flag(:trap_exit, true)
+
+    service = Nif.timer_service_start!(Rclex.Context.get())
+
+    {:ok, %{service: service}}
+  end
+
+  def terminate(reason, state) do
+    Nif.timer_service_stop!(state.service)
+
+    Logger.debug("#{__MODULE__}: #{inspect(reason)}")
+  end
+
+  def handle_call(:get, _from, state) do
+    {:reply, state.service, state}
+  end
+end
@@ -0,0 +1,41 @@
+defmodule Rclex.TypeSupport do
+  @moduledoc false
+
+  # Registry of the message type supports which are resolved at runtime.
+  #
+  # The type support of a type string like "std_msgs/msg/String" is looked up in the
+  # rosidl_typesupport_c library of its package, which is loaded on the first lookup of one of
+  # its types. Type supports are cached in :persistent_term, so each one is only resolved once
+  # and only the packages which are actually used get mapped.
+
+  alias Rclex.Nif
+
+  def fetch!(message_type) when is_binary(message_type) do
+    key = {__MODULE__, message_type}
+
+    case :persistent_term.get(key, nil) do
+      nil ->
+        [package, interface_type, type] = split_type!(message_type)
+
+        type_support =
+          Nif.dynamic_message_type_support!(~c"#{package}", ~c"#{interface_type}", ~c"#{type}")
+
+        :persistent_term.put(key, type_support)
+        type_support
+
+      type_support ->
+        type_support
+    end
+  end
+
+  def loaded() do
+    for {{__MODULE__, message_type}, _type_support} <- :persistent_term.get(), do: message_type
+  end
+
+  defp split_type!(message_type) do
+    case String.split(message_type, "/") do
+      [_package, interface_type, _type] = parts when interface_type in ["msg", "srv"] -> parts
+      _ -> raise ArgumentError, "invalid message type #{inspect(message_type)}"
+    end
+  end
+end
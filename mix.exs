@@ -85,6 +85,7 @@ defmodule Rclex.MixProject do
       groups_for_docs: [
         Client: &(&1[:section] == :client),
         Graph: &(&1[:section] == :graph),
+        Memory: &(&1[:section] == :memory),
         Node: &(&1[:section] == :node),
         Publisher: &(&1[:section] == :publisher),
         Service: &(&1[:section] == :service),
@@ -0,0 +1,40 @@
+alias Rclex.Pkgs.StdMsgs
+
+layout = %StdMsgs.Msg.MultiArrayLayout{
+  dim: [%StdMsgs.Msg.MultiArrayDimension{label: "data", size: 0, stride: 0}],
+  data_offset: 0
+}
+
+Benchee.run(
+  %{
+    "NIF set!/2 + get!/1" => fn struct ->
+      message = StdMsgs.Msg.UInt32MultiArray.create!()
+
+      try do
+        :ok = StdMsgs.Msg.UInt32MultiArray.set!(message, struct)
+        StdMsgs.Msg.UInt32MultiArray.get!(message)
+      after
+        :ok = StdMsgs.Msg.UInt32MultiArray.destroy!(message)
+      end
+    end,
+    "CDR encode_cdr/1 + decode_cdr/1" => fn struct ->
+      struct
+      |> StdMsgs.Msg.UInt32MultiArray.encode_cdr()
+      |> StdMsgs.Msg.UInt32MultiArray.decode_cdr()
+    end,
+    "rmw serialize!/1 + deserialize!/1" => fn struct ->
+      struct
+      |> StdMsgs.Msg.UInt32MultiArray.serialize!()
+      |> StdMsgs.Msg.UInt32MultiArray.deserialize!()
+    end
+  },
+  inputs: %{
+    "16 elements" => %StdMsgs.Msg.UInt32MultiArray{layout: layout, data: Enum.to_list(1..16)},
+    "1024 elements" => %StdMsgs.Msg.UInt32MultiArray{layout: layout, data: Enum.to_list(1..1024)},
+    "65536 elements" => %StdMsgs.Msg.UInt32MultiArray{
+      layout: layout,
+      data: Enum.to_list(1..65536)
+    }
+  },
+  time: 1
+)
@@ -0,0 +1,49 @@
+# set!/get! of UInt32MultiArray payloads with the generated per-type converter and the
+# introspection converter. Generate the std_msgs types with the default
+# `message_converter: :generated`, then run `mix run scripts/introspection_benchee.exs`.
+alias Rclex.Introspection
+alias Rclex.Pkgs.StdMsgs
+
+layout = %StdMsgs.Msg.MultiArrayLayout{
+  dim: [%StdMsgs.Msg.MultiArrayDimension{label: "data", size: 0, stride: 0}],
+  data_offset: 0
+}
+
+# Message types generated with `message_converter: :introspection` already delegate to
+# Rclex.Introspection, in which case both jobs measure the same converter.
+Benchee.run(
+  %{
+    "generated set!/2 + get!/1" => fn struct ->
+      message = StdMsgs.Msg.UInt32MultiArray.create!()
+
+      try do
+        :ok = StdMsgs.Msg.UInt32MultiArray.set!(message, struct)
+        StdMsgs.Msg.UInt32MultiArray.get!(message)
+      after
+        :ok = StdMsgs.Msg.UInt32MultiArray.destroy!(message)
+      end
+    end,
+    "introspection set!/3 + get!/2" => fn struct ->
+      message = Introspection.create!(StdMsgs.Msg.UInt32MultiArray)
+
+      try do
+        tuple = StdMsgs.Msg.UInt32MultiArray.to_tuple(struct)
+        :ok = Introspection.set!(StdMsgs.Msg.UInt32MultiArray, message, tuple)
+
+        Introspection.get!(StdMsgs.Msg.UInt32MultiArray, message)
+        |> StdMsgs.Msg.UInt32MultiArray.to_struct()
+      after
+        :ok = Introspection.destroy!(StdMsgs.Msg.UInt32MultiArray, message)
+      end
+    end
+  },
+  inputs: %{
+    "16 elements" => %StdMsgs.Msg.UInt32MultiArray{layout: layout, data: Enum.to_list(1..16)},
+    "1024 elements" => %StdMsgs.Msg.UInt32MultiArray{layout: layout, data: Enum.to_list(1..1024)},
+    "65536 elements" => %StdMsgs.Msg.UInt32MultiArray{
+      layout: layout,
+      data: Enum.to_list(1..65536)
+    }
+  },
+  time: 1
+)
@@ -0,0 +1,29 @@
+# Registration and lookup of 10_000 names in the two modes of Rclex.Registry. Both name
+# schemes are used directly, so the comparison doesn't depend on the configured `:registry`.
+entities = 10_000
+
+start_all = fn name ->
+  for i <- 1..entities do
+    {:ok, pid} = Agent.start(fn -> nil end, name: name.(i))
+    pid
+  end
+end
+
+stop_all = fn pids -> Enum.each(pids, &Agent.stop/1) end
+
+Benchee.run(
+  %{
+    "register #{entities}" => {fn name -> start_all.(name) end, after_each: stop_all},
+    "lookup #{entities}" =>
+      {fn {name, _pids} ->
+         for i <- 1..entities, do: true = is_pid(GenServer.whereis(name.(i)))
+       end,
+       before_scenario: fn name -> {name, start_all.(name)} end,
+       after_scenario: fn {_name, pids} -> stop_all.(pids) end}
+  },
+  inputs: %{
+    ":local" => &{:via, Registry, {Rclex.Registry, {:registry_benchee, &1}}},
+    ":global" => &{:global, {:registry_benchee, &1}}
+  },
+  time: 1
+)
@@ -1,46 +1,483 @@
 #include "allocator.h"
+#include "macros.h"
 #include <erl_nif.h>
 #include <rcutils/allocator.h>
 #include <rcutils/macros.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
+// Every allocator counts its bytes and allocations, live and since the load, in the counters of
+// a subsystem given as its state, so that what rclex holds natively can be told apart by what it
+// is used for. The counters are atomic, they are updated by the allocating threads, schedulers
+// and native threads alike, without a lock.
+
+typedef struct {
+  _Atomic ErlNifUInt64 live_bytes;
+  _Atomic ErlNifUInt64 live_allocations;
+  _Atomic ErlNifUInt64 total_bytes;
+  _Atomic ErlNifUInt64 total_allocations;
+} memory_counters_t;
+
+static memory_counters_t memory_counters[MEMORY_SUBSYSTEMS];
+
+static void count_allocation(memory_counters_t *counters_p, size_t size) {
+  atomic_fetch_add_explicit(&counters_p->live_bytes, size, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters_p->live_allocations, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters_p->total_bytes, size, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters_p->total_allocations, 1, memory_order_relaxed);
+}
+
+static void count_deallocation(memory_counters_t *counters_p, size_t size) {
+  atomic_fetch_sub_explicit(&counters_p->live_bytes, size, memory_order_relaxed);
+  atomic_fetch_sub_explicit(&counters_p->live_allocations, 1, memory_order_relaxed);
+}
+
+// a reallocation is not another allocation, only its growth is counted
+static void count_reallocation(memory_counters_t *counters_p, size_t old_size, size_t size) {
+  if (size >= old_size) {
+    atomic_fetch_add_explicit(&counters_p->live_bytes, size - old_size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters_p->total_bytes, size - old_size, memory_order_relaxed);
+  } else {
+    atomic_fetch_sub_explicit(&counters_p->live_bytes, old_size - size, memory_order_relaxed);
+  }
+}
+
+void account_allocation(memory_subsystem_t subsystem, size_t size) {
+  count_allocation(&memory_counters[subsystem], size);
+}
+
+void account_deallocation(memory_subsystem_t subsystem, size_t size) {
+  count_deallocation(&memory_counters[subsystem], size);
+}
+
 // ref. https://github.com/ros2/rcutils/blob/rolling/src/allocator.c
 
+// enif_alloc doesn't tell the size of a block, it is kept in a header before the block
+typedef union {
+  size_t size;
+  max_align_t align;
+} nif_header_t;
+
 static void *__nif_allocate(size_t size, void *state) {
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
 
-  RCUTILS_UNUSED(state);
-  return enif_alloc(size);
+  nif_header_t *header_p = enif_alloc(sizeof(nif_header_t) + size);
+  if (header_p == NULL) return NULL;
+
+  header_p->size = size;
+  count_allocation(state, size);
+  return header_p + 1;
 }
 
 static void __nif_deallocate(void *pointer, void *state) {
-  RCUTILS_UNUSED(state);
-  enif_free(pointer);
+  if (pointer == NULL) return;
+
+  nif_header_t *header_p = (nif_header_t *)pointer - 1;
+  count_deallocation(state, header_p->size);
+  enif_free(header_p);
 }
 
 static void *__nif_reallocate(void *pointer, size_t size, void *state) {
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
 
-  RCUTILS_UNUSED(state);
-  return enif_realloc(pointer, size);
+  if (pointer == NULL) return __nif_allocate(size, state);
+
+  nif_header_t *header_p = (nif_header_t *)pointer - 1;
+  size_t old_size        = header_p->size;
+  header_p               = enif_realloc(header_p, sizeof(nif_header_t) + size);
+  if (header_p == NULL) return NULL;
+
+  header_p->size = size;
+  count_reallocation(state, old_size, size);
+  return header_p + 1;
 }
 
 static void *__nif_zero_allocate(size_t number_of_elements, size_t size_of_element, void *state) {
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
 
-  RCUTILS_UNUSED(state);
-  void *mem = enif_alloc(number_of_elements * size_of_element);
+  void *mem = __nif_allocate(number_of_elements * size_of_element, state);
   if (mem != NULL) memset(mem, 0, number_of_elements * size_of_element);
   return mem;
 }
 
-rcutils_allocator_t get_nif_allocator() {
-  static rcutils_allocator_t nif_allocator = {
+rcutils_allocator_t get_nif_allocator(memory_subsystem_t subsystem) {
+  rcutils_allocator_t nif_allocator = {
       .allocate      = __nif_allocate,
       .deallocate    = __nif_deallocate,
       .reallocate    = __nif_reallocate,
       .zero_allocate = __nif_zero_allocate,
-      .state         = NULL,
+      .state         = &memory_counters[subsystem],
   };
   return nif_allocator;
 }
+
+// The pool allocator keeps the blocks of size classes, powers of two from 16 to 4096 bytes, in a
+// free list per class, from which the next allocation of that class is served instead of by
+// enif_alloc. Larger blocks are not pooled. Every block is preceded by a header with its class and
+// size, and each free list is capped so that a burst of allocations doesn't hold its memory.
+
+#define POOL_MIN_SHIFT 4
+#define POOL_CLASSES 9
+#define POOL_LARGE POOL_CLASSES
+#define POOL_MAX_CACHED 256
+
+typedef union {
+  struct {
+    size_t size_class;
+    size_t size;
+  } h;
+  max_align_t align;
+} pool_header_t;
+
+typedef struct pool_block {
+  struct pool_block *next;
+} pool_block_t;
+
+typedef struct {
+  ErlNifMutex *mutex;
+  pool_block_t *free_list;
+  size_t cached;
+  ErlNifUInt64 allocations;
+  ErlNifUInt64 reuses;
+  ErlNifUInt64 deallocations;
+  size_t bytes; // in use, only counted for the large blocks
+} pool_class_t;
+
+// the last one counts the large blocks, which have no free list
+static pool_class_t pool_classes[POOL_CLASSES + 1];
+
+
+static size_t pool_class_size(size_t size_class) {
+  return (size_t)1 << (size_class + POOL_MIN_SHIFT);
+}
+
+static size_t pool_class_of(size_t size) {
+  size_t size_class = 0;
+  while (size_class < POOL_CLASSES && pool_class_size(size_class) < size)
+    size_class++;
+  return size_class;
+}
+
+static void *__pool_allocate(size_t size, void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  size_t size_class     = pool_class_of(size);
+  pool_class_t *class_p = &pool_classes[size_class];
+  pool_header_t *header_p;
+
+  enif_mutex_lock(class_p->mutex);
+  header_p = (pool_header_t *)class_p->free_list;
+  if (header_p != NULL) {
+    class_p->free_list = class_p->free_list->next;
+    class_p->cached--;
+    class_p->reuses++;
+  }
+  class_p->allocations++;
+  if (size_class == POOL_LARGE) class_p->bytes += size;
+  enif_mutex_unlock(class_p->mutex);
+
+  if (header_p == NULL) {
+    size_t capacity = size_class == POOL_LARGE ? size : pool_class_size(size_class);
+    header_p        = enif_alloc(sizeof(pool_header_t) + capacity);
+  }
+
+  if (header_p == NULL) {
+    enif_mutex_lock(class_p->mutex);
+    class_p->allocations--;
+    if (size_class == POOL_LARGE) class_p->bytes -= size;
+    enif_mutex_unlock(class_p->mutex);
+    return NULL;
+  }
+
+  header_p->h.size_class = size_class;
+  header_p->h.size       = size;
+  count_allocation(state, size);
+  return header_p + 1;
+}
+
+static void __pool_deallocate(void *pointer, void *state) {
+  if (pointer == NULL) return;
+
+  pool_header_t *header_p = (pool_header_t *)pointer - 1;
+  size_t size_class       = header_p->h.size_class;
+  pool_class_t *class_p   = &pool_classes[size_class];
+  bool cache              = false;
+
+  count_deallocation(state, header_p->h.size);
+
+  enif_mutex_lock(class_p->mutex);
+  class_p->deallocations++;
+  if (size_class == POOL_LARGE) {
+    class_p->bytes -= header_p->h.size;
+  } else if (class_p->cached < POOL_MAX_CACHED) {
+    pool_block_t *block_p = (pool_block_t *)header_p;
+    block_p->next         = class_p->free_list;
+    class_p->free_list    = block_p;
+    class_p->cached++;
+    cache = true;
+  }
+  enif_mutex_unlock(class_p->mutex);
+
+  if (!cache) enif_free(header_p);
+}
+
+static void *__pool_reallocate(void *pointer, size_t size, void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  if (pointer == NULL) return __pool_allocate(size, state);
+
+  // a pooled block has room up to the size of its class
+  pool_header_t *header_p = (pool_header_t *)pointer - 1;
+  if (header_p->h.size_class != POOL_LARGE && size <= pool_class_size(header_p->h.size_class)) {
+    count_reallocation(state, header_p->h.size, size);
+    header_p->h.size = size;
+    return pointer;
+  }
+
+  void *new_pointer = __pool_allocate(size, state);
+  if (new_pointer == NULL) return NULL;
+  memcpy(new_pointer, pointer, header_p->h.size < size ? header_p->h.size : size);
+  __pool_deallocate(pointer, state);
+
+  return new_pointer;
+}
+
+static void *__pool_zero_allocate(size_t number_of_elements, size_t size_of_element, void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  void *mem = __pool_allocate(number_of_elements * size_of_element, state);
+  if (mem != NULL) memset(mem, 0, number_of_elements * size_of_element);
+  return mem;
+}
+
+rcutils_allocator_t get_pool_allocator(memory_subsystem_t subsystem) {
+  rcutils_allocator_t pool_allocator = {
+      .allocate      = __pool_allocate,
+      .deallocate    = __pool_deallocate,
+      .reallocate    = __pool_reallocate,
+      .zero_allocate = __pool_zero_allocate,
+      .state         = &memory_counters[subsystem],
+  };
+  return pool_allocator;
+}
+
+// The arena allocator serves the allocations of a single call, such as a graph snapshot, from
+// chunks taken with enif_alloc, by bumping an offset. A deallocation does nothing, the chunks are
+// freed together by arena_free once the call is done with what was allocated. The chunks are
+// counted in the subsystem of the arena.
+
+#define ARENA_CHUNK_SIZE 65536
+
+typedef struct arena_chunk {
+  struct arena_chunk *next;
+  size_t capacity;
+  size_t used;
+  max_align_t data[];
+} arena_chunk_t;
+
+struct arena {
+  arena_chunk_t *chunks;
+  memory_counters_t *counters_p;
+};
+
+static void *__arena_allocate(size_t size, void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  arena_t *arena_p       = state;
+  arena_chunk_t *chunk_p = arena_p->chunks;
+  // the blocks are kept aligned, each preceded by its size for a reallocation
+  size_t align      = sizeof(max_align_t);
+  size_t block_size = sizeof(nif_header_t) + (size + align - 1) / align * align;
+
+  if (chunk_p == NULL || chunk_p->capacity - chunk_p->used < block_size) {
+    size_t capacity = block_size > ARENA_CHUNK_SIZE ? block_size : ARENA_CHUNK_SIZE;
+    chunk_p         = enif_alloc(sizeof(arena_chunk_t) + capacity);
+    if (chunk_p == NULL) return NULL;
+
+    chunk_p->next     = arena_p->chunks;
+    chunk_p->capacity = capacity;
+    chunk_p->used     = 0;
+    arena_p->chunks   = chunk_p;
+    count_allocation(arena_p->counters_p, capacity);
+  }
+
+  nif_header_t *header_p = (nif_header_t *)((char *)chunk_p->data + chunk_p->used);
+  chunk_p->used += block_size;
+  header_p->size = size;
+  return header_p + 1;
+}
+
+static void __arena_deallocate(void *pointer, void *state) {
+  ignore_unused(pointer);
+  ignore_unused(state);
+}
+
+static void *__arena_reallocate(void *pointer, size_t size, void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  if (pointer == NULL) return __arena_allocate(size, state);
+
+  nif_header_t *header_p = (nif_header_t *)pointer - 1;
+  if (size <= header_p->size) return pointer;
+
+  void *new_pointer = __arena_allocate(size, state);
+  if (new_pointer == NULL) return NULL;
+  memcpy(new_pointer, pointer, header_p->size);
+
+  return new_pointer;
+}
+
+static void *__arena_zero_allocate(size_t number_of_elements, size_t size_of_element,
+                                   void *state) {
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  void *mem = __arena_allocate(number_of_elements * size_of_element, state);
+  if (mem != NULL) memset(mem, 0, number_of_elements * size_of_element);
+  return mem;
+}
+
+arena_t *arena_new(memory_subsystem_t subsystem) {
+  arena_t *arena_p = enif_alloc(sizeof(arena_t));
+  if (arena_p == NULL) return NULL;
+
+  arena_p->chunks     = NULL;
+  arena_p->counters_p = &memory_counters[subsystem];
+  return arena_p;
+}
+
+rcutils_allocator_t get_arena_allocator(arena_t *arena_p) {
+  rcutils_allocator_t arena_allocator = {
+      .allocate      = __arena_allocate,
+      .deallocate    = __arena_deallocate,
+      .reallocate    = __arena_reallocate,
+      .zero_allocate = __arena_zero_allocate,
+      .state         = arena_p,
+  };
+  return arena_allocator;
+}
+
+void arena_free(arena_t *arena_p) {
+  arena_chunk_t *chunk_p = arena_p->chunks;
+  while (chunk_p != NULL) {
+    arena_chunk_t *next_p = chunk_p->next;
+    count_deallocation(arena_p->counters_p, chunk_p->capacity);
+    enif_free(chunk_p);
+    chunk_p = next_p;
+  }
+  enif_free(arena_p);
+}
+
+int init_allocators(ErlNifEnv *env) {
+  ignore_unused(env);
+
+  for (size_t i = 0; i <= POOL_CLASSES; i++) {
+    if (pool_classes[i].mutex != NULL) continue;
+    pool_classes[i].mutex = enif_mutex_create("rclex_pool_allocator");
+    if (pool_classes[i].mutex == NULL) return 1;
+  }
+
+  return 0;
+}
+
+static ERL_NIF_TERM make_class_stats(ErlNifEnv *env, size_t size, const pool_class_t *class_p) {
+  ERL_NIF_TERM keys[]   = {enif_make_atom(env, "size"), enif_make_atom(env, "allocations"),
+                           enif_make_atom(env, "reuses"), enif_make_atom(env, "cached")};
+  ERL_NIF_TERM values[] = {enif_make_uint64(env, size), enif_make_uint64(env, class_p->allocations),
+                           enif_make_uint64(env, class_p->reuses),
+                           enif_make_uint64(env, class_p->cached)};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 4, &map);
+  return map;
+}
+
+ERL_NIF_TERM nif_pool_allocator_stats(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  ignore_unused(argv);
+
+  if (argc != 0) return enif_make_badarg(env);
+
+  ErlNifUInt64 allocations = 0, deallocations = 0, reuses = 0;
+  ErlNifUInt64 bytes_in_use = 0, cached_bytes = 0;
+  ERL_NIF_TERM size_classes = enif_make_list(env, 0);
+
+  for (size_t i = POOL_CLASSES + 1; i-- > 0;) {
+    // copied under the lock, the counters of a class are consistent with each other
+    enif_mutex_lock(pool_classes[i].mutex);
+    pool_class_t class = pool_classes[i];
+    enif_mutex_unlock(pool_classes[i].mutex);
+
+    allocations += class.allocations;
+    deallocations += class.deallocations;
+    reuses += class.reuses;
+
+    if (i == POOL_LARGE) {
+      bytes_in_use += class.bytes;
+    } else {
+      bytes_in_use += (class.allocations - class.deallocations) * pool_class_size(i);
+      cached_bytes += class.cached * pool_class_size(i);
+      size_classes = enif_make_list_cell(env, make_class_stats(env, pool_class_size(i), &class),
+                                         size_classes);
+    }
+  }
+
+  ERL_NIF_TERM keys[]   = {enif_make_atom(env, "allocations"),
+                           enif_make_atom(env, "deallocations"),
+                           enif_make_atom(env, "reuses"),
+                           enif_make_atom(env, "bytes_in_use"),
+                           enif_make_atom(env, "cached_bytes"),
+                           enif_make_atom(env, "size_classes")};
+  ERL_NIF_TERM values[] = {enif_make_uint64(env, allocations),
+                           enif_make_uint64(env, deallocations),
+                           enif_make_uint64(env, reuses),
+                           enif_make_uint64(env, bytes_in_use),
+                           enif_make_uint64(env, cached_bytes),
+                           size_classes};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 6, &map);
+  return map;
+}
+
+static ERL_NIF_TERM make_subsystem_stats(ErlNifEnv *env, memory_counters_t *counters_p) {
+  ErlNifUInt64 live_bytes = atomic_load_explicit(&counters_p->live_bytes, memory_order_relaxed);
+  ErlNifUInt64 live_allocations =
+      atomic_load_explicit(&counters_p->live_allocations, memory_order_relaxed);
+  ErlNifUInt64 total_bytes = atomic_load_explicit(&counters_p->total_bytes, memory_order_relaxed);
+  ErlNifUInt64 total_allocations =
+      atomic_load_explicit(&counters_p->total_allocations, memory_order_relaxed);
+
+  ERL_NIF_TERM keys[]   = {enif_make_atom(env, "live_bytes"),
+                           enif_make_atom(env, "live_allocations"),
+                           enif_make_atom(env, "total_bytes"),
+                           enif_make_atom(env, "total_allocations")};
+  ERL_NIF_TERM values[] = {enif_make_uint64(env, live_bytes),
+                           enif_make_uint64(env, live_allocations),
+                           enif_make_uint64(env, total_bytes),
+                           enif_make_uint64(env, total_allocations)};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 4, &map);
+  return map;
+}
+
+ERL_NIF_TERM nif_memory_stats(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  ignore_unused(argv);
+
+  if (argc != 0) return enif_make_badarg(env);
+
+  ERL_NIF_TERM keys[MEMORY_SUBSYSTEMS];
+  keys[MEMORY_MESSAGES]   = enif_make_atom(env, "messages");
+  keys[MEMORY_GRAPH]      = enif_make_atom(env, "graph");
+  keys[MEMORY_ENTITIES]   = enif_make_atom(env, "entities");
+  keys[MEMORY_MIDDLEWARE] = enif_make_atom(env, "middleware");
+
+  ERL_NIF_TERM values[MEMORY_SUBSYSTEMS];
+  for (size_t i = 0; i < MEMORY_SUBSYSTEMS; i++)
+    values[i] = make_subsystem_stats(env, &memory_counters[i]);
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, MEMORY_SUBSYSTEMS, &map);
+  return map;
+}
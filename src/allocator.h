@@ -1,3 +1,30 @@
+#include <erl_nif.h>
 #include <rcutils/allocator.h>
+#include <stdbool.h>
+#include <stddef.h>
 
-rcutils_allocator_t get_nif_allocator();
+// What the native memory is used for, each has its own counters.
+typedef enum {
+  MEMORY_MESSAGES,   // ROS messages, the structs created by rclex
+  MEMORY_GRAPH,      // results of graph queries
+  MEMORY_ENTITIES,   // contexts, nodes, publishers, subscriptions, services, clients, timers, ...
+  MEMORY_MIDDLEWARE, // serialization buffers
+  MEMORY_SUBSYSTEMS,
+} memory_subsystem_t;
+
+rcutils_allocator_t get_nif_allocator(memory_subsystem_t subsystem);
+rcutils_allocator_t get_pool_allocator(memory_subsystem_t subsystem);
+
+// for the allocations of a single call, all freed at once by arena_free
+typedef struct arena arena_t;
+arena_t *arena_new(memory_subsystem_t subsystem);
+rcutils_allocator_t get_arena_allocator(arena_t *arena_p);
+void arena_free(arena_t *arena_p);
+int init_allocators(ErlNifEnv *env);
+
+// for what is not allocated by an allocator of rclex, but is held by it
+void account_allocation(memory_subsystem_t subsystem, size_t size);
+void account_deallocation(memory_subsystem_t subsystem, size_t size);
+
+ERL_NIF_TERM nif_pool_allocator_stats(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_memory_stats(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -0,0 +1,273 @@
+#include "conversion.h"
+#include "macros.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rosidl_runtime_c/string.h>
+#include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string.h>
+#include <rosidl_runtime_c/u16string_functions.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+ERL_NIF_TERM schedule_conversion(ErlNifEnv *env, const char *name, size_t elements,
+                                 conversion_fun_t fun, int argc, const ERL_NIF_TERM argv[]) {
+  if (enif_thread_type() != ERL_NIF_THR_NORMAL_SCHEDULER) return fun(env, argc, argv);
+
+  if (elements > CONVERSION_DIRTY_THRESHOLD)
+    return enif_schedule_nif(env, name, ERL_NIF_DIRTY_JOB_CPU_BOUND, fun, argc, argv);
+
+  ERL_NIF_TERM term = fun(env, argc, argv);
+
+  // let the scheduler account for the time spent, the threshold stands for a full timeslice
+  int percent = (int)(elements * 100 / CONVERSION_DIRTY_THRESHOLD);
+  enif_consume_timeslice(env, percent < 1 ? 1 : percent);
+
+  return term;
+}
+
+// Terms nested deeper are not looked into, the generated messages don't nest that deep.
+#define TERM_SIZE_HINT_MAX_DEPTH 32
+
+static size_t count_list_elements(ErlNifEnv *env, ERL_NIF_TERM term, size_t elements,
+                                  int depth) {
+  if (depth > TERM_SIZE_HINT_MAX_DEPTH) return elements;
+
+  int arity;
+  const ERL_NIF_TERM *tuple;
+  if (enif_get_tuple(env, term, &arity, &tuple)) {
+    for (int i = 0; i < arity && elements <= CONVERSION_DIRTY_THRESHOLD; ++i)
+      elements = count_list_elements(env, tuple[i], elements, depth + 1);
+    return elements;
+  }
+
+  ERL_NIF_TERM head, tail = term;
+  while (elements <= CONVERSION_DIRTY_THRESHOLD && enif_get_list_cell(env, tail, &head, &tail))
+    elements = count_list_elements(env, head, elements + 1, depth + 1);
+  return elements;
+}
+
+size_t term_size_hint(ErlNifEnv *env, ERL_NIF_TERM term) {
+  return count_list_elements(env, term, 0, 0);
+}
+
+conversion_ret_t get_bool(ErlNifEnv *env, ERL_NIF_TERM term, bool *value_p) {
+  if (!enif_is_atom(env, term)) return CONVERSION_BADARG;
+
+  *value_p = enif_is_identical(term, atom_true);
+  return CONVERSION_OK;
+}
+
+conversion_ret_t get_string(ErlNifEnv *env, ERL_NIF_TERM term,
+                            rosidl_runtime_c__String *string_p) {
+  ErlNifBinary binary;
+  if (enif_inspect_binary(env, term, &binary))
+    return rosidl_runtime_c__String__assignn(string_p, (const char *)binary.data, binary.size)
+               ? CONVERSION_OK
+               : CONVERSION_ERROR;
+
+  unsigned int length;
+#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
+  if (!enif_get_string_length(env, term, &length, ERL_NIF_LATIN1)) return CONVERSION_BADARG;
+#else
+  if (!enif_get_list_length(env, term, &length)) return CONVERSION_BADARG;
+#endif
+
+  char *buffer = enif_alloc(length + 1);
+  if (buffer == NULL) return CONVERSION_ERROR;
+
+  conversion_ret_t ret = CONVERSION_BADARG;
+  if (enif_get_string(env, term, buffer, length + 1, ERL_NIF_LATIN1) > 0)
+    ret = rosidl_runtime_c__String__assignn(string_p, buffer, length) ? CONVERSION_OK
+                                                                      : CONVERSION_ERROR;
+
+  enif_free(buffer);
+  return ret;
+}
+
+// Decodes the code point at p into *cp_p and returns the next position, NULL for an invalid or
+// truncated UTF-8 sequence.
+static const unsigned char *utf8_decode(const unsigned char *p, const unsigned char *end,
+                                        uint32_t *cp_p) {
+  size_t n;
+  uint32_t cp, min;
+
+  if (*p < 0x80) {
+    *cp_p = *p;
+    return p + 1;
+  } else if ((*p & 0xE0) == 0xC0) {
+    n = 1, cp = *p & 0x1F, min = 0x80;
+  } else if ((*p & 0xF0) == 0xE0) {
+    n = 2, cp = *p & 0x0F, min = 0x800;
+  } else if ((*p & 0xF8) == 0xF0) {
+    n = 3, cp = *p & 0x07, min = 0x10000;
+  } else {
+    return NULL;
+  }
+
+  if ((size_t)(end - p) <= n) return NULL;
+  for (size_t i = 1; i <= n; ++i) {
+    if ((p[i] & 0xC0) != 0x80) return NULL;
+    cp = (cp << 6) | (p[i] & 0x3F);
+  }
+  if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return NULL;
+
+  *cp_p = cp;
+  return p + n + 1;
+}
+
+// Decodes the code point at data[*i_p] and advances *i_p past it, U+FFFD for a lone surrogate.
+static uint32_t utf16_decode(const uint16_t *data, size_t size, size_t *i_p) {
+  uint32_t unit = data[(*i_p)++];
+
+  if (unit < 0xD800 || unit > 0xDFFF) return unit;
+  if (unit > 0xDBFF || *i_p == size || data[*i_p] < 0xDC00 || data[*i_p] > 0xDFFF) return 0xFFFD;
+
+  return 0x10000 + ((unit - 0xD800) << 10) + (data[(*i_p)++] - 0xDC00);
+}
+
+static size_t utf8_length(uint32_t cp) {
+  return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+conversion_ret_t get_wstring(ErlNifEnv *env, ERL_NIF_TERM term,
+                             rosidl_runtime_c__U16String *string_p) {
+  ErlNifBinary binary;
+  if (!enif_inspect_binary(env, term, &binary)) return CONVERSION_BADARG;
+
+  const unsigned char *p, *end = binary.data + binary.size;
+  uint32_t cp;
+  size_t length = 0;
+
+  for (p = binary.data; p < end;) {
+    p = utf8_decode(p, end, &cp);
+    if (p == NULL) return CONVERSION_BADARG;
+    length += cp > 0xFFFF ? 2 : 1;
+  }
+
+  if (!rosidl_runtime_c__U16String__resize(string_p, length)) return CONVERSION_ERROR;
+
+  uint16_t *data = string_p->data;
+  for (p = binary.data; p < end;) {
+    p = utf8_decode(p, end, &cp);
+    if (cp > 0xFFFF) {
+      *data++ = (uint16_t)(0xD800 + ((cp - 0x10000) >> 10));
+      *data++ = (uint16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+    } else {
+      *data++ = (uint16_t)cp;
+    }
+  }
+
+  return CONVERSION_OK;
+}
+
+ERL_NIF_TERM make_wstring(ErlNifEnv *env, const rosidl_runtime_c__U16String *string_p) {
+  size_t size = 0;
+  for (size_t i = 0; i < string_p->size;)
+    size += utf8_length(utf16_decode(string_p->data, string_p->size, &i));
+
+  ERL_NIF_TERM binary;
+  unsigned char *data = enif_make_new_binary(env, size, &binary);
+
+  for (size_t i = 0; i < string_p->size;) {
+    uint32_t cp = utf16_decode(string_p->data, string_p->size, &i);
+    size_t n    = utf8_length(cp);
+
+    if (n == 1) {
+      *data++ = (unsigned char)cp;
+      continue;
+    }
+
+    static const unsigned char lead[] = {0, 0, 0xC0, 0xE0, 0xF0};
+    *data++ = (unsigned char)(lead[n] | (cp >> (6 * (n - 1))));
+    for (size_t k = n - 1; k-- > 0;)
+      *data++ = (unsigned char)(0x80 | ((cp >> (6 * k)) & 0x3F));
+  }
+
+  return binary;
+}
+
+static inline int get_bool_term(ErlNifEnv *env, ERL_NIF_TERM term, bool *value_p) {
+  return get_bool(env, term, value_p) == CONVERSION_OK;
+}
+
+static inline ERL_NIF_TERM make_bool_term(ErlNifEnv *env, bool value) {
+  ignore_unused(env);
+  return value ? atom_true : atom_false;
+}
+
+// Defines get_<kind>_array and make_<kind>_list, converting each element through a term_type
+// value with the given enif getter and maker.
+#define define_array_conversion(kind, type, term_type, get, make)                                 \
+  conversion_ret_t get_##kind##_array(ErlNifEnv *env, ERL_NIF_TERM list, type *data,              \
+                                      size_t length) {                                            \
+    ERL_NIF_TERM head, tail = list;                                                               \
+    for (size_t i = 0; i < length; ++i) {                                                         \
+      term_type value;                                                                            \
+      if (!enif_get_list_cell(env, tail, &head, &tail) || !get(env, head, &value))                \
+        return CONVERSION_BADARG;                                                                 \
+      data[i] = (type)value;                                                                      \
+    }                                                                                             \
+    return enif_is_empty_list(env, tail) ? CONVERSION_OK : CONVERSION_BADARG;                     \
+  }                                                                                               \
+                                                                                                  \
+  ERL_NIF_TERM make_##kind##_list(ErlNifEnv *env, const type *data, size_t start,                 \
+                                  size_t length) {                                                \
+    ERL_NIF_TERM list = enif_make_list(env, 0);                                                   \
+    for (size_t i = start + length; i-- > start;)                                                 \
+      list = enif_make_list_cell(env, make(env, data[i]), list);                                  \
+    return list;                                                                                  \
+  }
+
+define_array_conversion(bool, bool, bool, get_bool_term, make_bool_term)
+define_array_conversion(int8, int8_t, int, enif_get_int, enif_make_int)
+define_array_conversion(uint8, uint8_t, unsigned int, enif_get_uint, enif_make_uint)
+define_array_conversion(int16, int16_t, int, enif_get_int, enif_make_int)
+define_array_conversion(uint16, uint16_t, unsigned int, enif_get_uint, enif_make_uint)
+define_array_conversion(int32, int32_t, int, enif_get_int, enif_make_int)
+define_array_conversion(uint32, uint32_t, unsigned int, enif_get_uint, enif_make_uint)
+define_array_conversion(int64, int64_t, ErlNifSInt64, enif_get_int64, enif_make_int64)
+define_array_conversion(uint64, uint64_t, ErlNifUInt64, enif_get_uint64, enif_make_uint64)
+define_array_conversion(float32, float, double, enif_get_double, enif_make_double)
+define_array_conversion(float64, double, double, enif_get_double, enif_make_double)
+
+conversion_ret_t get_string_array(ErlNifEnv *env, ERL_NIF_TERM list,
+                                  rosidl_runtime_c__String *data, size_t length) {
+  ERL_NIF_TERM head, tail = list;
+  for (size_t i = 0; i < length; ++i) {
+    if (!enif_get_list_cell(env, tail, &head, &tail)) return CONVERSION_BADARG;
+
+    conversion_ret_t ret = get_string(env, head, &data[i]);
+    if (ret != CONVERSION_OK) return ret;
+  }
+  return enif_is_empty_list(env, tail) ? CONVERSION_OK : CONVERSION_BADARG;
+}
+
+ERL_NIF_TERM make_string_list(ErlNifEnv *env, const rosidl_runtime_c__String *data, size_t start,
+                              size_t length) {
+  ERL_NIF_TERM list = enif_make_list(env, 0);
+  for (size_t i = start + length; i-- > start;)
+    list = enif_make_list_cell(env, enif_make_string(env, data[i].data, ERL_NIF_LATIN1), list);
+  return list;
+}
+
+conversion_ret_t get_wstring_array(ErlNifEnv *env, ERL_NIF_TERM list,
+                                   rosidl_runtime_c__U16String *data, size_t length) {
+  ERL_NIF_TERM head, tail = list;
+  for (size_t i = 0; i < length; ++i) {
+    if (!enif_get_list_cell(env, tail, &head, &tail)) return CONVERSION_BADARG;
+
+    conversion_ret_t ret = get_wstring(env, head, &data[i]);
+    if (ret != CONVERSION_OK) return ret;
+  }
+  return enif_is_empty_list(env, tail) ? CONVERSION_OK : CONVERSION_BADARG;
+}
+
+ERL_NIF_TERM make_wstring_list(ErlNifEnv *env, const rosidl_runtime_c__U16String *data,
+                               size_t start, size_t length) {
+  ERL_NIF_TERM list = enif_make_list(env, 0);
+  for (size_t i = start + length; i-- > start;)
+    list = enif_make_list_cell(env, make_wstring(env, &data[i]), list);
+  return list;
+}
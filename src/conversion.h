@@ -0,0 +1,60 @@
+#include <erl_nif.h>
+#include <rosidl_runtime_c/string.h>
+#include <rosidl_runtime_c/u16string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of sequence elements above which converting between a message and terms is moved from
+// the calling normal scheduler to a dirty CPU scheduler.
+#define CONVERSION_DIRTY_THRESHOLD 4096
+
+typedef ERL_NIF_TERM (*conversion_fun_t)(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+typedef enum {
+  CONVERSION_OK,
+  CONVERSION_BADARG,
+  CONVERSION_ERROR,
+} conversion_ret_t;
+
+// The exception a NIF returns for a failed conversion, badarg for a term of the wrong shape.
+#define conversion_error(env, ret)                                                                 \
+  ((ret) == CONVERSION_BADARG ? enif_make_badarg(env) : raise(env, __FILE__, __LINE__))
+
+extern ERL_NIF_TERM schedule_conversion(ErlNifEnv *env, const char *name, size_t elements,
+                                        conversion_fun_t fun, int argc, const ERL_NIF_TERM argv[]);
+// The size hint of a term to be converted into a message, the number of list elements in it,
+// those in nested tuples and lists included. The message can't tell before it is set, so the
+// term is walked, up to just above CONVERSION_DIRTY_THRESHOLD elements.
+extern size_t term_size_hint(ErlNifEnv *env, ERL_NIF_TERM term);
+
+extern conversion_ret_t get_bool(ErlNifEnv *env, ERL_NIF_TERM term, bool *value_p);
+extern conversion_ret_t get_string(ErlNifEnv *env, ERL_NIF_TERM term,
+                                   rosidl_runtime_c__String *string_p);
+// wstrings are UTF-8 binaries on the Erlang side
+extern conversion_ret_t get_wstring(ErlNifEnv *env, ERL_NIF_TERM term,
+                                    rosidl_runtime_c__U16String *string_p);
+extern ERL_NIF_TERM make_wstring(ErlNifEnv *env, const rosidl_runtime_c__U16String *string_p);
+
+// Shared by the generated converters for the arrays and sequences of primitives, get_*_array
+// fills the `length` elements of data from a list of exactly that length, make_*_list makes the
+// list of the `length` elements of data from `start`.
+#define declare_array_conversion(kind, type)                                                       \
+  extern conversion_ret_t get_##kind##_array(ErlNifEnv *env, ERL_NIF_TERM list, type *data,       \
+                                             size_t length);                                      \
+  extern ERL_NIF_TERM make_##kind##_list(ErlNifEnv *env, const type *data, size_t start,          \
+                                         size_t length)
+
+declare_array_conversion(bool, bool);
+declare_array_conversion(int8, int8_t);
+declare_array_conversion(uint8, uint8_t);
+declare_array_conversion(int16, int16_t);
+declare_array_conversion(uint16, uint16_t);
+declare_array_conversion(int32, int32_t);
+declare_array_conversion(uint32, uint32_t);
+declare_array_conversion(int64, int64_t);
+declare_array_conversion(uint64, uint64_t);
+declare_array_conversion(float32, float);
+declare_array_conversion(float64, double);
+declare_array_conversion(string, rosidl_runtime_c__String);
+declare_array_conversion(wstring, rosidl_runtime_c__U16String);
@@ -0,0 +1,52 @@
+#include "dynamic_type_support.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <dlfcn.h>
+#include <erl_nif.h>
+#include <rosidl_runtime_c/message_type_support_struct.h>
+#include <stdio.h>
+
+typedef const rosidl_message_type_support_t *(*get_message_type_support_handle_t)(void);
+
+// Resolves the type support of a message type which is not generated into this library, from the
+// rosidl_typesupport_c library of its package. The library is never closed, the returned type
+// support points into it.
+ERL_NIF_TERM nif_dynamic_message_type_support(ErlNifEnv *env, int argc,
+                                              const ERL_NIF_TERM argv[]) {
+  if (argc != 3) return enif_make_badarg(env);
+
+  char package[256], interface_type[16], type[256];
+  if (enif_get_string(env, argv[0], package, sizeof(package), ERL_NIF_LATIN1) <= 0)
+    return enif_make_badarg(env);
+  if (enif_get_string(env, argv[1], interface_type, sizeof(interface_type), ERL_NIF_LATIN1) <= 0)
+    return enif_make_badarg(env);
+  if (enif_get_string(env, argv[2], type, sizeof(type), ERL_NIF_LATIN1) <= 0)
+    return enif_make_badarg(env);
+
+  char library[320];
+  snprintf(library, sizeof(library), "lib%s__rosidl_typesupport_c.so", package);
+
+  void *handle = dlopen(library, RTLD_LAZY | RTLD_LOCAL);
+  if (handle == NULL) return raise_with_message(env, __FILE__, __LINE__, dlerror());
+
+  char symbol[640];
+  snprintf(symbol, sizeof(symbol),
+           "rosidl_typesupport_c__get_message_type_support_handle__%s__%s__%s", package,
+           interface_type, type);
+
+  get_message_type_support_handle_t get_handle;
+  *(void **)&get_handle = dlsym(handle, symbol);
+  if (get_handle == NULL) {
+    ERL_NIF_TERM ret = raise_with_message(env, __FILE__, __LINE__, dlerror());
+    dlclose(handle);
+    return ret;
+  }
+
+  rosidl_message_type_support_t *obj =
+      enif_alloc_resource(rt_rosidl_message_type_support_t, sizeof(rosidl_message_type_support_t));
+  *obj              = *get_handle();
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
@@ -0,0 +1,3 @@
+#include <erl_nif.h>
+
+ERL_NIF_TERM nif_dynamic_message_type_support(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
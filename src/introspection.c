@@ -0,0 +1,767 @@
+#include "introspection.h"
+#include "conversion.h"
+#include "macros.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rosidl_runtime_c/message_initialization.h>
+#include <rosidl_runtime_c/message_type_support_struct.h>
+#include <rosidl_runtime_c/primitives_sequence.h>
+#include <rosidl_runtime_c/primitives_sequence_functions.h>
+#include <rosidl_runtime_c/string.h>
+#include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string.h>
+#include <rosidl_runtime_c/u16string_functions.h>
+#include <rosidl_typesupport_introspection_c/field_types.h>
+#include <rosidl_typesupport_introspection_c/identifier.h>
+#include <rosidl_typesupport_introspection_c/message_introspection.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of members for which the terms of a message tuple are collected on the stack.
+#define STACK_TUPLE_ARITY 16
+
+typedef rosidl_typesupport_introspection_c__MessageMember member_t;
+typedef rosidl_typesupport_introspection_c__MessageMembers members_t;
+
+// Layout shared by all rosidl_runtime_c sequences, whatever their element type.
+typedef struct {
+  void *data;
+  size_t size;
+  size_t capacity;
+} sequence_t;
+
+struct plan;
+
+typedef struct {
+  uint8_t type_id;
+  bool is_array;
+  bool is_sequence;
+  size_t array_size; // static size, upper bound of a bounded sequence or 0
+  size_t offset;
+  size_t element_size;
+  const member_t *member;
+  struct plan *nested;
+} plan_member_t;
+
+typedef struct plan {
+  const members_t *members;
+  size_t member_count;
+  ERL_NIF_TERM *keys; // member names as atoms, the keys of the maps made by get_map
+  plan_member_t member[];
+} plan_t;
+
+static size_t element_size(const member_t *member) {
+  switch (member->type_id_) {
+  case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+    return sizeof(float);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+    return sizeof(double);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+    return sizeof(long double);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+    return sizeof(signed char);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+    return sizeof(uint16_t);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+    return sizeof(bool);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+    return sizeof(uint8_t);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+    return sizeof(uint16_t);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+    return sizeof(uint32_t);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+    return sizeof(uint64_t);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+    return sizeof(rosidl_runtime_c__String);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+    return sizeof(rosidl_runtime_c__U16String);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+    return ((const members_t *)member->members_->data)->size_of_;
+  default:
+    return 0;
+  }
+}
+
+static void free_plan(plan_t *plan) {
+  for (size_t i = 0; i < plan->member_count; ++i)
+    if (plan->member[i].nested != NULL) free_plan(plan->member[i].nested);
+
+  enif_free(plan);
+}
+
+static plan_t *build_plan(ErlNifEnv *env, const members_t *members) {
+  size_t member_count = members->member_count_;
+
+  // rosidl adds this dummy member to empty messages, the generated code converts them from {}
+  if (member_count == 1 &&
+      strcmp(members->members_[0].name_, "structure_needs_at_least_one_member") == 0)
+    member_count = 0;
+
+  plan_t *plan = enif_alloc(sizeof(plan_t) + member_count * sizeof(plan_member_t) +
+                            member_count * sizeof(ERL_NIF_TERM));
+  if (plan == NULL) return NULL;
+
+  plan->members      = members;
+  plan->member_count = member_count;
+  plan->keys         = (ERL_NIF_TERM *)&plan->member[member_count];
+
+  for (size_t i = 0; i < member_count; ++i) {
+    const member_t *member = &members->members_[i];
+    plan_member_t *m       = &plan->member[i];
+
+    m->type_id      = member->type_id_;
+    m->is_array     = member->is_array_;
+    m->is_sequence  = member->is_array_ && (member->array_size_ == 0 || member->is_upper_bound_);
+    m->array_size   = member->array_size_;
+    m->offset       = member->offset_;
+    m->element_size = element_size(member);
+    m->member       = member;
+    m->nested       = NULL;
+
+    // atoms are not bound to an environment, so they can be kept as long as the plan
+    plan->keys[i] = enif_make_atom(env, member->name_);
+  }
+
+  for (size_t i = 0; i < member_count; ++i) {
+    if (plan->member[i].type_id != rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE) continue;
+
+    plan->member[i].nested =
+        build_plan(env, (const members_t *)members->members_[i].members_->data);
+    if (plan->member[i].nested == NULL) {
+      plan->member_count = i;
+      free_plan(plan);
+      return NULL;
+    }
+  }
+
+  return plan;
+}
+
+void introspection_plan_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  plan_t **plan_pp = (plan_t **)obj;
+  if (*plan_pp != NULL) free_plan(*plan_pp);
+}
+
+#define sequence_reinit(type, field, size)                                                         \
+  (rosidl_runtime_c__##type##__Sequence__fini((rosidl_runtime_c__##type##__Sequence *)(field)),    \
+   rosidl_runtime_c__##type##__Sequence__init((rosidl_runtime_c__##type##__Sequence *)(field),     \
+                                              (size)))
+
+static bool reinit_sequence(const plan_member_t *m, void *field, size_t size) {
+  switch (m->type_id) {
+  case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+    return sequence_reinit(float, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+    return sequence_reinit(double, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+    return sequence_reinit(long_double, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+    return sequence_reinit(char, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+    return sequence_reinit(wchar, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+    return sequence_reinit(boolean, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+    return sequence_reinit(octet, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+    return sequence_reinit(uint8, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+    return sequence_reinit(int8, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+    return sequence_reinit(uint16, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+    return sequence_reinit(int16, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+    return sequence_reinit(uint32, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+    return sequence_reinit(int32, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+    return sequence_reinit(uint64, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+    return sequence_reinit(int64, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+    return sequence_reinit(String, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+    return sequence_reinit(U16String, field, size);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+    return m->member->resize_function != NULL && m->member->resize_function(field, size);
+  default:
+    return false;
+  }
+}
+
+static conversion_ret_t set_members(ErlNifEnv *env, const plan_t *plan, void *message_p,
+                                    ERL_NIF_TERM term);
+
+static conversion_ret_t set_value(ErlNifEnv *env, const plan_member_t *m, void *value_p,
+                                  ERL_NIF_TERM term) {
+  int i;
+  unsigned int u;
+  ErlNifSInt64 i64;
+  ErlNifUInt64 u64;
+  double d;
+
+  switch (m->type_id) {
+  case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+    if (!enif_get_double(env, term, &d)) return CONVERSION_BADARG;
+    *(float *)value_p = (float)d;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+    if (!enif_get_double(env, term, &d)) return CONVERSION_BADARG;
+    *(double *)value_p = d;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+    if (!enif_get_double(env, term, &d)) return CONVERSION_BADARG;
+    *(long double *)value_p = d;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+    if (!enif_get_int(env, term, &i)) return CONVERSION_BADARG;
+    *(int8_t *)value_p = (int8_t)i;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+    if (!enif_get_uint(env, term, &u)) return CONVERSION_BADARG;
+    *(uint16_t *)value_p = (uint16_t)u;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+    if (enif_is_identical(term, atom_true))
+      *(bool *)value_p = true;
+    else if (enif_is_identical(term, atom_false))
+      *(bool *)value_p = false;
+    else
+      return CONVERSION_BADARG;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+    if (!enif_get_uint(env, term, &u)) return CONVERSION_BADARG;
+    *(uint8_t *)value_p = (uint8_t)u;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+    if (!enif_get_int(env, term, &i)) return CONVERSION_BADARG;
+    *(int16_t *)value_p = (int16_t)i;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+    if (!enif_get_uint(env, term, &u)) return CONVERSION_BADARG;
+    *(uint32_t *)value_p = u;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+    if (!enif_get_int(env, term, &i)) return CONVERSION_BADARG;
+    *(int32_t *)value_p = i;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+    if (!enif_get_uint64(env, term, &u64)) return CONVERSION_BADARG;
+    *(uint64_t *)value_p = u64;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+    if (!enif_get_int64(env, term, &i64)) return CONVERSION_BADARG;
+    *(int64_t *)value_p = i64;
+    return CONVERSION_OK;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+    return get_string(env, term, (rosidl_runtime_c__String *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+    return get_wstring(env, term, (rosidl_runtime_c__U16String *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+    return set_members(env, m->nested, value_p, term);
+  default:
+    return CONVERSION_BADARG;
+  }
+}
+
+static conversion_ret_t set_array(ErlNifEnv *env, const plan_member_t *m, void *field_p,
+                                  ERL_NIF_TERM term) {
+  unsigned int length;
+  if (!enif_get_list_length(env, term, &length)) return CONVERSION_BADARG;
+
+  uint8_t *data;
+  if (m->is_sequence) {
+    if (m->array_size != 0 && length > m->array_size) return CONVERSION_BADARG;
+    if (!reinit_sequence(m, field_p, length)) return CONVERSION_ERROR;
+    data = ((sequence_t *)field_p)->data;
+  } else {
+    if (length != m->array_size) return CONVERSION_BADARG;
+    data = field_p;
+  }
+
+  ERL_NIF_TERM head, tail = term;
+  for (size_t i = 0; i < length && enif_get_list_cell(env, tail, &head, &tail); ++i) {
+    conversion_ret_t ret = set_value(env, m, data + i * m->element_size, head);
+    if (ret != CONVERSION_OK) return ret;
+  }
+
+  return CONVERSION_OK;
+}
+
+static conversion_ret_t set_members(ErlNifEnv *env, const plan_t *plan, void *message_p,
+                                    ERL_NIF_TERM term) {
+  int arity;
+  const ERL_NIF_TERM *tuple;
+  if (!enif_get_tuple(env, term, &arity, &tuple) || (size_t)arity != plan->member_count)
+    return CONVERSION_BADARG;
+
+  for (size_t i = 0; i < plan->member_count; ++i) {
+    const plan_member_t *m = &plan->member[i];
+    void *field_p          = (uint8_t *)message_p + m->offset;
+
+    conversion_ret_t ret = m->is_array ? set_array(env, m, field_p, tuple[i])
+                                       : set_value(env, m, field_p, tuple[i]);
+    if (ret != CONVERSION_OK) return ret;
+  }
+
+  return CONVERSION_OK;
+}
+
+static ERL_NIF_TERM make_members(ErlNifEnv *env, const plan_t *plan, const void *message_p,
+                                 bool maps);
+
+// With maps, messages are made as maps keyed by member name and strings as binaries, otherwise
+// in the tuple shape of the generated code.
+static ERL_NIF_TERM make_value(ErlNifEnv *env, const plan_member_t *m, const void *value_p,
+                               bool maps) {
+  switch (m->type_id) {
+  case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+    return enif_make_double(env, *(const float *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+    return enif_make_double(env, *(const double *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+    return enif_make_double(env, (double)*(const long double *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+    return enif_make_int(env, *(const int8_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+    return enif_make_uint(env, *(const uint16_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+    return *(const bool *)value_p ? atom_true : atom_false;
+  case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+    return enif_make_uint(env, *(const uint8_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+    return enif_make_int(env, *(const int16_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+    return enif_make_uint(env, *(const uint32_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+    return enif_make_int(env, *(const int32_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+    return enif_make_uint64(env, *(const uint64_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+    return enif_make_int64(env, *(const int64_t *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_STRING: {
+    const rosidl_runtime_c__String *string_p = (const rosidl_runtime_c__String *)value_p;
+    if (!maps) return enif_make_string_len(env, string_p->data, string_p->size, ERL_NIF_LATIN1);
+
+    ERL_NIF_TERM binary;
+    unsigned char *data = enif_make_new_binary(env, string_p->size, &binary);
+    if (string_p->size > 0) memcpy(data, string_p->data, string_p->size);
+    return binary;
+  }
+  case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+    return make_wstring(env, (const rosidl_runtime_c__U16String *)value_p);
+  case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+    return make_members(env, m->nested, value_p, maps);
+  default:
+    return enif_make_badarg(env);
+  }
+}
+
+static void array_data(const plan_member_t *m, const void *field_p, const uint8_t **data_p,
+                       size_t *size_p) {
+  if (m->is_sequence) {
+    *data_p = ((const sequence_t *)field_p)->data;
+    *size_p = ((const sequence_t *)field_p)->size;
+  } else {
+    *data_p = field_p;
+    *size_p = m->array_size;
+  }
+}
+
+static ERL_NIF_TERM make_array(ErlNifEnv *env, const plan_member_t *m, const uint8_t *data,
+                               size_t start, size_t length, bool maps) {
+  ERL_NIF_TERM list = enif_make_list(env, 0);
+
+  for (size_t i = start + length; i-- > start;)
+    list = enif_make_list_cell(env, make_value(env, m, data + i * m->element_size, maps), list);
+
+  return list;
+}
+
+static ERL_NIF_TERM make_member(ErlNifEnv *env, const plan_member_t *m, const void *message_p,
+                                bool maps) {
+  const void *field_p = (const uint8_t *)message_p + m->offset;
+  if (!m->is_array) return make_value(env, m, field_p, maps);
+
+  const uint8_t *data;
+  size_t size;
+  array_data(m, field_p, &data, &size);
+
+  return make_array(env, m, data, 0, size, maps);
+}
+
+static ERL_NIF_TERM make_members(ErlNifEnv *env, const plan_t *plan, const void *message_p,
+                                 bool maps) {
+  ERL_NIF_TERM stack[STACK_TUPLE_ARITY];
+  ERL_NIF_TERM *terms = stack;
+
+  if (plan->member_count > STACK_TUPLE_ARITY) {
+    terms = enif_alloc(plan->member_count * sizeof(ERL_NIF_TERM));
+    if (terms == NULL) return enif_make_badarg(env);
+  }
+
+  for (size_t i = 0; i < plan->member_count; ++i)
+    terms[i] = make_member(env, &plan->member[i], message_p, maps);
+
+  ERL_NIF_TERM term;
+  if (maps)
+    enif_make_map_from_arrays(env, plan->keys, terms, plan->member_count, &term);
+  else
+    term = enif_make_tuple_from_array(env, terms, (unsigned)plan->member_count);
+  if (terms != stack) enif_free(terms);
+
+  return term;
+}
+
+// Same semantics as the generated `_make_field`, a path of member indices, and array indices or
+// {start, length} slices for array members.
+static ERL_NIF_TERM make_field(ErlNifEnv *env, const plan_t *plan, const void *message_p,
+                               ERL_NIF_TERM path) {
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index) ||
+      index < 0 || (size_t)index >= plan->member_count)
+    return enif_make_badarg(env);
+
+  const plan_member_t *m = &plan->member[index];
+  const void *field_p    = (const uint8_t *)message_p + m->offset;
+  bool is_message        = m->type_id == rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE;
+
+  if (enif_is_empty_list(env, rest)) return make_member(env, m, message_p, false);
+
+  if (!m->is_array)
+    return is_message ? make_field(env, m->nested, field_p, rest) : enif_make_badarg(env);
+
+  const uint8_t *data;
+  size_t size;
+  array_data(m, field_p, &data, &size);
+
+  ERL_NIF_TERM array_head, array_rest;
+  if (!enif_get_list_cell(env, rest, &array_head, &array_rest)) return enif_make_badarg(env);
+
+  unsigned long array_index;
+  if (enif_get_ulong(env, array_head, &array_index)) {
+    if (array_index >= size) return enif_make_badarg(env);
+
+    const void *element_p = data + array_index * m->element_size;
+    if (enif_is_empty_list(env, array_rest)) return make_value(env, m, element_p, false);
+
+    return is_message ? make_field(env, m->nested, element_p, array_rest) : enif_make_badarg(env);
+  }
+
+  int arity;
+  const ERL_NIF_TERM *slice;
+  unsigned long start, length;
+  if (!enif_get_tuple(env, array_head, &arity, &slice) || arity != 2 ||
+      !enif_get_ulong(env, slice[0], &start) || !enif_get_ulong(env, slice[1], &length) ||
+      !enif_is_empty_list(env, array_rest))
+    return enif_make_badarg(env);
+
+  if (start > size) start = size;
+  if (length > size - start) length = size - start;
+
+  return make_array(env, m, data, start, length, false);
+}
+
+// Sums the sizes of all the sequences of the message, nested messages and the elements of
+// message arrays included, like the generated `_get` does to decide whether the conversion
+// runs on a dirty scheduler.
+static size_t size_hint(const plan_t *plan, const void *message_p) {
+  size_t elements = 0;
+
+  for (size_t i = 0; i < plan->member_count; ++i) {
+    const plan_member_t *m = &plan->member[i];
+    const void *field_p    = (const uint8_t *)message_p + m->offset;
+
+    if (m->is_sequence) elements += ((const sequence_t *)field_p)->size;
+    if (m->type_id != rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE) continue;
+
+    if (!m->is_array) {
+      elements += size_hint(m->nested, field_p);
+      continue;
+    }
+
+    const uint8_t *data;
+    size_t size;
+    array_data(m, field_p, &data, &size);
+    for (size_t j = 0; j < size; ++j)
+      elements += size_hint(m->nested, data + j * m->element_size);
+  }
+
+  return elements;
+}
+
+ERL_NIF_TERM nif_introspection_plan(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rosidl_message_type_support_t *ts_p;
+  if (!enif_get_resource(env, argv[0], rt_rosidl_message_type_support_t, (void **)&ts_p))
+    return enif_make_badarg(env);
+
+  const rosidl_message_type_support_t *introspection_ts_p =
+      get_message_typesupport_handle(ts_p, rosidl_typesupport_introspection_c__identifier);
+  if (introspection_ts_p == NULL)
+    return raise_with_message(env, __FILE__, __LINE__, "introspection type support not found");
+
+  plan_t *plan = build_plan(env, (const members_t *)introspection_ts_p->data);
+  if (plan == NULL) return raise(env, __FILE__, __LINE__);
+
+  plan_t **obj      = enif_alloc_resource(rt_introspection_plan, sizeof(plan_t *));
+  *obj              = plan;
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+
+// The message is destroyed with the plan of its type, which it keeps until then.
+static void destroy_message(void *message_p, void *owner_p) {
+  plan_t **plan_pp = (plan_t **)owner_p;
+
+  (*plan_pp)->members->fini_function(message_p);
+  free(message_p);
+}
+
+ERL_NIF_TERM nif_introspection_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  const members_t *members = (*plan_pp)->members;
+
+  void *message_p = calloc(1, members->size_of_);
+  if (message_p == NULL) return raise(env, __FILE__, __LINE__);
+  members->init_function(message_p, ROSIDL_RUNTIME_C_MSG_INIT_ALL);
+
+  return make_ros_message_resource(env, message_p, members->size_of_, destroy_message, plan_pp);
+}
+
+ERL_NIF_TERM nif_introspection_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+
+  destroy_ros_message(ros_message_p);
+
+  return atom_ok;
+}
+
+static ERL_NIF_TERM introspection_set_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  ignore_unused(argc);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  conversion_ret_t ret = set_members(env, *plan_pp, message_p, argv[2]);
+  release_ros_message(ros_message_p);
+  if (ret != CONVERSION_OK) return conversion_error(env, ret);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_introspection_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3) return enif_make_badarg(env);
+
+  size_t elements = term_size_hint(env, argv[2]);
+
+  return schedule_conversion(env, "introspection_set", elements, introspection_set_impl, argc,
+                             argv);
+}
+
+static ERL_NIF_TERM introspection_get_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  ignore_unused(argc);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_members(env, *plan_pp, message_p, false);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_introspection_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  size_t elements = size_hint(*plan_pp, message_p);
+  release_ros_message(ros_message_p);
+
+  return schedule_conversion(env, "introspection_get", elements, introspection_get_impl, argc,
+                             argv);
+}
+
+static ERL_NIF_TERM introspection_get_map_impl(ErlNifEnv *env, int argc,
+                                               const ERL_NIF_TERM argv[]) {
+  ignore_unused(argc);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_members(env, *plan_pp, message_p, true);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_introspection_get_map(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  size_t elements = size_hint(*plan_pp, message_p);
+  release_ros_message(ros_message_p);
+
+  return schedule_conversion(env, "introspection_get_map", elements, introspection_get_map_impl,
+                             argc, argv);
+}
+
+static ERL_NIF_TERM introspection_get_field_impl(ErlNifEnv *env, int argc,
+                                                 const ERL_NIF_TERM argv[]) {
+  ignore_unused(argc);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_field(env, *plan_pp, message_p, argv[2]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+// The whole message is the size hint, the field is only found by the conversion.
+ERL_NIF_TERM nif_introspection_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3) return enif_make_badarg(env);
+
+  plan_t **plan_pp;
+  if (!enif_get_resource(env, argv[0], rt_introspection_plan, (void **)&plan_pp))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  size_t elements = size_hint(*plan_pp, message_p);
+  release_ros_message(ros_message_p);
+
+  return schedule_conversion(env, "introspection_get_field", elements,
+                             introspection_get_field_impl, argc, argv);
+}
+
+static const member_t *find_message_member(const members_t *members, const char *name) {
+  for (size_t i = 0; i < members->member_count_; ++i) {
+    const member_t *member = &members->members_[i];
+    if (strcmp(member->name_, name) != 0) continue;
+    if (member->type_id_ != rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE) return NULL;
+    if (member->is_array_) return NULL;
+    return member;
+  }
+
+  return NULL;
+}
+
+ERL_NIF_TERM nif_introspection_header_stamp_offset(ErlNifEnv *env, int argc,
+                                                   const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rosidl_message_type_support_t *ts_p;
+  if (!enif_get_resource(env, argv[0], rt_rosidl_message_type_support_t, (void **)&ts_p))
+    return enif_make_badarg(env);
+
+  const rosidl_message_type_support_t *introspection_ts_p =
+      get_message_typesupport_handle(ts_p, rosidl_typesupport_introspection_c__identifier);
+  if (introspection_ts_p == NULL)
+    return raise_with_message(env, __FILE__, __LINE__, "introspection type support not found");
+
+  const member_t *header =
+      find_message_member((const members_t *)introspection_ts_p->data, "header");
+  if (header == NULL) return raise_with_message(env, __FILE__, __LINE__, "no header member");
+
+  const member_t *stamp = find_message_member(header->members_->data, "stamp");
+  if (stamp == NULL) return raise_with_message(env, __FILE__, __LINE__, "no header.stamp member");
+
+  // the stamp is written natively as builtin_interfaces/msg/Time, make sure the layout matches
+  const members_t *time = stamp->members_->data;
+  if (time->member_count_ != 2 ||
+      time->members_[0].type_id_ != rosidl_typesupport_introspection_c__ROS_TYPE_INT32 ||
+      time->members_[0].offset_ != 0 ||
+      time->members_[1].type_id_ != rosidl_typesupport_introspection_c__ROS_TYPE_UINT32 ||
+      time->members_[1].offset_ != sizeof(int32_t))
+    return raise_with_message(env, __FILE__, __LINE__, "header.stamp is not a Time");
+
+  return enif_make_uint64(env, (ErlNifUInt64)header->offset_ + stamp->offset_);
+}
@@ -0,0 +1,13 @@
+#include <erl_nif.h>
+
+void introspection_plan_dtor(ErlNifEnv *env, void *obj);
+
+ERL_NIF_TERM nif_introspection_plan(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_get_map(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_introspection_header_stamp_offset(ErlNifEnv *env, int argc,
+                                                   const ERL_NIF_TERM argv[]);
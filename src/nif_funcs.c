@@ -1,9 +1,14 @@
+#include "allocator.h"
+#include "dynamic_type_support.h"
+#include "introspection.h"
 #include "macros.h"
 #include "msg_funcs.h" // IWYU pragma: keep
 #include "qos.h"
 #include "rcl_client.h"
 #include "rcl_clock.h"
+#include "rcl_event.h"
 #include "rcl_graph.h"
+#include "rcl_guard_condition.h"
 #include "rcl_init.h"
 #include "rcl_node.h"
 #include "rcl_publisher.h"
@@ -12,8 +17,11 @@
 #include "rcl_timer.h"
 #include "rcl_wait.h"
 #include "resource_types.h"
+#include "rmw_serialize.h"
 #include "srv_funcs.h" // IWYU pragma: keep
 #include "terms.h"
+#include "timer_service.h"
+#include "waiter.h"
 #include <erl_nif.h>
 #include <stddef.h>
 
@@ -41,6 +49,7 @@ static ErlNifFunc nif_funcs[] = {
     nif_io_bound_func(rcl_publisher_init, 4),
     nif_io_bound_func(rcl_publisher_fini, 2),
     nif_regular_func(rcl_publish, 2),
+    nif_regular_func(rcl_publish_with_stamp, 4),
     nif_io_bound_func(rcl_subscription_init, 4),
     nif_io_bound_func(rcl_subscription_fini, 2),
 #ifndef ROS_DISTRO_foxy
@@ -48,12 +57,25 @@ static ErlNifFunc nif_funcs[] = {
     nif_regular_func(rcl_subscription_clear_message_callback, 2),
 #endif
     nif_regular_func(rcl_take, 2),
-    nif_io_bound_func(rcl_clock_init, 0),
+    nif_io_bound_func(rcl_clock_init, 1),
     nif_io_bound_func(rcl_clock_fini, 1),
+    nif_regular_func(rcl_clock_get_now, 1),
+    nif_regular_func(rcl_enable_ros_time_override, 1),
+    nif_regular_func(rcl_disable_ros_time_override, 1),
+    nif_regular_func(rcl_set_ros_time_override, 2),
     nif_io_bound_func(rcl_timer_init, 3),
     nif_io_bound_func(rcl_timer_fini, 1),
     nif_io_bound_func(rcl_timer_is_ready, 1),
     nif_io_bound_func(rcl_timer_call, 1),
+    nif_regular_func(rcl_timer_exchange_period, 2),
+    nif_regular_func(rcl_timer_reset, 1),
+    nif_regular_func(rcl_timer_cancel, 1),
+    nif_regular_func(rcl_timer_is_canceled, 1),
+    nif_io_bound_func(timer_service_start, 1),
+    nif_io_bound_func(timer_service_stop, 1),
+    nif_io_bound_func(timer_service_add, 2),
+    nif_io_bound_func(timer_service_remove, 2),
+    nif_regular_func(timer_service_wake, 1),
     nif_io_bound_func(rcl_wait_set_init_subscription, 1),
     nif_io_bound_func(rcl_wait_set_init_client, 1),
     nif_io_bound_func(rcl_wait_set_init_service, 1),
@@ -63,6 +85,20 @@ static ErlNifFunc nif_funcs[] = {
     nif_io_bound_func(rcl_wait_client, 3),
     nif_io_bound_func(rcl_wait_service, 3),
     nif_io_bound_func(rcl_wait_timer, 3),
+    nif_io_bound_func(rcl_guard_condition_init, 1),
+    nif_io_bound_func(rcl_guard_condition_fini, 1),
+    nif_regular_func(rcl_trigger_guard_condition, 1),
+    nif_io_bound_func(waiter_start, 3),
+    nif_regular_func(waiter_arm, 1),
+    nif_io_bound_func(waiter_stop, 1),
+    nif_io_bound_func(rcl_publisher_event_init, 2),
+    nif_io_bound_func(rcl_subscription_event_init, 2),
+    nif_io_bound_func(rcl_event_fini, 1),
+    nif_regular_func(rcl_take_event, 1),
+#ifndef ROS_DISTRO_foxy
+    nif_regular_func(rcl_event_set_callback, 1),
+    nif_regular_func(rcl_event_clear_callback, 1),
+#endif
     nif_io_bound_func(rcl_service_init, 4),
     nif_io_bound_func(rcl_service_fini, 2),
 #ifndef ROS_DISTRO_foxy
@@ -82,6 +118,7 @@ static ErlNifFunc nif_funcs[] = {
     nif_regular_func(rcl_count_publishers, 2),
     nif_regular_func(rcl_count_subscribers, 2),
     nif_regular_func(rcl_get_client_names_and_types_by_node, 3),
+    nif_io_bound_func(rcl_get_graph_snapshot, 1),
     nif_regular_func(rcl_get_node_names, 1),
     nif_regular_func(rcl_get_node_names_with_enclaves, 1),
     nif_regular_func(rcl_get_publisher_names_and_types_by_node, 4),
@@ -100,6 +137,19 @@ static ErlNifFunc nif_funcs[] = {
     nif_regular_func(rmw_qos_profile_services_default, 0),
     nif_regular_func(rmw_qos_profile_parameter_events, 0),
     nif_regular_func(rmw_qos_profile_system_default, 0),
+    nif_regular_func(pool_allocator_stats, 0),
+    nif_regular_func(memory_stats, 0),
+    nif_regular_func(rmw_serialize, 2),
+    nif_regular_func(rmw_deserialize, 3),
+    nif_io_bound_func(introspection_plan, 1),
+    nif_regular_func(introspection_create, 1),
+    nif_regular_func(introspection_destroy, 2),
+    nif_regular_func(introspection_set, 3),
+    nif_regular_func(introspection_get, 2),
+    nif_regular_func(introspection_get_map, 2),
+    nif_regular_func(introspection_get_field, 3),
+    nif_io_bound_func(introspection_header_stamp_offset, 1),
+    nif_io_bound_func(dynamic_message_type_support, 3),
 #include "msg_funcs.ec" // IWYU pragma: keep
 #include "srv_funcs.ec" // IWYU pragma: keep
     // clang-format on
@@ -111,9 +161,15 @@ static int load(ErlNifEnv *env, void **priv_data, ERL_NIF_TERM load_info) {
 
   make_common_atoms(env);
   make_qos_atoms(env);
+  make_clock_atoms(env);
   make_subscription_atom(env);
   make_service_atom(env);
   make_client_atom(env);
+  make_timer_service_atom(env);
+  make_waiter_atoms(env);
+  make_event_atoms(env);
+
+  if (init_allocators(env) != 0) return 1;
 
   // open_resource_types/2 the 2nd argument is module_str, but document says following.
   // > Argument module_str is not (yet) used and must be NULL
@@ -1,5 +1,6 @@
 #include "rcl_client.h"
 #include "allocator.h"
+#include "macros.h"
 #include "qos.h"
 #include "resource_types.h"
 #include "terms.h"
@@ -11,12 +12,46 @@
 #include <rmw/types.h>
 #include <rmw/validate_full_topic_name.h>
 #include <rosidl_runtime_c/message_type_support_struct.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 ERL_NIF_TERM new_response;
 
 void make_client_atom(ErlNifEnv *env) { new_response = enif_make_atom(env, "new_response"); }
 
+typedef struct {
+  rcl_client_t client; // first, the resource is used as the rcl_client_t
+  rcl_node_t *node_p;
+} client_resource_t;
+
+void rcl_client_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  client_resource_t *resource_p = (client_resource_t *)obj;
+  if (rcl_client_is_valid(&resource_p->client))
+    rcl_client_fini(&resource_p->client, resource_p->node_p);
+  enif_release_resource(resource_p->node_p);
+}
+
+// The callback resource keeps its client, a callback that wasn't cleared is cleared when the
+// resource is garbage collected, so that the client never calls back with a freed pid.
+typedef struct {
+  ErlNifPid pid; // first, the resource is passed to the callback as the ErlNifPid
+  rcl_client_t *client_p;
+  bool set;
+} client_callback_resource_t;
+
+void client_callback_resource_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  client_callback_resource_t *resource_p = (client_callback_resource_t *)obj;
+#ifndef ROS_DISTRO_foxy
+  if (resource_p->set && rcl_client_is_valid(resource_p->client_p))
+    rcl_client_set_on_new_response_callback(resource_p->client_p, NULL, NULL);
+#endif
+  enif_release_resource(resource_p->client_p);
+}
+
 ERL_NIF_TERM nif_rcl_client_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
 
@@ -50,15 +85,18 @@ ERL_NIF_TERM nif_rcl_client_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM ar
   rcl_ret_t rc;
   rcl_client_t client                 = rcl_get_zero_initialized_client();
   rcl_client_options_t client_options = rcl_client_get_default_options();
-  client_options.allocator            = get_nif_allocator();
+  client_options.allocator            = get_nif_allocator(MEMORY_ENTITIES);
   client_options.qos                  = qos;
 
   rc = rcl_client_init(&client, node_p, ts_p, service_name, &client_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_client_t *obj = enif_alloc_resource(rt_rcl_client_t, sizeof(rcl_client_t));
-  *obj              = client;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_keep_resource(node_p);
+
+  client_resource_t *obj = enif_alloc_resource(rt_rcl_client_t, sizeof(client_resource_t));
+  obj->client            = client;
+  obj->node_p            = node_p;
+  ERL_NIF_TERM term      = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
   return term;
@@ -95,11 +133,14 @@ ERL_NIF_TERM nif_rcl_take_response_with_info(ErlNifEnv *env, int argc, const ERL
     return enif_make_badarg(env);
   if (!rcl_client_is_valid(client_p)) return raise(env, __FILE__, __LINE__);
 
-  void **ros_response_message_pp;
-  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_response_message_pp))
+  ros_message_t *ros_response_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_response_message_p))
     return enif_make_badarg(env);
+  void *response_message_p = acquire_ros_message(ros_response_message_p);
+  if (response_message_p == NULL) return enif_make_badarg(env);
 
-  rc = rcl_take_response_with_info(client_p, &request_header, *ros_response_message_pp);
+  rc = rcl_take_response_with_info(client_p, &request_header, response_message_p);
+  release_ros_message(ros_response_message_p);
   int64_t sequence_number = request_header.request_id.sequence_number;
 
   if (rc == RCL_RET_OK)
@@ -119,11 +160,14 @@ ERL_NIF_TERM nif_rcl_send_request(ErlNifEnv *env, int argc, const ERL_NIF_TERM a
     return enif_make_badarg(env);
   if (!rcl_client_is_valid(client_p)) return raise(env, __FILE__, __LINE__);
 
-  void **ros_request_message_pp;
-  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_request_message_pp))
+  ros_message_t *ros_request_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_request_message_p))
     return enif_make_badarg(env);
+  void *request_message_p = acquire_ros_message(ros_request_message_p);
+  if (request_message_p == NULL) return enif_make_badarg(env);
 
-  rc = rcl_send_request(client_p, *ros_request_message_pp, &sequence_number);
+  rc = rcl_send_request(client_p, request_message_p, &sequence_number);
+  release_ros_message(ros_request_message_p);
 
   if (rc == RCL_RET_OK)
     return enif_make_tuple2(env, atom_ok, enif_make_int64(env, sequence_number));
@@ -150,17 +194,22 @@ ERL_NIF_TERM nif_rcl_client_set_on_new_response_callback(ErlNifEnv *env, int arg
     return enif_make_badarg(env);
   if (!rcl_client_is_valid(client_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p =
-      (ErlNifPid *)enif_alloc_resource(rt_client_callback_resource, sizeof(ErlNifPid));
-  if (enif_self(env, pid_p) == NULL) return raise(env, __FILE__, __LINE__);
-  enif_keep_resource(pid_p);
+  client_callback_resource_t *obj =
+      enif_alloc_resource(rt_client_callback_resource, sizeof(client_callback_resource_t));
+  obj->client_p = client_p;
+  obj->set      = false;
+  enif_keep_resource(client_p);
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+  if (enif_self(env, &obj->pid) == NULL) return raise(env, __FILE__, __LINE__);
 
   rcl_ret_t rc;
-  rc =
-      rcl_client_set_on_new_response_callback(client_p, new_response_callback, (const void *)pid_p);
+  rc = rcl_client_set_on_new_response_callback(client_p, new_response_callback,
+                                               (const void *)&obj->pid);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+  obj->set = true;
 
-  return enif_make_resource(env, pid_p);
+  return term;
 }
 
 ERL_NIF_TERM nif_rcl_client_clear_response_callback(ErlNifEnv *env, int argc,
@@ -172,15 +221,15 @@ ERL_NIF_TERM nif_rcl_client_clear_response_callback(ErlNifEnv *env, int argc,
     return enif_make_badarg(env);
   if (!rcl_client_is_valid(client_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p = NULL;
-  if (!enif_get_resource(env, argv[1], rt_client_callback_resource, (void **)&pid_p))
+  client_callback_resource_t *resource_p;
+  if (!enif_get_resource(env, argv[1], rt_client_callback_resource, (void **)&resource_p))
     return enif_make_badarg(env);
 
   rcl_ret_t rc;
   rc = rcl_client_set_on_new_response_callback(client_p, NULL, NULL);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  enif_release_resource(pid_p);
+  resource_p->set = false;
 
   return atom_ok;
 }
@@ -8,22 +8,69 @@
 #include <rcl/time.h>
 #include <rcl/types.h>
 
+ERL_NIF_TERM atom_system;
+ERL_NIF_TERM atom_steady;
+ERL_NIF_TERM atom_ros;
+
+void make_clock_atoms(ErlNifEnv *env) {
+  atom_system = enif_make_atom(env, "system");
+  atom_steady = enif_make_atom(env, "steady");
+  atom_ros    = enif_make_atom(env, "ros");
+}
+
+// The jump callbacks of a clock are not synchronized by rcl. They are run by the override of a
+// ROS clock, from the node process, and added and removed by the timers on the clock, from the
+// timer processes, all of which hold the mutex of the clock meanwhile.
+typedef struct {
+  rcl_clock_t clock; // first, the resource is used as the rcl_clock_t
+  ErlNifMutex *mutex;
+} clock_resource_t;
+
+void rcl_clock_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  clock_resource_t *resource_p = (clock_resource_t *)obj;
+  if (rcl_clock_valid(&resource_p->clock)) rcl_clock_fini(&resource_p->clock);
+  if (resource_p->mutex != NULL) enif_mutex_destroy(resource_p->mutex);
+}
+
+void clock_lock(rcl_clock_t *clock_p) {
+  enif_mutex_lock(((clock_resource_t *)clock_p)->mutex);
+}
+
+void clock_unlock(rcl_clock_t *clock_p) {
+  enif_mutex_unlock(((clock_resource_t *)clock_p)->mutex);
+}
+
 ERL_NIF_TERM nif_rcl_clock_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  ignore_unused(argc);
-  ignore_unused(argv);
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_clock_type_t clock_type;
+  if (enif_is_identical(argv[0], atom_system)) {
+    clock_type = RCL_SYSTEM_TIME;
+  } else if (enif_is_identical(argv[0], atom_steady)) {
+    clock_type = RCL_STEADY_TIME;
+  } else if (enif_is_identical(argv[0], atom_ros)) {
+    clock_type = RCL_ROS_TIME;
+  } else {
+    return enif_make_badarg(env);
+  }
 
   rcl_ret_t rc;
   rcl_clock_t clock;
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
-  rc = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  rc = rcl_clock_init(clock_type, &clock, &allocator);
   if (rc != RCL_RET_OK) return enif_make_badarg(env);
 
-  rcl_clock_t *obj  = enif_alloc_resource(rt_rcl_clock_t, sizeof(rcl_clock_t));
-  *obj              = clock;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  clock_resource_t *obj = enif_alloc_resource(rt_rcl_clock_t, sizeof(clock_resource_t));
+  obj->clock            = clock;
+  obj->mutex            = enif_mutex_create("rclex_clock");
+  ERL_NIF_TERM term     = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
+  if (obj->mutex == NULL) return raise(env, __FILE__, __LINE__);
+
   return term;
 }
 
@@ -35,8 +82,82 @@ ERL_NIF_TERM nif_rcl_clock_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM arg
     return enif_make_badarg(env);
 
   rcl_ret_t rc;
+  clock_lock(clock_p);
   rc = rcl_clock_fini(clock_p);
+  clock_unlock(clock_p);
   if (rc != RCL_RET_OK) return enif_make_badarg(env);
 
+  // uninitialized, so that the destructor doesn't finalize it again
+  *clock_p = (rcl_clock_t){0};
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_clock_get_now(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_clock_t *clock_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_clock_t, (void **)&clock_p))
+    return enif_make_badarg(env);
+  if (!rcl_clock_valid(clock_p)) return raise(env, __FILE__, __LINE__);
+
+  rcl_ret_t rc;
+  rcl_time_point_value_t now;
+  rc = rcl_clock_get_now(clock_p, &now);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return enif_make_int64(env, now);
+}
+
+// Timers on a ROS clock are woken by its jump callbacks, triggered here, when it is overridden.
+static ERL_NIF_TERM ros_time_override(ErlNifEnv *env, ERL_NIF_TERM term,
+                                      rcl_ret_t (*fun)(rcl_clock_t *)) {
+  rcl_clock_t *clock_p;
+  if (!enif_get_resource(env, term, rt_rcl_clock_t, (void **)&clock_p))
+    return enif_make_badarg(env);
+  if (!rcl_clock_valid(clock_p)) return raise(env, __FILE__, __LINE__);
+  if (clock_p->type != RCL_ROS_TIME) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+  clock_lock(clock_p);
+  rc = fun(clock_p);
+  clock_unlock(clock_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_enable_ros_time_override(ErlNifEnv *env, int argc,
+                                              const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  return ros_time_override(env, argv[0], rcl_enable_ros_time_override);
+}
+
+ERL_NIF_TERM nif_rcl_disable_ros_time_override(ErlNifEnv *env, int argc,
+                                               const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  return ros_time_override(env, argv[0], rcl_disable_ros_time_override);
+}
+
+ERL_NIF_TERM nif_rcl_set_ros_time_override(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  rcl_clock_t *clock_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_clock_t, (void **)&clock_p))
+    return enif_make_badarg(env);
+  if (!rcl_clock_valid(clock_p)) return raise(env, __FILE__, __LINE__);
+  if (clock_p->type != RCL_ROS_TIME) return enif_make_badarg(env);
+
+  ErlNifSInt64 time;
+  if (!enif_get_int64(env, argv[1], &time) || time < 0) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+  clock_lock(clock_p);
+  rc = rcl_set_ros_time_override(clock_p, time);
+  clock_unlock(clock_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
   return atom_ok;
 }
@@ -1,4 +1,18 @@
 #include <erl_nif.h>
+#include <rcl/time.h>
+
+extern void make_clock_atoms(ErlNifEnv *env);
+extern void rcl_clock_dtor(ErlNifEnv *env, void *obj);
+
+// held around what adds, removes or runs the jump callbacks of the clock, see rcl_clock.c
+extern void clock_lock(rcl_clock_t *clock_p);
+extern void clock_unlock(rcl_clock_t *clock_p);
 
 ERL_NIF_TERM nif_rcl_clock_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_clock_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_clock_get_now(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_enable_ros_time_override(ErlNifEnv *env, int argc,
+                                              const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_disable_ros_time_override(ErlNifEnv *env, int argc,
+                                               const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_set_ros_time_override(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
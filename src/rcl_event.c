@@ -0,0 +1,337 @@
+#include "rcl_event.h"
+#include "macros.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rcl/event.h>
+#include <rcl/publisher.h>
+#include <rcl/subscription.h>
+#include <rcl/types.h>
+#include <rmw/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The QoS event of a publisher or subscription together with its type, an atom, which is given
+// to the owner with every notification, {:new_event, type, number_of_events}.
+typedef struct {
+  rcl_event_t event; // first, the resource is used as the rcl_event_t by the waiter
+  void *parent_p;    // the publisher or subscription, kept until the event is destroyed
+  ERL_NIF_TERM type;
+  ErlNifPid pid;
+  bool has_callback;
+} event_resource_t;
+
+ERL_NIF_TERM atom_new_event;
+ERL_NIF_TERM atom_event_take_failed;
+ERL_NIF_TERM atom_offered_deadline_missed;
+ERL_NIF_TERM atom_liveliness_lost;
+ERL_NIF_TERM atom_offered_incompatible_qos;
+ERL_NIF_TERM atom_requested_deadline_missed;
+ERL_NIF_TERM atom_liveliness_changed;
+ERL_NIF_TERM atom_requested_incompatible_qos;
+ERL_NIF_TERM atom_message_lost;
+ERL_NIF_TERM atom_total_count;
+ERL_NIF_TERM atom_total_count_change;
+ERL_NIF_TERM atom_alive_count;
+ERL_NIF_TERM atom_not_alive_count;
+ERL_NIF_TERM atom_alive_count_change;
+ERL_NIF_TERM atom_not_alive_count_change;
+ERL_NIF_TERM atom_last_policy_kind;
+
+void make_event_atoms(ErlNifEnv *env) {
+  atom_new_event                  = enif_make_atom(env, "new_event");
+  atom_event_take_failed          = enif_make_atom(env, "event_take_failed");
+  atom_offered_deadline_missed    = enif_make_atom(env, "offered_deadline_missed");
+  atom_liveliness_lost            = enif_make_atom(env, "liveliness_lost");
+  atom_offered_incompatible_qos   = enif_make_atom(env, "offered_incompatible_qos");
+  atom_requested_deadline_missed  = enif_make_atom(env, "requested_deadline_missed");
+  atom_liveliness_changed         = enif_make_atom(env, "liveliness_changed");
+  atom_requested_incompatible_qos = enif_make_atom(env, "requested_incompatible_qos");
+  atom_message_lost               = enif_make_atom(env, "message_lost");
+  atom_total_count                = enif_make_atom(env, "total_count");
+  atom_total_count_change         = enif_make_atom(env, "total_count_change");
+  atom_alive_count                = enif_make_atom(env, "alive_count");
+  atom_not_alive_count            = enif_make_atom(env, "not_alive_count");
+  atom_alive_count_change         = enif_make_atom(env, "alive_count_change");
+  atom_not_alive_count_change     = enif_make_atom(env, "not_alive_count_change");
+  atom_last_policy_kind           = enif_make_atom(env, "last_policy_kind");
+}
+
+ERL_NIF_TERM event_resource_type(const void *event_p) {
+  return ((const event_resource_t *)event_p)->type;
+}
+
+void rcl_event_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  // a callback keeps the resource, so it is cleared by now
+  event_resource_t *event_p = (event_resource_t *)obj;
+  rcl_event_fini(&event_p->event);
+  enif_release_resource(event_p->parent_p);
+}
+
+static ERL_NIF_TERM make_event_resource(ErlNifEnv *env, rcl_event_t event, void *parent_p,
+                                        ERL_NIF_TERM type) {
+  enif_keep_resource(parent_p);
+
+  event_resource_t *obj = enif_alloc_resource(rt_rcl_event_t, sizeof(event_resource_t));
+  *obj                  = (event_resource_t){.event = event, .parent_p = parent_p, .type = type};
+  ERL_NIF_TERM term     = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_rcl_publisher_event_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  rcl_publisher_t *publisher_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_publisher_t, (void **)&publisher_p))
+    return enif_make_badarg(env);
+  if (!rcl_publisher_is_valid(publisher_p)) return raise(env, __FILE__, __LINE__);
+
+  rcl_publisher_event_type_t event_type;
+  if (enif_is_identical(argv[1], atom_offered_deadline_missed)) {
+    event_type = RCL_PUBLISHER_OFFERED_DEADLINE_MISSED;
+  } else if (enif_is_identical(argv[1], atom_liveliness_lost)) {
+    event_type = RCL_PUBLISHER_LIVELINESS_LOST;
+  } else if (enif_is_identical(argv[1], atom_offered_incompatible_qos)) {
+    event_type = RCL_PUBLISHER_OFFERED_INCOMPATIBLE_QOS;
+  } else {
+    return enif_make_badarg(env);
+  }
+
+  rcl_ret_t rc;
+  rcl_event_t event = rcl_get_zero_initialized_event();
+
+  rc = rcl_publisher_event_init(&event, publisher_p, event_type);
+  if (rc == RCL_RET_UNSUPPORTED) return enif_make_badarg(env);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return make_event_resource(env, event, publisher_p, argv[1]);
+}
+
+ERL_NIF_TERM nif_rcl_subscription_event_init(ErlNifEnv *env, int argc,
+                                             const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  rcl_subscription_t *subscription_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_subscription_t, (void **)&subscription_p))
+    return enif_make_badarg(env);
+  if (!rcl_subscription_is_valid(subscription_p)) return raise(env, __FILE__, __LINE__);
+
+  rcl_subscription_event_type_t event_type;
+  if (enif_is_identical(argv[1], atom_requested_deadline_missed)) {
+    event_type = RCL_SUBSCRIPTION_REQUESTED_DEADLINE_MISSED;
+  } else if (enif_is_identical(argv[1], atom_liveliness_changed)) {
+    event_type = RCL_SUBSCRIPTION_LIVELINESS_CHANGED;
+  } else if (enif_is_identical(argv[1], atom_requested_incompatible_qos)) {
+    event_type = RCL_SUBSCRIPTION_REQUESTED_INCOMPATIBLE_QOS;
+#ifndef ROS_DISTRO_foxy
+  } else if (enif_is_identical(argv[1], atom_message_lost)) {
+    event_type = RCL_SUBSCRIPTION_MESSAGE_LOST;
+#endif
+  } else {
+    return enif_make_badarg(env);
+  }
+
+  rcl_ret_t rc;
+  rcl_event_t event = rcl_get_zero_initialized_event();
+
+  rc = rcl_subscription_event_init(&event, subscription_p, event_type);
+  if (rc == RCL_RET_UNSUPPORTED) return enif_make_badarg(env);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return make_event_resource(env, event, subscription_p, argv[1]);
+}
+
+#ifndef ROS_DISTRO_foxy
+static void new_event_callback(const void *user_data, size_t number_of_events) {
+  const event_resource_t *event_p = (const event_resource_t *)user_data;
+
+  ErlNifEnv *env = enif_alloc_env();
+  enif_send(env, &event_p->pid, env,
+            enif_make_tuple3(env, atom_new_event, event_p->type,
+                             enif_make_uint64(env, (ErlNifUInt64)number_of_events)));
+  enif_free_env(env);
+}
+
+static rcl_ret_t event_clear_callback(event_resource_t *event_p) {
+  if (!event_p->has_callback) return RCL_RET_OK;
+
+  rcl_ret_t rc = rcl_event_set_callback(&event_p->event, NULL, NULL);
+  if (rc == RCL_RET_OK) {
+    event_p->has_callback = false;
+    enif_release_resource(event_p);
+  }
+
+  return rc;
+}
+
+ERL_NIF_TERM nif_rcl_event_set_callback(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  event_resource_t *event_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_event_t, (void **)&event_p))
+    return enif_make_badarg(env);
+  if (!rcl_event_is_valid(&event_p->event)) return raise(env, __FILE__, __LINE__);
+  if (event_p->has_callback) return enif_make_badarg(env);
+
+  if (enif_self(env, &event_p->pid) == NULL) return raise(env, __FILE__, __LINE__);
+
+  // the callback refers to the resource, keep it until the callback is cleared
+  enif_keep_resource(event_p);
+
+  rcl_ret_t rc;
+  rc = rcl_event_set_callback(&event_p->event, new_event_callback, (const void *)event_p);
+  if (rc != RCL_RET_OK) {
+    enif_release_resource(event_p);
+    return raise(env, __FILE__, __LINE__);
+  }
+  event_p->has_callback = true;
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_event_clear_callback(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  event_resource_t *event_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_event_t, (void **)&event_p))
+    return enif_make_badarg(env);
+  if (!rcl_event_is_valid(&event_p->event)) return raise(env, __FILE__, __LINE__);
+
+  if (event_clear_callback(event_p) != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+#endif
+
+ERL_NIF_TERM nif_rcl_event_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  event_resource_t *event_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_event_t, (void **)&event_p))
+    return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+#ifndef ROS_DISTRO_foxy
+  rc = event_clear_callback(event_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+#endif
+
+  rc = rcl_event_fini(&event_p->event);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+static ERL_NIF_TERM make_count_status(ErlNifEnv *env, int32_t total_count,
+                                      int32_t total_count_change) {
+  ERL_NIF_TERM keys[]   = {atom_total_count, atom_total_count_change};
+  ERL_NIF_TERM values[] = {enif_make_int(env, total_count), enif_make_int(env, total_count_change)};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 2, &map);
+  return map;
+}
+
+static ERL_NIF_TERM make_policy_kind(ErlNifEnv *env, rmw_qos_policy_kind_t kind) {
+  switch (kind) {
+  case RMW_QOS_POLICY_DURABILITY:
+    return enif_make_atom(env, "durability");
+  case RMW_QOS_POLICY_DEADLINE:
+    return enif_make_atom(env, "deadline");
+  case RMW_QOS_POLICY_LIVELINESS:
+    return enif_make_atom(env, "liveliness");
+  case RMW_QOS_POLICY_RELIABILITY:
+    return enif_make_atom(env, "reliability");
+  case RMW_QOS_POLICY_HISTORY:
+    return enif_make_atom(env, "history");
+  case RMW_QOS_POLICY_LIFESPAN:
+    return enif_make_atom(env, "lifespan");
+#ifndef ROS_DISTRO_foxy
+  case RMW_QOS_POLICY_DEPTH:
+    return enif_make_atom(env, "depth");
+  case RMW_QOS_POLICY_LIVELINESS_LEASE_DURATION:
+    return enif_make_atom(env, "liveliness_lease_duration");
+  case RMW_QOS_POLICY_AVOID_ROS_NAMESPACE_CONVENTIONS:
+    return enif_make_atom(env, "avoid_ros_namespace_conventions");
+#endif
+  default:
+    return enif_make_atom(env, "invalid");
+  }
+}
+
+static ERL_NIF_TERM make_incompatible_qos_status(ErlNifEnv *env,
+                                                 rmw_qos_incompatible_event_status_t status) {
+  ERL_NIF_TERM keys[]   = {atom_total_count, atom_total_count_change, atom_last_policy_kind};
+  ERL_NIF_TERM values[] = {enif_make_int(env, status.total_count),
+                           enif_make_int(env, status.total_count_change),
+                           make_policy_kind(env, status.last_policy_kind)};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 3, &map);
+  return map;
+}
+
+static ERL_NIF_TERM make_liveliness_changed_status(ErlNifEnv *env,
+                                                   rmw_liveliness_changed_status_t status) {
+  ERL_NIF_TERM keys[]   = {atom_alive_count, atom_not_alive_count, atom_alive_count_change,
+                           atom_not_alive_count_change};
+  ERL_NIF_TERM values[] = {enif_make_int(env, status.alive_count),
+                           enif_make_int(env, status.not_alive_count),
+                           enif_make_int(env, status.alive_count_change),
+                           enif_make_int(env, status.not_alive_count_change)};
+
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 4, &map);
+  return map;
+}
+
+// Returns the status of the event as a map, its counts since the last take are the *_change.
+ERL_NIF_TERM nif_rcl_take_event(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  event_resource_t *event_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_event_t, (void **)&event_p))
+    return enif_make_badarg(env);
+  if (!rcl_event_is_valid(&event_p->event)) return raise(env, __FILE__, __LINE__);
+
+  rcl_ret_t rc;
+  ERL_NIF_TERM type = event_p->type;
+
+  if (enif_is_identical(type, atom_offered_deadline_missed) ||
+      enif_is_identical(type, atom_requested_deadline_missed) ||
+      enif_is_identical(type, atom_liveliness_lost)) {
+    // the statuses of these three events have the same layout
+    rmw_offered_deadline_missed_status_t status;
+    rc = rcl_take_event(&event_p->event, &status);
+    if (rc == RCL_RET_OK)
+      return make_count_status(env, status.total_count, status.total_count_change);
+  } else if (enif_is_identical(type, atom_offered_incompatible_qos) ||
+             enif_is_identical(type, atom_requested_incompatible_qos)) {
+    rmw_qos_incompatible_event_status_t status;
+    rc = rcl_take_event(&event_p->event, &status);
+    if (rc == RCL_RET_OK) return make_incompatible_qos_status(env, status);
+  } else if (enif_is_identical(type, atom_liveliness_changed)) {
+    rmw_liveliness_changed_status_t status;
+    rc = rcl_take_event(&event_p->event, &status);
+    if (rc == RCL_RET_OK) return make_liveliness_changed_status(env, status);
+#ifndef ROS_DISTRO_foxy
+  } else if (enif_is_identical(type, atom_message_lost)) {
+    rmw_message_lost_status_t status;
+    rc = rcl_take_event(&event_p->event, &status);
+    if (rc == RCL_RET_OK)
+      return make_count_status(env, (int32_t)status.total_count,
+                               (int32_t)status.total_count_change);
+#endif
+  } else {
+    return raise(env, __FILE__, __LINE__);
+  }
+
+  if (rc == RCL_RET_EVENT_TAKE_FAILED) return atom_event_take_failed;
+  return raise(env, __FILE__, __LINE__);
+}
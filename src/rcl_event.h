@@ -0,0 +1,15 @@
+#include <erl_nif.h>
+
+extern void make_event_atoms(ErlNifEnv *env);
+extern ERL_NIF_TERM event_resource_type(const void *event_p);
+extern void rcl_event_dtor(ErlNifEnv *env, void *obj);
+
+ERL_NIF_TERM nif_rcl_publisher_event_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_subscription_event_init(ErlNifEnv *env, int argc,
+                                             const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_event_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_take_event(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+#ifndef ROS_DISTRO_foxy
+ERL_NIF_TERM nif_rcl_event_set_callback(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_event_clear_callback(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+#endif
@@ -2,6 +2,7 @@
 #include "allocator.h"
 #include "macros.h"
 #include "qos.h"
+#include "rcl_node.h"
 #include "resource_types.h"
 #include "terms.h"
 #include <erl_nif.h>
@@ -10,32 +11,31 @@
 #include <rcl/time.h>
 #include <rcl/types.h>
 
+// the lists are built from their last element, so that no array of terms has to be allocated
 static inline ERL_NIF_TERM
 make_names_and_types(ErlNifEnv *env, const rcl_names_and_types_t *topic_names_and_types) {
-  rcutils_string_array_t names        = topic_names_and_types->names;
-  rcutils_string_array_t *types       = topic_names_and_types->types;
-  int names_length                    = names.size;
-  ERL_NIF_TERM *names_and_types_array = enif_alloc(sizeof(ERL_NIF_TERM) * names_length);
-
-  for (int i = 0; i < names_length; i++) {
-    int types_length          = types[i].size;
-    ERL_NIF_TERM *types_array = enif_alloc(sizeof(ERL_NIF_TERM) * types_length);
-    for (int j = 0; j < types_length; j++) {
-      types_array[j] = enif_make_string(env, types[i].data[j], ERL_NIF_LATIN1);
+  rcutils_string_array_t names  = topic_names_and_types->names;
+  rcutils_string_array_t *types = topic_names_and_types->types;
+  ERL_NIF_TERM names_and_types  = enif_make_list(env, 0);
+
+  for (size_t i = names.size; i-- > 0;) {
+    ERL_NIF_TERM types_list = enif_make_list(env, 0);
+    for (size_t j = types[i].size; j-- > 0;) {
+      ERL_NIF_TERM type = enif_make_string(env, types[i].data[j], ERL_NIF_LATIN1);
+      types_list        = enif_make_list_cell(env, type, types_list);
     }
-    names_and_types_array[i] =
-        enif_make_tuple2(env, enif_make_string(env, names.data[i], ERL_NIF_LATIN1),
-                         enif_make_list_from_array(env, types_array, types_length));
+    ERL_NIF_TERM name_and_types =
+        enif_make_tuple2(env, enif_make_string(env, names.data[i], ERL_NIF_LATIN1), types_list);
+    names_and_types = enif_make_list_cell(env, name_and_types, names_and_types);
   }
 
-  return enif_make_list_from_array(env, names_and_types_array, names_length);
+  return names_and_types;
 }
 
 static inline ERL_NIF_TERM
 make_topic_endpoint_info_list(ErlNifEnv *env,
                               const rcl_topic_endpoint_info_array_t *topic_endpoint_info) {
-  int info_length          = topic_endpoint_info->size;
-  ERL_NIF_TERM *info_array = enif_alloc(sizeof(ERL_NIF_TERM) * info_length);
+  ERL_NIF_TERM info_list = enif_make_list(env, 0);
 
   ERL_NIF_TERM atom_invalid      = enif_make_atom(env, "invalid");
   ERL_NIF_TERM atom_publisher    = enif_make_atom(env, "publisher");
@@ -46,8 +46,7 @@ make_topic_endpoint_info_list(ErlNifEnv *env,
       enif_make_atom(env, "topic_type"),   enif_make_atom(env, "endpoint_type"),
       enif_make_atom(env, "endpoint_gid"), enif_make_atom(env, "qos_profile")};
 
-  for (int i = 0; i < info_length; i++) {
-
+  for (size_t i = topic_endpoint_info->size; i-- > 0;) {
     ErlNifBinary bin_gid;
     if (!enif_alloc_binary(RMW_GID_STORAGE_SIZE, &bin_gid)) {
       return raise(env, __FILE__, __LINE__);
@@ -70,15 +69,17 @@ make_topic_endpoint_info_list(ErlNifEnv *env,
         enif_make_binary(env, &bin_gid),
         get_ex_qos_profile(env, topic_endpoint_info->info_array[i].qos_profile)};
 
-    if (!enif_make_map_from_arrays(env, keys, values, 6, &info_array[i])) {
+    ERL_NIF_TERM info;
+    if (!enif_make_map_from_arrays(env, keys, values, 6, &info)) {
       return raise(env, __FILE__, __LINE__);
     }
+    info_list = enif_make_list_cell(env, info, info_list);
   }
 
-  return enif_make_list_from_array(env, info_array, info_length);
+  return info_list;
 }
 
-ERL_NIF_TERM nif_rcl_count_publishers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_count_publishers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -104,7 +105,7 @@ ERL_NIF_TERM nif_rcl_count_publishers(ErlNifEnv *env, int argc, const ERL_NIF_TE
     return raise_with_message(env, __FILE__, __LINE__, "unspecified error");
 }
 
-ERL_NIF_TERM nif_rcl_count_subscribers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_count_subscribers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -130,8 +131,8 @@ ERL_NIF_TERM nif_rcl_count_subscribers(ErlNifEnv *env, int argc, const ERL_NIF_T
     return raise_with_message(env, __FILE__, __LINE__, "unspecified error");
 }
 
-ERL_NIF_TERM nif_rcl_get_client_names_and_types_by_node(ErlNifEnv *env, int argc,
-                                                        const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_client_names_and_types_by_node(ErlNifEnv *env, int argc,
+                                                             const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -149,7 +150,7 @@ ERL_NIF_TERM nif_rcl_get_client_names_and_types_by_node(ErlNifEnv *env, int argc
 
   rcl_ret_t rc;
   rcl_names_and_types_t client_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                    = get_nif_allocator();
+  rcl_allocator_t allocator                    = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                            = atom_error;
 
   rc = rcl_get_client_names_and_types_by_node(node_p, &allocator, node_name, node_namespace,
@@ -182,7 +183,7 @@ ERL_NIF_TERM nif_rcl_get_client_names_and_types_by_node(ErlNifEnv *env, int argc
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_node_names(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_node_names(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -193,7 +194,7 @@ ERL_NIF_TERM nif_rcl_get_node_names(ErlNifEnv *env, int argc, const ERL_NIF_TERM
   rcl_ret_t rc;
   rcutils_string_array_t node_names      = rcutils_get_zero_initialized_string_array();
   rcutils_string_array_t node_namespaces = rcutils_get_zero_initialized_string_array();
-  rcl_allocator_t allocator              = get_nif_allocator();
+  rcl_allocator_t allocator              = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                      = atom_error;
 
   rc = rcl_get_node_names(node_p, allocator, &node_names, &node_namespaces);
@@ -234,8 +235,8 @@ ERL_NIF_TERM nif_rcl_get_node_names(ErlNifEnv *env, int argc, const ERL_NIF_TERM
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_node_names_with_enclaves(ErlNifEnv *env, int argc,
-                                                  const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_node_names_with_enclaves(ErlNifEnv *env, int argc,
+                                                       const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -247,7 +248,7 @@ ERL_NIF_TERM nif_rcl_get_node_names_with_enclaves(ErlNifEnv *env, int argc,
   rcutils_string_array_t node_names      = rcutils_get_zero_initialized_string_array();
   rcutils_string_array_t node_namespaces = rcutils_get_zero_initialized_string_array();
   rcutils_string_array_t node_enclaves   = rcutils_get_zero_initialized_string_array();
-  rcl_allocator_t allocator              = get_nif_allocator();
+  rcl_allocator_t allocator              = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                      = atom_error;
 
   rc = rcl_get_node_names_with_enclaves(node_p, allocator, &node_names, &node_namespaces,
@@ -295,8 +296,8 @@ ERL_NIF_TERM nif_rcl_get_node_names_with_enclaves(ErlNifEnv *env, int argc,
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_publisher_names_and_types_by_node(ErlNifEnv *env, int argc,
-                                                           const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_publisher_names_and_types_by_node(ErlNifEnv *env, int argc,
+                                                                const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -322,7 +323,7 @@ ERL_NIF_TERM nif_rcl_get_publisher_names_and_types_by_node(ErlNifEnv *env, int a
 
   rcl_ret_t rc;
   rcl_names_and_types_t topic_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                   = get_nif_allocator();
+  rcl_allocator_t allocator                   = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                           = atom_error;
 
   rc = rcl_get_publisher_names_and_types_by_node(node_p, &allocator, no_demangle, node_name,
@@ -355,8 +356,8 @@ ERL_NIF_TERM nif_rcl_get_publisher_names_and_types_by_node(ErlNifEnv *env, int a
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_publishers_info_by_topic(ErlNifEnv *env, int argc,
-                                                  const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_publishers_info_by_topic(ErlNifEnv *env, int argc,
+                                                       const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -379,7 +380,7 @@ ERL_NIF_TERM nif_rcl_get_publishers_info_by_topic(ErlNifEnv *env, int argc,
   rcl_ret_t rc;
   rcl_topic_endpoint_info_array_t publishers_info =
       rmw_get_zero_initialized_topic_endpoint_info_array();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term         = atom_error;
 
   rc =
@@ -405,8 +406,8 @@ ERL_NIF_TERM nif_rcl_get_publishers_info_by_topic(ErlNifEnv *env, int argc,
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_service_names_and_types(ErlNifEnv *env, int argc,
-                                                 const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_service_names_and_types(ErlNifEnv *env, int argc,
+                                                      const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -416,7 +417,7 @@ ERL_NIF_TERM nif_rcl_get_service_names_and_types(ErlNifEnv *env, int argc,
 
   rcl_ret_t rc;
   rcl_names_and_types_t service_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                     = get_nif_allocator();
+  rcl_allocator_t allocator                     = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                             = atom_error;
 
   rc = rcl_get_service_names_and_types(node_p, &allocator, &service_names_and_types);
@@ -439,8 +440,8 @@ ERL_NIF_TERM nif_rcl_get_service_names_and_types(ErlNifEnv *env, int argc,
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_service_names_and_types_by_node(ErlNifEnv *env, int argc,
-                                                         const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_service_names_and_types_by_node(ErlNifEnv *env, int argc,
+                                                              const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -458,7 +459,7 @@ ERL_NIF_TERM nif_rcl_get_service_names_and_types_by_node(ErlNifEnv *env, int arg
 
   rcl_ret_t rc;
   rcl_names_and_types_t service_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                     = get_nif_allocator();
+  rcl_allocator_t allocator                     = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                             = atom_error;
 
   rc = rcl_get_service_names_and_types_by_node(node_p, &allocator, node_name, node_namespace,
@@ -488,8 +489,8 @@ ERL_NIF_TERM nif_rcl_get_service_names_and_types_by_node(ErlNifEnv *env, int arg
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_subscriber_names_and_types_by_node(ErlNifEnv *env, int argc,
-                                                            const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_subscriber_names_and_types_by_node(ErlNifEnv *env, int argc,
+                                                                 const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -515,7 +516,7 @@ ERL_NIF_TERM nif_rcl_get_subscriber_names_and_types_by_node(ErlNifEnv *env, int
 
   rcl_ret_t rc;
   rcl_names_and_types_t topic_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                   = get_nif_allocator();
+  rcl_allocator_t allocator                   = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                           = atom_error;
 
   rc = rcl_get_subscriber_names_and_types_by_node(node_p, &allocator, no_demangle, node_name,
@@ -548,8 +549,8 @@ ERL_NIF_TERM nif_rcl_get_subscriber_names_and_types_by_node(ErlNifEnv *env, int
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_subscribers_info_by_topic(ErlNifEnv *env, int argc,
-                                                   const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_subscribers_info_by_topic(ErlNifEnv *env, int argc,
+                                                        const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -572,7 +573,7 @@ ERL_NIF_TERM nif_rcl_get_subscribers_info_by_topic(ErlNifEnv *env, int argc,
   rcl_ret_t rc;
   rcl_topic_endpoint_info_array_t subscribers_info =
       rmw_get_zero_initialized_topic_endpoint_info_array();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term         = atom_error;
 
   rc = rcl_get_subscriptions_info_by_topic(node_p, &allocator, topic_name, no_mangle,
@@ -598,8 +599,8 @@ ERL_NIF_TERM nif_rcl_get_subscribers_info_by_topic(ErlNifEnv *env, int argc,
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_get_topic_names_and_types(ErlNifEnv *env, int argc,
-                                               const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_get_topic_names_and_types(ErlNifEnv *env, int argc,
+                                                    const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -617,7 +618,7 @@ ERL_NIF_TERM nif_rcl_get_topic_names_and_types(ErlNifEnv *env, int argc,
 
   rcl_ret_t rc;
   rcl_names_and_types_t topic_names_and_types = rmw_get_zero_initialized_names_and_types();
-  rcl_allocator_t allocator                   = get_nif_allocator();
+  rcl_allocator_t allocator                   = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term                           = atom_error;
 
   rc = rcl_get_topic_names_and_types(node_p, &allocator, no_demangle, &topic_names_and_types);
@@ -640,8 +641,8 @@ ERL_NIF_TERM nif_rcl_get_topic_names_and_types(ErlNifEnv *env, int argc,
   return term;
 }
 
-ERL_NIF_TERM nif_rcl_service_server_is_available(ErlNifEnv *env, int argc,
-                                                 const ERL_NIF_TERM argv[]) {
+static ERL_NIF_TERM graph_service_server_is_available(ErlNifEnv *env, int argc,
+                                                      const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
   rcl_node_t *node_p;
@@ -674,6 +675,91 @@ ERL_NIF_TERM nif_rcl_service_server_is_available(ErlNifEnv *env, int argc,
   return term;
 }
 
+// The whole graph in one call: the nodes with their enclaves, the topics and the services with
+// their types, and the publishers and subscriptions of each topic. The results of rcl are taken
+// from an arena, which is freed at once when the terms are made.
+static ERL_NIF_TERM make_graph_snapshot(ErlNifEnv *env, const rcl_node_t *node_p,
+                                        rcl_allocator_t *allocator_p) {
+  rcl_ret_t rc;
+  rcutils_string_array_t node_names             = rcutils_get_zero_initialized_string_array();
+  rcutils_string_array_t node_namespaces        = rcutils_get_zero_initialized_string_array();
+  rcutils_string_array_t node_enclaves          = rcutils_get_zero_initialized_string_array();
+  rcl_names_and_types_t topic_names_and_types   = rmw_get_zero_initialized_names_and_types();
+  rcl_names_and_types_t service_names_and_types = rmw_get_zero_initialized_names_and_types();
+
+  rc = rcl_get_node_names_with_enclaves(node_p, *allocator_p, &node_names, &node_namespaces,
+                                        &node_enclaves);
+  if (rc != RCL_RET_OK) return raise_with_message(env, __FILE__, __LINE__, "node names failed");
+
+  rc = rcl_get_topic_names_and_types(node_p, allocator_p, false, &topic_names_and_types);
+  if (rc != RCL_RET_OK) return raise_with_message(env, __FILE__, __LINE__, "topic names failed");
+
+  rc = rcl_get_service_names_and_types(node_p, allocator_p, &service_names_and_types);
+  if (rc != RCL_RET_OK)
+    return raise_with_message(env, __FILE__, __LINE__, "service names failed");
+
+  ERL_NIF_TERM nodes = enif_make_list(env, 0);
+  for (size_t i = node_names.size; i-- > 0;) {
+    ERL_NIF_TERM node_name      = enif_make_string(env, node_names.data[i], ERL_NIF_LATIN1);
+    ERL_NIF_TERM node_namespace = enif_make_string(env, node_namespaces.data[i], ERL_NIF_LATIN1);
+    ERL_NIF_TERM node_enclave   = enif_make_string(env, node_enclaves.data[i], ERL_NIF_LATIN1);
+    ERL_NIF_TERM node           = enif_make_tuple3(env, node_name, node_namespace, node_enclave);
+    nodes                       = enif_make_list_cell(env, node, nodes);
+  }
+
+  ERL_NIF_TERM endpoints = enif_make_list(env, 0);
+  for (size_t i = topic_names_and_types.names.size; i-- > 0;) {
+    const char *topic_name = topic_names_and_types.names.data[i];
+    rcl_topic_endpoint_info_array_t publishers_info =
+        rmw_get_zero_initialized_topic_endpoint_info_array();
+    rcl_topic_endpoint_info_array_t subscribers_info =
+        rmw_get_zero_initialized_topic_endpoint_info_array();
+
+    rc = rcl_get_publishers_info_by_topic(node_p, allocator_p, topic_name, false,
+                                          &publishers_info);
+    if (rc != RCL_RET_OK) return raise_with_message(env, __FILE__, __LINE__, "publishers failed");
+
+    rc = rcl_get_subscriptions_info_by_topic(node_p, allocator_p, topic_name, false,
+                                             &subscribers_info);
+    if (rc != RCL_RET_OK)
+      return raise_with_message(env, __FILE__, __LINE__, "subscriptions failed");
+
+    ERL_NIF_TERM topic_endpoints =
+        enif_make_tuple3(env, enif_make_string(env, topic_name, ERL_NIF_LATIN1),
+                         make_topic_endpoint_info_list(env, &publishers_info),
+                         make_topic_endpoint_info_list(env, &subscribers_info));
+    endpoints = enif_make_list_cell(env, topic_endpoints, endpoints);
+  }
+
+  ERL_NIF_TERM keys[]   = {enif_make_atom(env, "nodes"), enif_make_atom(env, "topics"),
+                           enif_make_atom(env, "services"), enif_make_atom(env, "endpoints")};
+  ERL_NIF_TERM values[] = {nodes, make_names_and_types(env, &topic_names_and_types),
+                           make_names_and_types(env, &service_names_and_types), endpoints};
+
+  ERL_NIF_TERM map;
+  if (!enif_make_map_from_arrays(env, keys, values, 4, &map)) return raise(env, __FILE__, __LINE__);
+  return map;
+}
+
+static ERL_NIF_TERM graph_get_graph_snapshot(ErlNifEnv *env, int argc,
+                                             const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_node_t *node_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_node_t, (void **)&node_p))
+    return enif_make_badarg(env);
+  if (!rcl_node_is_valid(node_p)) return raise(env, __FILE__, __LINE__);
+
+  arena_t *arena_p = arena_new(MEMORY_GRAPH);
+  if (arena_p == NULL) return raise(env, __FILE__, __LINE__);
+
+  rcl_allocator_t allocator = get_arena_allocator(arena_p);
+  ERL_NIF_TERM term         = make_graph_snapshot(env, node_p, &allocator);
+  arena_free(arena_p);
+
+  return term;
+}
+
 /*
 ERL_NIF_TERM nif_rcl_wait_for_publishers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
@@ -695,7 +781,7 @@ ERL_NIF_TERM nif_rcl_wait_for_publishers(ErlNifEnv *env, int argc, const ERL_NIF
 
   bool success;
   rcl_ret_t rc;
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term         = atom_false;
   rc = rcl_wait_for_publishers(node_p, &allocator, topic_name, count, timeout, &success);
   if (rc == RCL_RET_OK) { // if the query was successful
@@ -742,7 +828,7 @@ ERL_NIF_TERM nif_rcl_wait_for_subscribers(ErlNifEnv *env, int argc, const ERL_NI
 
   bool success;
   rcl_ret_t rc;
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_GRAPH);
   ERL_NIF_TERM term         = atom_false;
   rc = rcl_wait_for_subscribers(node_p, &allocator, topic_name, count, timeout, &success);
   if (rc == RCL_RET_OK) { // if the query was successful
@@ -766,4 +852,43 @@ ERL_NIF_TERM nif_rcl_wait_for_subscribers(ErlNifEnv *env, int argc, const ERL_NI
 
   return term;
 }
-*/
\ No newline at end of file
+*/
+
+typedef ERL_NIF_TERM (*graph_query_t)(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+// The queries run in the processes that ask them, the node, their first argument, is held for
+// reading meanwhile so that it can't be finalized under them.
+static ERL_NIF_TERM with_node_read_lock(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[],
+                                        graph_query_t query) {
+  rcl_node_t *node_p;
+  if (argc < 1 || !enif_get_resource(env, argv[0], rt_rcl_node_t, (void **)&node_p))
+    return enif_make_badarg(env);
+
+  node_read_lock(node_p);
+  ERL_NIF_TERM term = query(env, argc, argv);
+  node_read_unlock(node_p);
+
+  return term;
+}
+
+#define nif_graph_query(name)                                                                      \
+  ERL_NIF_TERM nif_rcl_##name(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {               \
+    return with_node_read_lock(env, argc, argv, graph_##name);                                     \
+  }
+
+// clang-format off
+nif_graph_query(count_publishers)
+nif_graph_query(count_subscribers)
+nif_graph_query(get_client_names_and_types_by_node)
+nif_graph_query(get_graph_snapshot)
+nif_graph_query(get_node_names)
+nif_graph_query(get_node_names_with_enclaves)
+nif_graph_query(get_publisher_names_and_types_by_node)
+nif_graph_query(get_publishers_info_by_topic)
+nif_graph_query(get_service_names_and_types)
+nif_graph_query(get_service_names_and_types_by_node)
+nif_graph_query(get_subscriber_names_and_types_by_node)
+nif_graph_query(get_subscribers_info_by_topic)
+nif_graph_query(get_topic_names_and_types)
+nif_graph_query(service_server_is_available)
+// clang-format on
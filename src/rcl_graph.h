@@ -4,6 +4,7 @@ ERL_NIF_TERM nif_rcl_count_publishers(ErlNifEnv *env, int argc, const ERL_NIF_TE
 ERL_NIF_TERM nif_rcl_count_subscribers(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_get_client_names_and_types_by_node(ErlNifEnv *env, int argc,
                                                         const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_get_graph_snapshot(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_get_node_names(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_get_node_names_with_enclaves(ErlNifEnv *env, int argc,
                                                   const ERL_NIF_TERM argv[]);
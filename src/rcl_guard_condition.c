@@ -0,0 +1,78 @@
+#include "rcl_guard_condition.h"
+#include "macros.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rcl/context.h>
+#include <rcl/guard_condition.h>
+#include <rcl/types.h>
+
+typedef struct {
+  rcl_guard_condition_t guard_condition; // first, the resource is used as the rcl_guard_condition_t
+  rcl_context_t *context_p;
+} guard_condition_resource_t;
+
+void rcl_guard_condition_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  guard_condition_resource_t *resource_p = (guard_condition_resource_t *)obj;
+  rcl_guard_condition_fini(&resource_p->guard_condition);
+  enif_release_resource(resource_p->context_p);
+}
+
+ERL_NIF_TERM nif_rcl_guard_condition_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_context_t *context_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_context_t, (void **)&context_p))
+    return enif_make_badarg(env);
+  if (!rcl_context_is_valid(context_p)) return raise(env, __FILE__, __LINE__);
+
+  rcl_ret_t rc;
+  rcl_guard_condition_t guard_condition = rcl_get_zero_initialized_guard_condition();
+
+  rc = rcl_guard_condition_init(&guard_condition, context_p,
+                                rcl_guard_condition_get_default_options());
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  enif_keep_resource(context_p);
+
+  guard_condition_resource_t *obj =
+      enif_alloc_resource(rt_rcl_guard_condition_t, sizeof(guard_condition_resource_t));
+  obj->guard_condition = guard_condition;
+  obj->context_p       = context_p;
+  ERL_NIF_TERM term    = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_rcl_guard_condition_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_guard_condition_t *guard_condition_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_guard_condition_t, (void **)&guard_condition_p))
+    return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+  rc = rcl_guard_condition_fini(guard_condition_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+// Triggering is thread safe, it wakes any wait set the guard condition is in, e.g. of a waiter.
+ERL_NIF_TERM nif_rcl_trigger_guard_condition(ErlNifEnv *env, int argc,
+                                             const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_guard_condition_t *guard_condition_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_guard_condition_t, (void **)&guard_condition_p))
+    return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+  rc = rcl_trigger_guard_condition(guard_condition_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
@@ -0,0 +1,8 @@
+#include <erl_nif.h>
+
+extern void rcl_guard_condition_dtor(ErlNifEnv *env, void *obj);
+
+ERL_NIF_TERM nif_rcl_guard_condition_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_guard_condition_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_trigger_guard_condition(ErlNifEnv *env, int argc,
+                                             const ERL_NIF_TERM argv[]);
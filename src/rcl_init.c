@@ -11,6 +11,15 @@
 #include <rcl/types.h>
 #include <stddef.h>
 
+// Runs once no entity initialized with the context is left, as they all keep it.
+void rcl_context_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  rcl_context_t *context_p = (rcl_context_t *)obj;
+  if (rcl_context_is_valid(context_p)) rcl_shutdown(context_p);
+  rcl_context_fini(context_p);
+}
+
 ERL_NIF_TERM nif_rcl_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -18,7 +27,7 @@ ERL_NIF_TERM nif_rcl_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
 
   rcl_ret_t rc;
   rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
-  rcl_allocator_t allocator       = get_nif_allocator();
+  rcl_allocator_t allocator       = get_nif_allocator(MEMORY_ENTITIES);
   rcl_context_t context           = rcl_get_zero_initialized_context();
 
   rc = rcl_init_options_init(&init_options, allocator);
@@ -1,4 +1,6 @@
 #include <erl_nif.h>
 
+extern void rcl_context_dtor(ErlNifEnv *env, void *obj);
+
 extern ERL_NIF_TERM nif_rcl_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 extern ERL_NIF_TERM nif_rcl_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
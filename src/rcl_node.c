@@ -1,5 +1,6 @@
 #include "rcl_node.h"
 #include "allocator.h"
+#include "macros.h"
 #include "resource_types.h"
 #include "terms.h"
 #include <erl_nif.h>
@@ -12,6 +13,32 @@
 #include <rmw/validate_node_name.h>
 #include <stddef.h>
 
+// Graph queries run from the processes that ask them, concurrently with each other and with the
+// node process. They hold the lock of the node for reading, rcl_node_fini! holds it for writing,
+// so that the node is not finalized under a running query.
+typedef struct {
+  rcl_node_t node; // first, the resource is used as the rcl_node_t
+  rcl_context_t *context_p;
+  ErlNifRWLock *rwlock;
+} node_resource_t;
+
+void rcl_node_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  node_resource_t *resource_p = (node_resource_t *)obj;
+  rcl_node_fini(&resource_p->node);
+  if (resource_p->rwlock != NULL) enif_rwlock_destroy(resource_p->rwlock);
+  enif_release_resource(resource_p->context_p);
+}
+
+void node_read_lock(rcl_node_t *node_p) {
+  enif_rwlock_rlock(((node_resource_t *)node_p)->rwlock);
+}
+
+void node_read_unlock(rcl_node_t *node_p) {
+  enif_rwlock_runlock(((node_resource_t *)node_p)->rwlock);
+}
+
 ERL_NIF_TERM nif_rcl_node_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
@@ -46,7 +73,7 @@ ERL_NIF_TERM nif_rcl_node_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv
   rcl_ret_t rc;
   rcl_node_t node                 = rcl_get_zero_initialized_node();
   rcl_node_options_t node_options = rcl_node_get_default_options();
-  node_options.allocator          = get_nif_allocator();
+  node_options.allocator          = get_nif_allocator(MEMORY_ENTITIES);
 
   rc = rcl_node_init(&node, name, namespace, context_p, &node_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
@@ -54,25 +81,33 @@ ERL_NIF_TERM nif_rcl_node_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv
   rc = rcl_node_options_fini(&node_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_node_t *obj   = enif_alloc_resource(rt_rcl_node_t, sizeof(rcl_node_t));
-  *obj              = node;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_keep_resource(context_p);
+
+  node_resource_t *obj = enif_alloc_resource(rt_rcl_node_t, sizeof(node_resource_t));
+  obj->node            = node;
+  obj->context_p       = context_p;
+  obj->rwlock          = enif_rwlock_create("rclex_node");
+  ERL_NIF_TERM term    = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
+  if (obj->rwlock == NULL) return raise(env, __FILE__, __LINE__);
+
   return term;
 }
 
 ERL_NIF_TERM nif_rcl_node_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  rcl_node_t *node_p;
-  if (!enif_get_resource(env, argv[0], rt_rcl_node_t, (void **)&node_p))
+  node_resource_t *resource_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_node_t, (void **)&resource_p))
     return enif_make_badarg(env);
-  if (!rcl_node_is_valid(node_p)) return raise(env, __FILE__, __LINE__);
 
-  rcl_ret_t rc;
+  rcl_ret_t rc = RCL_RET_NODE_INVALID;
+
+  enif_rwlock_rwlock(resource_p->rwlock);
+  if (rcl_node_is_valid(&resource_p->node)) rc = rcl_node_fini(&resource_p->node);
+  enif_rwlock_rwunlock(resource_p->rwlock);
 
-  rc = rcl_node_fini(node_p);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
   return atom_ok;
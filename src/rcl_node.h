@@ -1,4 +1,11 @@
 #include <erl_nif.h>
+#include <rcl/node.h>
+
+extern void rcl_node_dtor(ErlNifEnv *env, void *obj);
+
+// held by queries on the node from any process, see rcl_node.c
+extern void node_read_lock(rcl_node_t *node_p);
+extern void node_read_unlock(rcl_node_t *node_p);
 
 extern ERL_NIF_TERM nif_rcl_node_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 extern ERL_NIF_TERM nif_rcl_node_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -1,17 +1,41 @@
 #include "rcl_publisher.h"
 #include "allocator.h"
+#include "macros.h"
 #include "qos.h"
 #include "resource_types.h"
 #include "terms.h"
 #include <erl_nif.h>
 #include <rcl/node.h>
 #include <rcl/publisher.h>
+#include <rcl/time.h>
 #include <rcl/types.h>
 #include <rmw/ret_types.h>
 #include <rmw/types.h>
 #include <rmw/validate_full_topic_name.h>
 #include <rosidl_runtime_c/message_type_support_struct.h>
 #include <stddef.h>
+#include <stdint.h>
+
+// Layout of builtin_interfaces/msg/Time, checked by introspection_header_stamp_offset!/1 which
+// gives the offset of header.stamp.
+typedef struct {
+  int32_t sec;
+  uint32_t nanosec;
+} stamp_t;
+
+typedef struct {
+  rcl_publisher_t publisher; // first, the resource is used as the rcl_publisher_t
+  rcl_node_t *node_p;
+} publisher_resource_t;
+
+void rcl_publisher_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  publisher_resource_t *resource_p = (publisher_resource_t *)obj;
+  if (rcl_publisher_is_valid_except_context(&resource_p->publisher))
+    rcl_publisher_fini(&resource_p->publisher, resource_p->node_p);
+  enif_release_resource(resource_p->node_p);
+}
 
 ERL_NIF_TERM nif_rcl_publisher_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
@@ -46,15 +70,18 @@ ERL_NIF_TERM nif_rcl_publisher_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM
   rcl_ret_t rc;
   rcl_publisher_t publisher                 = rcl_get_zero_initialized_publisher();
   rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
-  publisher_options.allocator               = get_nif_allocator();
+  publisher_options.allocator               = get_nif_allocator(MEMORY_ENTITIES);
   publisher_options.qos                     = qos;
 
   rc = rcl_publisher_init(&publisher, node_p, ts_p, topic_name, &publisher_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_publisher_t *obj = enif_alloc_resource(rt_rcl_publisher_t, sizeof(rcl_publisher_t));
-  *obj                 = publisher;
-  ERL_NIF_TERM term    = enif_make_resource(env, obj);
+  enif_keep_resource(node_p);
+
+  publisher_resource_t *obj = enif_alloc_resource(rt_rcl_publisher_t, sizeof(publisher_resource_t));
+  obj->publisher            = publisher;
+  obj->node_p               = node_p;
+  ERL_NIF_TERM term         = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
   return term;
@@ -90,11 +117,68 @@ ERL_NIF_TERM nif_rcl_publish(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]
     return enif_make_badarg(env);
   if (!rcl_publisher_is_valid(publisher_p)) return raise(env, __FILE__, __LINE__);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  rc = rcl_publish(publisher_p, message_p, NULL);
+  release_ros_message(ros_message_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_publish_with_stamp(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+  rcl_publisher_t *publisher_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_publisher_t, (void **)&publisher_p))
+    return enif_make_badarg(env);
+  if (!rcl_publisher_is_valid(publisher_p)) return raise(env, __FILE__, __LINE__);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+
+  rcl_clock_t *clock_p;
+  if (!enif_get_resource(env, argv[2], rt_rcl_clock_t, (void **)&clock_p))
+    return enif_make_badarg(env);
+  if (!rcl_clock_valid(clock_p)) return raise(env, __FILE__, __LINE__);
+
+  // the offset is given by the caller, the stamp it points to has to lie within the message
+  ErlNifUInt64 offset;
+  if (!enif_get_uint64(env, argv[3], &offset)) return enif_make_badarg(env);
+  if (offset % _Alignof(stamp_t) != 0 || offset > ros_message_p->size ||
+      ros_message_p->size - offset < sizeof(stamp_t))
+    return enif_make_badarg(env);
+
+  rcl_time_point_value_t now;
+  rc = rcl_clock_get_now(clock_p, &now);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  // the clocks don't report times before the epoch, set_ros_time_override rejects them, but the
+  // time is signed, so the split floors instead of truncating to keep 0 <= nanosec < 1 s
+  rcl_time_point_value_t sec  = now / RCL_S_TO_NS(1);
+  rcl_time_point_value_t nsec = now % RCL_S_TO_NS(1);
+  if (nsec < 0) {
+    nsec += RCL_S_TO_NS(1);
+    sec -= 1;
+  }
+
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  // stamped as late as possible, right before handing the message to the middleware
+  stamp_t *stamp_p = (stamp_t *)((uint8_t *)message_p + offset);
+  stamp_p->sec     = (int32_t)sec;
+  stamp_p->nanosec = (uint32_t)nsec;
 
-  rc = rcl_publish(publisher_p, *ros_message_pp, NULL);
+  rc = rcl_publish(publisher_p, message_p, NULL);
+  release_ros_message(ros_message_p);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
   return atom_ok;
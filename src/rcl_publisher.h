@@ -1,5 +1,8 @@
 #include <erl_nif.h>
 
+extern void rcl_publisher_dtor(ErlNifEnv *env, void *obj);
+
 ERL_NIF_TERM nif_rcl_publisher_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_publisher_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_publish(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rcl_publish_with_stamp(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
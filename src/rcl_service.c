@@ -1,5 +1,6 @@
 #include "rcl_service.h"
 #include "allocator.h"
+#include "macros.h"
 #include "qos.h"
 #include "resource_types.h"
 #include "terms.h"
@@ -11,6 +12,7 @@
 #include <rmw/types.h>
 #include <rmw/validate_full_topic_name.h>
 #include <rosidl_runtime_c/message_type_support_struct.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 ERL_NIF_TERM atom_new_request;
@@ -21,6 +23,39 @@ void make_service_atom(ErlNifEnv *env) {
   atom_service_take_failed = enif_make_atom(env, "service_take_failed");
 }
 
+typedef struct {
+  rcl_service_t service; // first, the resource is used as the rcl_service_t
+  rcl_node_t *node_p;
+} service_resource_t;
+
+void rcl_service_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  service_resource_t *resource_p = (service_resource_t *)obj;
+  if (rcl_service_is_valid(&resource_p->service))
+    rcl_service_fini(&resource_p->service, resource_p->node_p);
+  enif_release_resource(resource_p->node_p);
+}
+
+// The callback resource keeps its service, a callback that wasn't cleared is cleared when the
+// resource is garbage collected, so that the service never calls back with a freed pid.
+typedef struct {
+  ErlNifPid pid; // first, the resource is passed to the callback as the ErlNifPid
+  rcl_service_t *service_p;
+  bool set;
+} service_callback_resource_t;
+
+void service_callback_resource_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  service_callback_resource_t *resource_p = (service_callback_resource_t *)obj;
+#ifndef ROS_DISTRO_foxy
+  if (resource_p->set && rcl_service_is_valid(resource_p->service_p))
+    rcl_service_set_on_new_request_callback(resource_p->service_p, NULL, NULL);
+#endif
+  enif_release_resource(resource_p->service_p);
+}
+
 ERL_NIF_TERM nif_rcl_service_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
 
@@ -54,15 +89,18 @@ ERL_NIF_TERM nif_rcl_service_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM a
   rcl_ret_t rc;
   rcl_service_t service                 = rcl_get_zero_initialized_service();
   rcl_service_options_t service_options = rcl_service_get_default_options();
-  service_options.allocator             = get_nif_allocator();
+  service_options.allocator             = get_nif_allocator(MEMORY_ENTITIES);
   service_options.qos                   = qos;
 
   rc = rcl_service_init(&service, node_p, ts_p, service_name, &service_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_service_t *obj = enif_alloc_resource(rt_rcl_service_t, sizeof(rcl_service_t));
-  *obj               = service;
-  ERL_NIF_TERM term  = enif_make_resource(env, obj);
+  enif_keep_resource(node_p);
+
+  service_resource_t *obj = enif_alloc_resource(rt_rcl_service_t, sizeof(service_resource_t));
+  obj->service            = service;
+  obj->node_p             = node_p;
+  ERL_NIF_TERM term       = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
   return term;
@@ -98,13 +136,16 @@ ERL_NIF_TERM nif_rcl_take_request_with_info(ErlNifEnv *env, int argc, const ERL_
     return enif_make_badarg(env);
   if (!rcl_service_is_valid(service_p)) return raise(env, __FILE__, __LINE__);
 
-  void **ros_request_message_pp;
-  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_request_message_pp))
+  ros_message_t *ros_request_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_request_message_p))
     return enif_make_badarg(env);
+  void *request_message_p = acquire_ros_message(ros_request_message_p);
+  if (request_message_p == NULL) return enif_make_badarg(env);
 
   rmw_service_info_t request_header;
 
-  rc = rcl_take_request_with_info(service_p, &request_header, *ros_request_message_pp);
+  rc = rcl_take_request_with_info(service_p, &request_header, request_message_p);
+  release_ros_message(ros_request_message_p);
   if (rc == RCL_RET_OK) {
     rmw_service_info_t *obj =
         enif_alloc_resource(rt_rmw_service_info_t, sizeof(rmw_service_info_t));
@@ -133,11 +174,14 @@ ERL_NIF_TERM nif_rcl_send_response(ErlNifEnv *env, int argc, const ERL_NIF_TERM
   if (!enif_get_resource(env, argv[1], rt_rmw_service_info_t, (void **)&response_header_p))
     return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[2], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[2], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  rc = rcl_send_response(service_p, &(response_header_p->request_id), *ros_message_pp);
+  rc = rcl_send_response(service_p, &(response_header_p->request_id), message_p);
+  release_ros_message(ros_message_p);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
   return atom_ok;
@@ -162,17 +206,22 @@ ERL_NIF_TERM nif_rcl_service_set_on_new_request_callback(ErlNifEnv *env, int arg
     return enif_make_badarg(env);
   if (!rcl_service_is_valid(service_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p =
-      (ErlNifPid *)enif_alloc_resource(rt_service_callback_resource, sizeof(ErlNifPid));
-  if (enif_self(env, pid_p) == NULL) return raise(env, __FILE__, __LINE__);
-  enif_keep_resource(pid_p);
+  service_callback_resource_t *obj =
+      enif_alloc_resource(rt_service_callback_resource, sizeof(service_callback_resource_t));
+  obj->service_p = service_p;
+  obj->set       = false;
+  enif_keep_resource(service_p);
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+  if (enif_self(env, &obj->pid) == NULL) return raise(env, __FILE__, __LINE__);
 
   rcl_ret_t rc;
-  rc =
-      rcl_service_set_on_new_request_callback(service_p, new_request_callback, (const void *)pid_p);
+  rc = rcl_service_set_on_new_request_callback(service_p, new_request_callback,
+                                               (const void *)&obj->pid);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+  obj->set = true;
 
-  return enif_make_resource(env, pid_p);
+  return term;
 }
 
 ERL_NIF_TERM nif_rcl_service_clear_request_callback(ErlNifEnv *env, int argc,
@@ -184,15 +233,15 @@ ERL_NIF_TERM nif_rcl_service_clear_request_callback(ErlNifEnv *env, int argc,
     return enif_make_badarg(env);
   if (!rcl_service_is_valid(service_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p = NULL;
-  if (!enif_get_resource(env, argv[1], rt_service_callback_resource, (void **)&pid_p))
+  service_callback_resource_t *resource_p;
+  if (!enif_get_resource(env, argv[1], rt_service_callback_resource, (void **)&resource_p))
     return enif_make_badarg(env);
 
   rcl_ret_t rc;
   rc = rcl_service_set_on_new_request_callback(service_p, NULL, NULL);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  enif_release_resource(pid_p);
+  resource_p->set = false;
 
   return atom_ok;
 }
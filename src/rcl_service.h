@@ -1,6 +1,8 @@
 #include <erl_nif.h>
 
 extern void make_service_atom(ErlNifEnv *env);
+extern void rcl_service_dtor(ErlNifEnv *env, void *obj);
+extern void service_callback_resource_dtor(ErlNifEnv *env, void *obj);
 
 ERL_NIF_TERM nif_rcl_service_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_service_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -1,5 +1,6 @@
 #include "rcl_subscription.h"
 #include "allocator.h"
+#include "macros.h"
 #include "qos.h"
 #include "resource_types.h"
 #include "terms.h"
@@ -11,6 +12,7 @@
 #include <rmw/types.h>
 #include <rmw/validate_full_topic_name.h>
 #include <rosidl_runtime_c/message_type_support_struct.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 ERL_NIF_TERM subscription_take_failed;
@@ -21,6 +23,39 @@ void make_subscription_atom(ErlNifEnv *env) {
   new_message              = enif_make_atom(env, "new_message");
 }
 
+typedef struct {
+  rcl_subscription_t subscription; // first, the resource is used as the rcl_subscription_t
+  rcl_node_t *node_p;
+} subscription_resource_t;
+
+void rcl_subscription_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  subscription_resource_t *resource_p = (subscription_resource_t *)obj;
+  if (rcl_subscription_is_valid(&resource_p->subscription))
+    rcl_subscription_fini(&resource_p->subscription, resource_p->node_p);
+  enif_release_resource(resource_p->node_p);
+}
+
+// The callback resource keeps its subscription, a callback that wasn't cleared is cleared when the
+// resource is garbage collected, so that the subscription never calls back with a freed pid.
+typedef struct {
+  ErlNifPid pid; // first, the resource is passed to the callback as the ErlNifPid
+  rcl_subscription_t *subscription_p;
+  bool set;
+} subscription_callback_resource_t;
+
+void subscription_callback_resource_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  subscription_callback_resource_t *resource_p = (subscription_callback_resource_t *)obj;
+#ifndef ROS_DISTRO_foxy
+  if (resource_p->set && rcl_subscription_is_valid(resource_p->subscription_p))
+    rcl_subscription_set_on_new_message_callback(resource_p->subscription_p, NULL, NULL);
+#endif
+  enif_release_resource(resource_p->subscription_p);
+}
+
 ERL_NIF_TERM nif_rcl_subscription_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 4) return enif_make_badarg(env);
 
@@ -54,15 +89,19 @@ ERL_NIF_TERM nif_rcl_subscription_init(ErlNifEnv *env, int argc, const ERL_NIF_T
   rcl_ret_t rc;
   rcl_subscription_t subscription                 = rcl_get_zero_initialized_subscription();
   rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
-  subscription_options.allocator                  = get_nif_allocator();
+  subscription_options.allocator                  = get_nif_allocator(MEMORY_ENTITIES);
   subscription_options.qos                        = qos;
 
   rc = rcl_subscription_init(&subscription, node_p, ts_p, topic_name, &subscription_options);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_subscription_t *obj = enif_alloc_resource(rt_rcl_subscription_t, sizeof(rcl_subscription_t));
-  *obj                    = subscription;
-  ERL_NIF_TERM term       = enif_make_resource(env, obj);
+  enif_keep_resource(node_p);
+
+  subscription_resource_t *obj =
+      enif_alloc_resource(rt_rcl_subscription_t, sizeof(subscription_resource_t));
+  obj->subscription = subscription;
+  obj->node_p       = node_p;
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
   return term;
@@ -98,11 +137,14 @@ ERL_NIF_TERM nif_rcl_take(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
     return enif_make_badarg(env);
   if (!rcl_subscription_is_valid(subscription_p)) return raise(env, __FILE__, __LINE__);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  rc = rcl_take(subscription_p, *ros_message_pp, NULL, NULL);
+  rc = rcl_take(subscription_p, message_p, NULL, NULL);
+  release_ros_message(ros_message_p);
   if (rc == RCL_RET_OK) return atom_ok;
   if (rc == RCL_RET_SUBSCRIPTION_TAKE_FAILED) return subscription_take_failed;
   return raise(env, __FILE__, __LINE__);
@@ -127,17 +169,23 @@ ERL_NIF_TERM nif_rcl_subscription_set_on_new_message_callback(ErlNifEnv *env, in
     return enif_make_badarg(env);
   if (!rcl_subscription_is_valid(subscription_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p =
-      (ErlNifPid *)enif_alloc_resource(rt_subscription_callback_resource, sizeof(ErlNifPid));
-  if (enif_self(env, pid_p) == NULL) return raise(env, __FILE__, __LINE__);
-  enif_keep_resource(pid_p);
+  subscription_callback_resource_t *obj =
+      enif_alloc_resource(rt_subscription_callback_resource,
+                          sizeof(subscription_callback_resource_t));
+  obj->subscription_p = subscription_p;
+  obj->set            = false;
+  enif_keep_resource(subscription_p);
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+  if (enif_self(env, &obj->pid) == NULL) return raise(env, __FILE__, __LINE__);
 
   rcl_ret_t rc;
   rc = rcl_subscription_set_on_new_message_callback(subscription_p, new_message_callback,
-                                                    (const void *)pid_p);
+                                                    (const void *)&obj->pid);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+  obj->set = true;
 
-  return enif_make_resource(env, pid_p);
+  return term;
 }
 
 ERL_NIF_TERM nif_rcl_subscription_clear_message_callback(ErlNifEnv *env, int argc,
@@ -149,15 +197,15 @@ ERL_NIF_TERM nif_rcl_subscription_clear_message_callback(ErlNifEnv *env, int arg
     return enif_make_badarg(env);
   if (!rcl_subscription_is_valid(subscription_p)) return raise(env, __FILE__, __LINE__);
 
-  ErlNifPid *pid_p = NULL;
-  if (!enif_get_resource(env, argv[1], rt_subscription_callback_resource, (void **)&pid_p))
+  subscription_callback_resource_t *resource_p;
+  if (!enif_get_resource(env, argv[1], rt_subscription_callback_resource, (void **)&resource_p))
     return enif_make_badarg(env);
 
   rcl_ret_t rc;
   rc = rcl_subscription_set_on_new_message_callback(subscription_p, NULL, NULL);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  enif_release_resource(pid_p);
+  resource_p->set = false;
 
   return atom_ok;
 }
@@ -1,6 +1,8 @@
 #include <erl_nif.h>
 
 extern void make_subscription_atom(ErlNifEnv *env);
+extern void rcl_subscription_dtor(ErlNifEnv *env, void *obj);
+extern void subscription_callback_resource_dtor(ErlNifEnv *env, void *obj);
 
 ERL_NIF_TERM nif_rcl_subscription_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_subscription_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -1,5 +1,7 @@
 #include "rcl_timer.h"
 #include "allocator.h"
+#include "macros.h"
+#include "rcl_clock.h"
 #include "resource_types.h"
 #include "terms.h"
 #include <erl_nif.h>
@@ -11,6 +13,23 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+typedef struct {
+  rcl_timer_t timer; // first, the resource is used as the rcl_timer_t
+  rcl_clock_t *clock_p;
+  rcl_context_t *context_p;
+} timer_resource_t;
+
+void rcl_timer_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  timer_resource_t *resource_p = (timer_resource_t *)obj;
+  clock_lock(resource_p->clock_p);
+  rcl_timer_fini(&resource_p->timer);
+  clock_unlock(resource_p->clock_p);
+  enif_release_resource(resource_p->clock_p);
+  enif_release_resource(resource_p->context_p);
+}
+
 ERL_NIF_TERM nif_rcl_timer_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 3) return enif_make_badarg(env);
 
@@ -24,13 +43,16 @@ ERL_NIF_TERM nif_rcl_timer_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM arg
     return enif_make_badarg(env);
   if (!rcl_clock_valid(clock_p)) return raise(env, __FILE__, __LINE__);
 
+  // a timer of no period would always be ready
   int period_ms;
-  if (!enif_get_int(env, argv[2], &period_ms)) return enif_make_badarg(env);
+  if (!enif_get_int(env, argv[2], &period_ms) || period_ms <= 0) return enif_make_badarg(env);
 
   rcl_ret_t rc;
   rcl_timer_t timer         = rcl_get_zero_initialized_timer();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
+  // the timer adds a jump callback to a ROS clock
+  clock_lock(clock_p);
 #ifdef ROS_DISTRO_iron
   rc = rcl_timer_init(&timer, clock_p, context_p, RCL_MS_TO_NS(period_ms), NULL, allocator);
 #elif ROS_DISTRO_humble
@@ -40,11 +62,17 @@ ERL_NIF_TERM nif_rcl_timer_init(ErlNifEnv *env, int argc, const ERL_NIF_TERM arg
 #else
   rc = rcl_timer_init2(&timer, clock_p, context_p, RCL_MS_TO_NS(period_ms), NULL, allocator, true);
 #endif
+  clock_unlock(clock_p);
   if (rc != RCL_RET_OK) return enif_make_badarg(env);
 
-  rcl_timer_t *obj  = enif_alloc_resource(rt_rcl_timer_t, sizeof(rcl_timer_t));
-  *obj              = timer;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_keep_resource(clock_p);
+  enif_keep_resource(context_p);
+
+  timer_resource_t *obj = enif_alloc_resource(rt_rcl_timer_t, sizeof(timer_resource_t));
+  obj->timer            = timer;
+  obj->clock_p          = clock_p;
+  obj->context_p        = context_p;
+  ERL_NIF_TERM term     = enif_make_resource(env, obj);
   enif_release_resource(obj);
 
   return term;
@@ -55,11 +83,14 @@ ERL_NIF_TERM nif_rcl_timer_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM arg
 
   rcl_ret_t rc;
 
-  rcl_timer_t *timer_p;
-  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&timer_p))
+  timer_resource_t *resource_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&resource_p))
     return enif_make_badarg(env);
 
-  rc = rcl_timer_fini(timer_p);
+  // the timer removes its jump callback from a ROS clock
+  clock_lock(resource_p->clock_p);
+  rc = rcl_timer_fini(&resource_p->timer);
+  clock_unlock(resource_p->clock_p);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
   return atom_ok;
@@ -95,3 +126,70 @@ ERL_NIF_TERM nif_rcl_timer_call(ErlNifEnv *env, int argc, const ERL_NIF_TERM arg
 
   return atom_ok;
 }
+
+// The period is exchanged atomically, the call already scheduled is kept and the following ones
+// are a new period apart, so the timer doesn't lose its phase.
+ERL_NIF_TERM nif_rcl_timer_exchange_period(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  int period_ms;
+  if (!enif_get_int(env, argv[1], &period_ms) || period_ms <= 0) return enif_make_badarg(env);
+
+  int64_t old_period;
+  rc = rcl_timer_exchange_period(timer_p, RCL_MS_TO_NS(period_ms), &old_period);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return enif_make_int64(env, RCL_NS_TO_MS(old_period));
+}
+
+ERL_NIF_TERM nif_rcl_timer_reset(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  rc = rcl_timer_reset(timer_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_timer_cancel(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  rc = rcl_timer_cancel(timer_p);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_rcl_timer_is_canceled(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_ret_t rc;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  bool is_canceled;
+  rc = rcl_timer_is_canceled(timer_p, &is_canceled);
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return is_canceled ? atom_true : atom_false;
+}
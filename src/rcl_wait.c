@@ -1,5 +1,6 @@
 #include "rcl_wait.h"
 #include "allocator.h"
+#include "macros.h"
 #include "resource_types.h"
 #include "terms.h"
 #include <erl_nif.h>
@@ -12,6 +13,32 @@
 #include <rcl/wait.h>
 #include <stddef.h>
 
+typedef struct {
+  rcl_wait_set_t wait_set; // first, the resource is used as the rcl_wait_set_t
+  rcl_context_t *context_p;
+} wait_set_resource_t;
+
+void rcl_wait_set_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  wait_set_resource_t *resource_p = (wait_set_resource_t *)obj;
+  if (rcl_wait_set_is_valid(&resource_p->wait_set)) rcl_wait_set_fini(&resource_p->wait_set);
+  enif_release_resource(resource_p->context_p);
+}
+
+static ERL_NIF_TERM make_wait_set_resource(ErlNifEnv *env, rcl_wait_set_t wait_set,
+                                           rcl_context_t *context_p) {
+  enif_keep_resource(context_p);
+
+  wait_set_resource_t *obj = enif_alloc_resource(rt_rcl_wait_set_t, sizeof(wait_set_resource_t));
+  obj->wait_set            = wait_set;
+  obj->context_p           = context_p;
+  ERL_NIF_TERM term        = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+
 ERL_NIF_TERM nif_rcl_wait_set_init_subscription(ErlNifEnv *env, int argc,
                                                 const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
@@ -23,17 +50,12 @@ ERL_NIF_TERM nif_rcl_wait_set_init_subscription(ErlNifEnv *env, int argc,
 
   rcl_ret_t rc;
   rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
   rc = rcl_wait_set_init(&wait_set, 1, 0, 0, 0, 0, 0, context_p, allocator);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_wait_set_t *obj = enif_alloc_resource(rt_rcl_wait_set_t, sizeof(rcl_wait_set_t));
-  *obj                = wait_set;
-  ERL_NIF_TERM term   = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_wait_set_resource(env, wait_set, context_p);
 }
 
 ERL_NIF_TERM nif_rcl_wait_set_init_timer(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
@@ -46,17 +68,12 @@ ERL_NIF_TERM nif_rcl_wait_set_init_timer(ErlNifEnv *env, int argc, const ERL_NIF
 
   rcl_ret_t rc;
   rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
   rc = rcl_wait_set_init(&wait_set, 0, 0, 1, 0, 0, 0, context_p, allocator);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_wait_set_t *obj = enif_alloc_resource(rt_rcl_wait_set_t, sizeof(rcl_wait_set_t));
-  *obj                = wait_set;
-  ERL_NIF_TERM term   = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_wait_set_resource(env, wait_set, context_p);
 }
 
 ERL_NIF_TERM nif_rcl_wait_set_init_client(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
@@ -69,17 +86,12 @@ ERL_NIF_TERM nif_rcl_wait_set_init_client(ErlNifEnv *env, int argc, const ERL_NI
 
   rcl_ret_t rc;
   rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
   rc = rcl_wait_set_init(&wait_set, 0, 0, 0, 1, 0, 0, context_p, allocator);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_wait_set_t *obj = enif_alloc_resource(rt_rcl_wait_set_t, sizeof(rcl_wait_set_t));
-  *obj                = wait_set;
-  ERL_NIF_TERM term   = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_wait_set_resource(env, wait_set, context_p);
 }
 
 ERL_NIF_TERM nif_rcl_wait_set_init_service(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
@@ -92,17 +104,12 @@ ERL_NIF_TERM nif_rcl_wait_set_init_service(ErlNifEnv *env, int argc, const ERL_N
 
   rcl_ret_t rc;
   rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
-  rcl_allocator_t allocator = get_nif_allocator();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
 
   rc = rcl_wait_set_init(&wait_set, 0, 0, 0, 0, 1, 0, context_p, allocator);
   if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
 
-  rcl_wait_set_t *obj = enif_alloc_resource(rt_rcl_wait_set_t, sizeof(rcl_wait_set_t));
-  *obj                = wait_set;
-  ERL_NIF_TERM term   = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_wait_set_resource(env, wait_set, context_p);
 }
 
 ERL_NIF_TERM nif_rcl_wait_set_fini(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
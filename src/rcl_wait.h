@@ -1,5 +1,7 @@
 #include <erl_nif.h>
 
+extern void rcl_wait_set_dtor(ErlNifEnv *env, void *obj);
+
 ERL_NIF_TERM nif_rcl_wait_set_init_subscription(ErlNifEnv *env, int argc,
                                                 const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_rcl_wait_set_init_timer(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
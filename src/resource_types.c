@@ -1,4 +1,20 @@
 #include "resource_types.h"
+#include "allocator.h"
+#include "introspection.h"
+#include "macros.h"
+#include "rcl_client.h"
+#include "rcl_clock.h"
+#include "rcl_event.h"
+#include "rcl_guard_condition.h"
+#include "rcl_init.h"
+#include "rcl_node.h"
+#include "rcl_publisher.h"
+#include "rcl_service.h"
+#include "rcl_subscription.h"
+#include "rcl_timer.h"
+#include "rcl_wait.h"
+#include "timer_service.h"
+#include "waiter.h"
 #include <erl_nif.h>
 #include <stddef.h>
 
@@ -11,6 +27,8 @@ ErlNifResourceType *rt_rcl_service_t;
 ErlNifResourceType *rt_rcl_clock_t;
 ErlNifResourceType *rt_rcl_timer_t;
 ErlNifResourceType *rt_rcl_wait_set_t;
+ErlNifResourceType *rt_rcl_guard_condition_t;
+ErlNifResourceType *rt_rcl_event_t;
 ErlNifResourceType *rt_rosidl_message_type_support_t;
 ErlNifResourceType *rt_rosidl_service_type_support_t;
 ErlNifResourceType *rt_rmw_service_info_t;
@@ -18,30 +36,112 @@ ErlNifResourceType *rt_ros_message;
 ErlNifResourceType *rt_subscription_callback_resource;
 ErlNifResourceType *rt_service_callback_resource;
 ErlNifResourceType *rt_client_callback_resource;
+ErlNifResourceType *rt_introspection_plan;
+ErlNifResourceType *rt_timer_service;
+ErlNifResourceType *rt_waiter;
+
+#define ROS_MESSAGE_DESTROYED 1u
+#define ROS_MESSAGE_FREED     2u
+#define ROS_MESSAGE_HOLDER    4u
+
+ERL_NIF_TERM make_ros_message_resource(ErlNifEnv *env, void *message_p, size_t size,
+                                       ros_message_destroy_t destroy, void *owner_p) {
+  if (owner_p != NULL) enif_keep_resource(owner_p);
+  account_allocation(MEMORY_MESSAGES, size);
+
+  ros_message_t *obj = enif_alloc_resource(rt_ros_message, sizeof(ros_message_t));
+  obj->message_p     = message_p;
+  obj->size          = size;
+  obj->destroy       = destroy;
+  obj->owner_p       = owner_p;
+  atomic_init(&obj->state, 0);
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+
+// Frees the message once, whichever of destroy_ros_message and the last release gets here first.
+static void free_ros_message(ros_message_t *ros_message_p) {
+  unsigned int state = atomic_fetch_or(&ros_message_p->state, ROS_MESSAGE_FREED);
+  if (state & ROS_MESSAGE_FREED) return;
+
+  ros_message_p->destroy(ros_message_p->message_p, ros_message_p->owner_p);
+  account_deallocation(MEMORY_MESSAGES, ros_message_p->size);
+  if (ros_message_p->owner_p != NULL) enif_release_resource(ros_message_p->owner_p);
+}
+
+// Returns the message held against a concurrent destroy, or NULL if it was destroyed. A message
+// that was returned has to be released with release_ros_message.
+void *acquire_ros_message(ros_message_t *ros_message_p) {
+  unsigned int state = atomic_fetch_add(&ros_message_p->state, ROS_MESSAGE_HOLDER);
+  if (state & ROS_MESSAGE_DESTROYED) {
+    release_ros_message(ros_message_p);
+    return NULL;
+  }
+
+  return ros_message_p->message_p;
+}
+
+void release_ros_message(ros_message_t *ros_message_p) {
+  unsigned int state = atomic_fetch_sub(&ros_message_p->state, ROS_MESSAGE_HOLDER);
+  if ((state & ROS_MESSAGE_DESTROYED) && state / ROS_MESSAGE_HOLDER == 1)
+    free_ros_message(ros_message_p);
+}
+
+// Destroys the message once, now if it isn't held, otherwise on its last release.
+void destroy_ros_message(ros_message_t *ros_message_p) {
+  unsigned int state = atomic_fetch_or(&ros_message_p->state, ROS_MESSAGE_DESTROYED);
+  if (state & ROS_MESSAGE_DESTROYED) return;
+
+  if (state / ROS_MESSAGE_HOLDER == 0) free_ros_message(ros_message_p);
+}
+
+static void ros_message_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  destroy_ros_message((ros_message_t *)obj);
+}
 
 #define open_rt_return_if_error(env, module, name, flags)                                          \
-  rt_##name = enif_open_resource_type(env, module, #name, NULL, flags, NULL);                      \
+  open_rt_with_dtor_return_if_error(env, module, name, NULL, flags)
+
+#define open_rt_with_dtor_return_if_error(env, module, name, dtor, flags)                          \
+  rt_##name = enif_open_resource_type(env, module, #name, dtor, flags, NULL);                      \
   if (rt_##name == NULL) return 1;
 
 int open_resource_types(ErlNifEnv *env, const char *module) {
   ErlNifResourceFlags flags = ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER;
 
-  open_rt_return_if_error(env, module, rcl_context_t, flags);
-  open_rt_return_if_error(env, module, rcl_node_t, flags);
-  open_rt_return_if_error(env, module, rcl_publisher_t, flags);
-  open_rt_return_if_error(env, module, rcl_subscription_t, flags);
-  open_rt_return_if_error(env, module, rcl_client_t, flags);
-  open_rt_return_if_error(env, module, rcl_service_t, flags);
-  open_rt_return_if_error(env, module, rcl_clock_t, flags);
-  open_rt_return_if_error(env, module, rcl_timer_t, flags);
-  open_rt_return_if_error(env, module, rcl_wait_set_t, flags);
+  // Entities keep the resources they were initialized with, e.g. a publisher its node and a node
+  // its context, so that a destructor always runs before those of its parents.
+  open_rt_with_dtor_return_if_error(env, module, rcl_context_t, rcl_context_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_node_t, rcl_node_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_publisher_t, rcl_publisher_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_subscription_t, rcl_subscription_dtor,
+                                    flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_client_t, rcl_client_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_service_t, rcl_service_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_clock_t, rcl_clock_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_timer_t, rcl_timer_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_wait_set_t, rcl_wait_set_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_guard_condition_t,
+                                    rcl_guard_condition_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, rcl_event_t, rcl_event_dtor, flags);
   open_rt_return_if_error(env, module, rosidl_message_type_support_t, flags);
   open_rt_return_if_error(env, module, rosidl_service_type_support_t, flags);
   open_rt_return_if_error(env, module, rmw_service_info_t, flags);
-  open_rt_return_if_error(env, module, ros_message, flags);
-  open_rt_return_if_error(env, module, subscription_callback_resource, flags);
-  open_rt_return_if_error(env, module, service_callback_resource, flags);
-  open_rt_return_if_error(env, module, client_callback_resource, flags);
+  open_rt_with_dtor_return_if_error(env, module, ros_message, ros_message_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, subscription_callback_resource,
+                                    subscription_callback_resource_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, service_callback_resource,
+                                    service_callback_resource_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, client_callback_resource,
+                                    client_callback_resource_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, introspection_plan, introspection_plan_dtor,
+                                    flags);
+  open_rt_with_dtor_return_if_error(env, module, timer_service, timer_service_dtor, flags);
+  open_rt_with_dtor_return_if_error(env, module, waiter, waiter_dtor, flags);
 
   return 0;
 }
@@ -1,4 +1,6 @@
 #include <erl_nif.h>
+#include <stdatomic.h>
+#include <stddef.h>
 
 extern ErlNifResourceType *rt_rcl_context_t;
 extern ErlNifResourceType *rt_rcl_node_t;
@@ -9,6 +11,8 @@ extern ErlNifResourceType *rt_rcl_service_t;
 extern ErlNifResourceType *rt_rcl_clock_t;
 extern ErlNifResourceType *rt_rcl_timer_t;
 extern ErlNifResourceType *rt_rcl_wait_set_t;
+extern ErlNifResourceType *rt_rcl_guard_condition_t;
+extern ErlNifResourceType *rt_rcl_event_t;
 extern ErlNifResourceType *rt_rosidl_message_type_support_t;
 extern ErlNifResourceType *rt_rosidl_service_type_support_t;
 extern ErlNifResourceType *rt_rmw_service_info_t;
@@ -16,5 +20,31 @@ extern ErlNifResourceType *rt_ros_message;
 extern ErlNifResourceType *rt_subscription_callback_resource;
 extern ErlNifResourceType *rt_service_callback_resource;
 extern ErlNifResourceType *rt_client_callback_resource;
+extern ErlNifResourceType *rt_introspection_plan;
+extern ErlNifResourceType *rt_timer_service;
+extern ErlNifResourceType *rt_waiter;
+
+// A ros_message resource owns its message, which is destroyed by destroy! or, if it wasn't, once
+// the resource is garbage collected. The NIFs that take the message hold it with
+// acquire_ros_message/1 until they are done, and reject a destroyed message with badarg. A
+// destroy! while the message is held, e.g. by a dirty conversion job, marks it destroyed and the
+// last release destroys it. The owner, if any, is a resource kept until the message is destroyed,
+// e.g. the introspection plan which destroys it. The size of the message struct is accounted to
+// the messages memory while it lives.
+typedef void (*ros_message_destroy_t)(void *message_p, void *owner_p);
+
+typedef struct {
+  void *message_p;
+  size_t size;
+  ros_message_destroy_t destroy;
+  void *owner_p;
+  atomic_uint state; // the holders in steps of ROS_MESSAGE_HOLDER, and the flags below
+} ros_message_t;
+
+extern ERL_NIF_TERM make_ros_message_resource(ErlNifEnv *env, void *message_p, size_t size,
+                                              ros_message_destroy_t destroy, void *owner_p);
+extern void *acquire_ros_message(ros_message_t *ros_message_p);
+extern void release_ros_message(ros_message_t *ros_message_p);
+extern void destroy_ros_message(ros_message_t *ros_message_p);
 
 extern int open_resource_types(ErlNifEnv *env, const char *module);
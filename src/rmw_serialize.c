@@ -0,0 +1,91 @@
+#include "rmw_serialize.h"
+#include "allocator.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rcutils/allocator.h>
+#include <rmw/ret_types.h>
+#include <rmw/rmw.h>
+#include <rmw/serialized_message.h>
+#include <rosidl_runtime_c/message_type_support_struct.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// rmw_serialize grows the buffer as needed, this only saves the first reallocations of small
+// messages, a pool block of this size is reused by the next call
+#define SERIALIZED_INITIAL_CAPACITY 256
+
+ERL_NIF_TERM nif_rmw_serialize(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  rosidl_message_type_support_t *ts_p;
+  if (!enif_get_resource(env, argv[0], rt_rosidl_message_type_support_t, (void **)&ts_p))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  // the buffer only lives for this call, its blocks are reused from the pool by the next one
+  rmw_ret_t rm;
+  rcutils_allocator_t allocator         = get_pool_allocator(MEMORY_MIDDLEWARE);
+  rmw_serialized_message_t serialized_m = rmw_get_zero_initialized_serialized_message();
+
+  rm = rmw_serialized_message_init(&serialized_m, SERIALIZED_INITIAL_CAPACITY, &allocator);
+  if (rm != RMW_RET_OK) {
+    release_ros_message(ros_message_p);
+    return raise(env, __FILE__, __LINE__);
+  }
+
+  rm = rmw_serialize(message_p, ts_p, &serialized_m);
+  release_ros_message(ros_message_p);
+  if (rm != RMW_RET_OK) {
+    rmw_serialized_message_fini(&serialized_m);
+    return raise(env, __FILE__, __LINE__);
+  }
+
+  ERL_NIF_TERM binary;
+  unsigned char *data = enif_make_new_binary(env, serialized_m.buffer_length, &binary);
+  if (serialized_m.buffer_length > 0)
+    memcpy(data, serialized_m.buffer, serialized_m.buffer_length);
+
+  rm = rmw_serialized_message_fini(&serialized_m);
+  if (rm != RMW_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return binary;
+}
+
+ERL_NIF_TERM nif_rmw_deserialize(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3) return enif_make_badarg(env);
+
+  rosidl_message_type_support_t *ts_p;
+  if (!enif_get_resource(env, argv[0], rt_rosidl_message_type_support_t, (void **)&ts_p))
+    return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[1], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+
+  ErlNifBinary binary;
+  if (!enif_inspect_binary(env, argv[2], &binary)) return enif_make_badarg(env);
+
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  // the binary is only read, so it is borrowed as the buffer instead of being copied
+  rmw_serialized_message_t serialized_m = rmw_get_zero_initialized_serialized_message();
+  serialized_m.buffer                   = (uint8_t *)binary.data;
+  serialized_m.buffer_length            = binary.size;
+  serialized_m.buffer_capacity          = binary.size;
+  serialized_m.allocator                = get_nif_allocator(MEMORY_MIDDLEWARE);
+
+  rmw_ret_t rm;
+  rm = rmw_deserialize(&serialized_m, ts_p, message_p);
+  release_ros_message(ros_message_p);
+  if (rm != RMW_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
@@ -0,0 +1,4 @@
+#include <erl_nif.h>
+
+ERL_NIF_TERM nif_rmw_serialize(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_rmw_deserialize(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -0,0 +1,348 @@
+#include "timer_service.h"
+#include "allocator.h"
+#include "macros.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rcl/allocator.h>
+#include <rcl/context.h>
+#include <rcl/guard_condition.h>
+#include <rcl/timer.h>
+#include <rcl/types.h>
+#include <rcl/wait.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One native thread serves all the timers of a context. It blocks in rcl_wait on a wait set of
+// every registered timer, so it sleeps until the earliest next call of them and only the timers
+// that are due are called and their owner sent {:tick, since_last_call, lateness}, in ns, the
+// actual period and how late the call is behind the schedule of the timer. A guard condition in
+// the same wait set interrupts the wait when timers are added or removed, or the service is
+// stopped.
+
+typedef struct {
+  rcl_timer_t *timer_p;
+  ErlNifPid pid;
+} timer_entry_t;
+
+typedef struct {
+  rcl_context_t *context_p;
+  rcl_guard_condition_t guard_condition;
+  ErlNifMutex *mutex;
+  ErlNifCond *cond;
+  ErlNifTid tid;
+  bool running;
+  bool stopping;
+  // bumped on every change of the entries, the thread acknowledges it in `applied` once it no
+  // longer uses the previous entries
+  uint64_t generation;
+  uint64_t applied;
+  timer_entry_t *entries;
+  size_t count;
+  size_t capacity;
+} timer_service_t;
+
+ERL_NIF_TERM atom_tick;
+
+void make_timer_service_atom(ErlNifEnv *env) {
+  atom_tick = enif_make_atom(env, "tick");
+}
+
+// called with the mutex locked, copies the entries the thread works on until the next change
+static bool take_snapshot(const timer_service_t *service_p, timer_entry_t **snapshot_pp,
+                          size_t *capacity_p, size_t *count_p) {
+  if (service_p->count > *capacity_p) {
+    timer_entry_t *snapshot_p =
+        enif_realloc(*snapshot_pp, service_p->capacity * sizeof(timer_entry_t));
+    if (snapshot_p == NULL) return false;
+    *snapshot_pp = snapshot_p;
+    *capacity_p  = service_p->capacity;
+  }
+
+  for (size_t i = 0; i < service_p->count; ++i) (*snapshot_pp)[i] = service_p->entries[i];
+  *count_p = service_p->count;
+
+  return true;
+}
+
+static void *timer_service_thread(void *arg) {
+  timer_service_t *service_p = (timer_service_t *)arg;
+
+  rcl_ret_t rc;
+  rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
+
+  rc = rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, 0, service_p->context_p, allocator);
+
+  ErlNifEnv *env           = enif_alloc_env();
+  timer_entry_t *snapshot  = NULL;
+  size_t capacity          = 0;
+  size_t count             = 0;
+  size_t wait_set_capacity = 0;
+
+  while (rc == RCL_RET_OK) {
+    enif_mutex_lock(service_p->mutex);
+    if (service_p->stopping) {
+      enif_mutex_unlock(service_p->mutex);
+      break;
+    }
+    if (service_p->applied != service_p->generation) {
+      if (!take_snapshot(service_p, &snapshot, &capacity, &count)) {
+        enif_mutex_unlock(service_p->mutex);
+        break;
+      }
+      service_p->applied = service_p->generation;
+      enif_cond_broadcast(service_p->cond);
+    }
+    enif_mutex_unlock(service_p->mutex);
+
+    if (count > wait_set_capacity) {
+      rc = rcl_wait_set_resize(&wait_set, 0, 1, count, 0, 0, 0);
+      if (rc != RCL_RET_OK) break;
+      wait_set_capacity = count;
+    }
+
+    rc = rcl_wait_set_clear(&wait_set);
+    if (rc != RCL_RET_OK) break;
+
+    rc = rcl_wait_set_add_guard_condition(&wait_set, &service_p->guard_condition, NULL);
+    for (size_t i = 0; i < count && rc == RCL_RET_OK; ++i)
+      rc = rcl_wait_set_add_timer(&wait_set, snapshot[i].timer_p, NULL);
+    if (rc != RCL_RET_OK) break;
+
+    // blocks until the earliest timer is due or the guard condition is triggered
+    rc = rcl_wait(&wait_set, -1);
+    if (rc == RCL_RET_TIMEOUT) {
+      rc = RCL_RET_OK;
+      continue;
+    }
+    if (rc != RCL_RET_OK) break;
+
+    for (size_t i = 0; i < count; ++i) {
+      if (wait_set.timers[i] == NULL) continue;
+
+      rcl_timer_t *timer_p = snapshot[i].timer_p;
+
+      int64_t until_next_call, since_last_call;
+      if (rcl_timer_get_time_until_next_call(timer_p, &until_next_call) != RCL_RET_OK) continue;
+      if (rcl_timer_get_time_since_last_call(timer_p, &since_last_call) != RCL_RET_OK) continue;
+
+      // the timer is not due after all when it was canceled in the meantime, otherwise its next
+      // call is moved by whole periods so that it stays in phase
+      if (rcl_timer_call(timer_p) != RCL_RET_OK) continue;
+
+      ERL_NIF_TERM lateness = enif_make_int64(env, until_next_call < 0 ? -until_next_call : 0);
+      enif_send(NULL, &snapshot[i].pid, env,
+                enif_make_tuple3(env, atom_tick, enif_make_int64(env, since_last_call), lateness));
+      enif_clear_env(env);
+    }
+  }
+
+  // let the callers waiting for an acknowledgement return, the entries are no longer used
+  enif_mutex_lock(service_p->mutex);
+  service_p->applied  = UINT64_MAX;
+  service_p->stopping = true;
+  enif_cond_broadcast(service_p->cond);
+  enif_mutex_unlock(service_p->mutex);
+
+  if (snapshot != NULL) enif_free(snapshot);
+  enif_free_env(env);
+  if (rcl_wait_set_is_valid(&wait_set)) rcl_wait_set_fini(&wait_set);
+
+  return NULL;
+}
+
+static void timer_service_stop(timer_service_t *service_p) {
+  if (!service_p->running) return;
+
+  enif_mutex_lock(service_p->mutex);
+  service_p->stopping = true;
+  enif_mutex_unlock(service_p->mutex);
+
+  rcl_trigger_guard_condition(&service_p->guard_condition);
+  enif_thread_join(service_p->tid, NULL);
+  service_p->running = false;
+
+  for (size_t i = 0; i < service_p->count; ++i)
+    enif_release_resource(service_p->entries[i].timer_p);
+  service_p->count = 0;
+
+  rcl_guard_condition_fini(&service_p->guard_condition);
+  enif_release_resource(service_p->context_p);
+}
+
+void timer_service_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  timer_service_t **service_pp = (timer_service_t **)obj;
+  timer_service_t *service_p   = *service_pp;
+  if (service_p == NULL) return;
+
+  timer_service_stop(service_p);
+  if (service_p->entries != NULL) enif_free(service_p->entries);
+  if (service_p->cond != NULL) enif_cond_destroy(service_p->cond);
+  if (service_p->mutex != NULL) enif_mutex_destroy(service_p->mutex);
+  enif_free(service_p);
+}
+
+ERL_NIF_TERM nif_timer_service_start(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  rcl_context_t *context_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_context_t, (void **)&context_p))
+    return enif_make_badarg(env);
+  if (!rcl_context_is_valid(context_p)) return raise(env, __FILE__, __LINE__);
+
+  timer_service_t *service_p = enif_alloc(sizeof(timer_service_t));
+  if (service_p == NULL) return raise(env, __FILE__, __LINE__);
+
+  *service_p                 = (timer_service_t){0};
+  service_p->context_p       = context_p;
+  service_p->guard_condition = rcl_get_zero_initialized_guard_condition();
+  service_p->mutex           = enif_mutex_create("rclex_timer_service");
+  service_p->cond            = enif_cond_create("rclex_timer_service");
+
+  timer_service_t **obj = enif_alloc_resource(rt_timer_service, sizeof(timer_service_t *));
+  *obj                  = service_p;
+  ERL_NIF_TERM term     = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  if (service_p->mutex == NULL || service_p->cond == NULL) return raise(env, __FILE__, __LINE__);
+
+  rcl_ret_t rc;
+  rc = rcl_guard_condition_init(&service_p->guard_condition, context_p,
+                                rcl_guard_condition_get_default_options());
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  // the wait set of the thread refers to the context, keep it as long as the thread runs
+  enif_keep_resource(context_p);
+
+  if (enif_thread_create("rclex_timer_service", &service_p->tid, timer_service_thread, service_p,
+                         NULL) != 0) {
+    rcl_guard_condition_fini(&service_p->guard_condition);
+    enif_release_resource(context_p);
+    return raise(env, __FILE__, __LINE__);
+  }
+  service_p->running = true;
+
+  return term;
+}
+
+ERL_NIF_TERM nif_timer_service_stop(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  timer_service_t **service_pp;
+  if (!enif_get_resource(env, argv[0], rt_timer_service, (void **)&service_pp))
+    return enif_make_badarg(env);
+
+  timer_service_stop(*service_pp);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_timer_service_add(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  timer_service_t **service_pp;
+  if (!enif_get_resource(env, argv[0], rt_timer_service, (void **)&service_pp))
+    return enif_make_badarg(env);
+  timer_service_t *service_p = *service_pp;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[1], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  ErlNifPid pid;
+  if (enif_self(env, &pid) == NULL) return raise(env, __FILE__, __LINE__);
+
+  enif_mutex_lock(service_p->mutex);
+
+  if (service_p->stopping) {
+    enif_mutex_unlock(service_p->mutex);
+    return raise(env, __FILE__, __LINE__);
+  }
+
+  if (service_p->count == service_p->capacity) {
+    size_t capacity        = service_p->capacity == 0 ? 16 : service_p->capacity * 2;
+    timer_entry_t *entries = enif_realloc(service_p->entries, capacity * sizeof(timer_entry_t));
+    if (entries == NULL) {
+      enif_mutex_unlock(service_p->mutex);
+      return raise(env, __FILE__, __LINE__);
+    }
+    service_p->entries  = entries;
+    service_p->capacity = capacity;
+  }
+
+  enif_keep_resource(timer_p);
+  service_p->entries[service_p->count++] = (timer_entry_t){.timer_p = timer_p, .pid = pid};
+  service_p->generation++;
+
+  rcl_ret_t rc = rcl_trigger_guard_condition(&service_p->guard_condition);
+
+  enif_mutex_unlock(service_p->mutex);
+
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_timer_service_remove(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  timer_service_t **service_pp;
+  if (!enif_get_resource(env, argv[0], rt_timer_service, (void **)&service_pp))
+    return enif_make_badarg(env);
+  timer_service_t *service_p = *service_pp;
+
+  rcl_timer_t *timer_p;
+  if (!enif_get_resource(env, argv[1], rt_rcl_timer_t, (void **)&timer_p))
+    return enif_make_badarg(env);
+
+  enif_mutex_lock(service_p->mutex);
+
+  size_t i;
+  for (i = 0; i < service_p->count; ++i)
+    if (service_p->entries[i].timer_p == timer_p) break;
+
+  if (i == service_p->count) {
+    enif_mutex_unlock(service_p->mutex);
+    return enif_make_badarg(env);
+  }
+
+  service_p->entries[i] = service_p->entries[--service_p->count];
+  uint64_t generation   = ++service_p->generation;
+
+  if (!service_p->stopping) rcl_trigger_guard_condition(&service_p->guard_condition);
+
+  // the timer may be finalized by the caller right after, wait for the thread to let it go, also
+  // while it is stopping since it may still be using the timer, it sets applied when it exits
+  while (service_p->applied < generation) enif_cond_wait(service_p->cond, service_p->mutex);
+
+  enif_mutex_unlock(service_p->mutex);
+  enif_release_resource(timer_p);
+
+  return atom_ok;
+}
+
+// Interrupt the wait for the thread to wait again with the current schedule of its timers, after
+// one of them has been reset, canceled or given another period.
+ERL_NIF_TERM nif_timer_service_wake(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  timer_service_t **service_pp;
+  if (!enif_get_resource(env, argv[0], rt_timer_service, (void **)&service_pp))
+    return enif_make_badarg(env);
+  timer_service_t *service_p = *service_pp;
+
+  enif_mutex_lock(service_p->mutex);
+
+  rcl_ret_t rc = RCL_RET_OK;
+  if (!service_p->stopping) rc = rcl_trigger_guard_condition(&service_p->guard_condition);
+
+  enif_mutex_unlock(service_p->mutex);
+
+  if (rc != RCL_RET_OK) return raise(env, __FILE__, __LINE__);
+
+  return atom_ok;
+}
@@ -0,0 +1,10 @@
+#include <erl_nif.h>
+
+extern void make_timer_service_atom(ErlNifEnv *env);
+extern void timer_service_dtor(ErlNifEnv *env, void *obj);
+
+ERL_NIF_TERM nif_timer_service_start(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_timer_service_stop(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_timer_service_add(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_timer_service_remove(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_timer_service_wake(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -0,0 +1,293 @@
+#include "waiter.h"
+#include "allocator.h"
+#include "macros.h"
+#include "rcl_event.h"
+#include "resource_types.h"
+#include "terms.h"
+#include <erl_nif.h>
+#include <rcl/allocator.h>
+#include <rcl/client.h>
+#include <rcl/context.h>
+#include <rcl/event.h>
+#include <rcl/guard_condition.h>
+#include <rcl/node.h>
+#include <rcl/service.h>
+#include <rcl/subscription.h>
+#include <rcl/types.h>
+#include <rcl/wait.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// A waiter blocks a native thread in rcl_wait, without timeout, on a subscription, service,
+// client or QoS event together with a guard condition. Once the entity is ready its owner is sent
+// the same {:new_message, 1}, {:new_request, 1}, {:new_response, 1} or {:new_event, type, 1} as
+// by the on new event callbacks, and the waiter is disarmed until the owner has taken and arms it
+// again, so that it doesn't spin on what is not taken yet. Triggering the guard condition
+// interrupts the wait, which is how the waiter is stopped.
+// Given a node, it waits on the graph guard condition of the node and sends {:graph_changed, 1}.
+
+typedef enum {
+  WAITER_SUBSCRIPTION,
+  WAITER_SERVICE,
+  WAITER_CLIENT,
+  WAITER_EVENT,
+  WAITER_GRAPH,
+} waiter_kind_t;
+
+typedef struct {
+  waiter_kind_t kind;
+  void *entity_p;
+  rcl_guard_condition_t *guard_condition_p;
+  rcl_context_t *context_p;
+  ErlNifPid pid;
+  ErlNifMutex *mutex;
+  ErlNifCond *cond;
+  ErlNifTid tid;
+  bool running;
+  bool armed;
+  bool stopping;
+} waiter_t;
+
+static ERL_NIF_TERM ready_atoms[5];
+
+void make_waiter_atoms(ErlNifEnv *env) {
+  ready_atoms[WAITER_SUBSCRIPTION] = enif_make_atom(env, "new_message");
+  ready_atoms[WAITER_SERVICE]      = enif_make_atom(env, "new_request");
+  ready_atoms[WAITER_CLIENT]       = enif_make_atom(env, "new_response");
+  ready_atoms[WAITER_EVENT]        = enif_make_atom(env, "new_event");
+  ready_atoms[WAITER_GRAPH]        = enif_make_atom(env, "graph_changed");
+}
+
+static rcl_ret_t waiter_add_entity(rcl_wait_set_t *wait_set_p, const waiter_t *waiter_p) {
+  switch (waiter_p->kind) {
+  case WAITER_SUBSCRIPTION:
+    return rcl_wait_set_add_subscription(wait_set_p, waiter_p->entity_p, NULL);
+  case WAITER_SERVICE:
+    return rcl_wait_set_add_service(wait_set_p, waiter_p->entity_p, NULL);
+  case WAITER_CLIENT:
+    return rcl_wait_set_add_client(wait_set_p, waiter_p->entity_p, NULL);
+  case WAITER_EVENT:
+    return rcl_wait_set_add_event(wait_set_p, waiter_p->entity_p, NULL);
+  case WAITER_GRAPH:
+    return rcl_wait_set_add_guard_condition(
+        wait_set_p, rcl_node_get_graph_guard_condition(waiter_p->entity_p), NULL);
+  }
+  return RCL_RET_ERROR;
+}
+
+static bool waiter_entity_is_ready(const rcl_wait_set_t *wait_set_p, const waiter_t *waiter_p) {
+  switch (waiter_p->kind) {
+  case WAITER_SUBSCRIPTION:
+    return wait_set_p->subscriptions[0] != NULL;
+  case WAITER_SERVICE:
+    return wait_set_p->services[0] != NULL;
+  case WAITER_CLIENT:
+    return wait_set_p->clients[0] != NULL;
+  case WAITER_EVENT:
+    return wait_set_p->events[0] != NULL;
+  case WAITER_GRAPH:
+    // the first one is the guard condition of the waiter
+    return wait_set_p->guard_conditions[1] != NULL;
+  }
+  return false;
+}
+
+static void *waiter_thread(void *arg) {
+  waiter_t *waiter_p = (waiter_t *)arg;
+
+  rcl_ret_t rc;
+  rcl_wait_set_t wait_set   = rcl_get_zero_initialized_wait_set();
+  rcl_allocator_t allocator = get_nif_allocator(MEMORY_ENTITIES);
+
+  size_t subscriptions    = waiter_p->kind == WAITER_SUBSCRIPTION;
+  size_t guard_conditions = waiter_p->kind == WAITER_GRAPH ? 2 : 1;
+  size_t clients          = waiter_p->kind == WAITER_CLIENT;
+  size_t services         = waiter_p->kind == WAITER_SERVICE;
+  size_t events           = waiter_p->kind == WAITER_EVENT;
+  rc = rcl_wait_set_init(&wait_set, subscriptions, guard_conditions, 0, clients, services, events,
+                         waiter_p->context_p, allocator);
+
+  ErlNifEnv *env = enif_alloc_env();
+
+  while (rc == RCL_RET_OK) {
+    enif_mutex_lock(waiter_p->mutex);
+    while (!waiter_p->armed && !waiter_p->stopping)
+      enif_cond_wait(waiter_p->cond, waiter_p->mutex);
+    bool stopping = waiter_p->stopping;
+    enif_mutex_unlock(waiter_p->mutex);
+    if (stopping) break;
+
+    rc = rcl_wait_set_clear(&wait_set);
+    if (rc != RCL_RET_OK) break;
+
+    rc = rcl_wait_set_add_guard_condition(&wait_set, waiter_p->guard_condition_p, NULL);
+    if (rc == RCL_RET_OK) rc = waiter_add_entity(&wait_set, waiter_p);
+    if (rc != RCL_RET_OK) break;
+
+    rc = rcl_wait(&wait_set, -1);
+    if (rc == RCL_RET_TIMEOUT) {
+      rc = RCL_RET_OK;
+      continue;
+    }
+    if (rc != RCL_RET_OK) break;
+
+    // only the guard condition was triggered, check whether to stop and wait again otherwise
+    if (!waiter_entity_is_ready(&wait_set, waiter_p)) continue;
+
+    enif_mutex_lock(waiter_p->mutex);
+    waiter_p->armed = false;
+    enif_mutex_unlock(waiter_p->mutex);
+
+    ERL_NIF_TERM msg;
+    if (waiter_p->kind == WAITER_EVENT)
+      msg = enif_make_tuple3(env, ready_atoms[WAITER_EVENT],
+                             event_resource_type(waiter_p->entity_p), enif_make_int(env, 1));
+    else
+      msg = enif_make_tuple2(env, ready_atoms[waiter_p->kind], enif_make_int(env, 1));
+    enif_send(NULL, &waiter_p->pid, env, msg);
+    enif_clear_env(env);
+  }
+
+  enif_free_env(env);
+  if (rcl_wait_set_is_valid(&wait_set)) rcl_wait_set_fini(&wait_set);
+
+  return NULL;
+}
+
+static void waiter_stop(waiter_t *waiter_p) {
+  if (!waiter_p->running) return;
+
+  enif_mutex_lock(waiter_p->mutex);
+  waiter_p->stopping = true;
+  enif_cond_signal(waiter_p->cond);
+  enif_mutex_unlock(waiter_p->mutex);
+
+  rcl_trigger_guard_condition(waiter_p->guard_condition_p);
+  enif_thread_join(waiter_p->tid, NULL);
+  waiter_p->running = false;
+
+  enif_release_resource(waiter_p->entity_p);
+  enif_release_resource(waiter_p->guard_condition_p);
+  enif_release_resource(waiter_p->context_p);
+}
+
+void waiter_dtor(ErlNifEnv *env, void *obj) {
+  ignore_unused(env);
+
+  waiter_t **waiter_pp = (waiter_t **)obj;
+  waiter_t *waiter_p   = *waiter_pp;
+  if (waiter_p == NULL) return;
+
+  waiter_stop(waiter_p);
+  if (waiter_p->cond != NULL) enif_cond_destroy(waiter_p->cond);
+  if (waiter_p->mutex != NULL) enif_mutex_destroy(waiter_p->mutex);
+  enif_free(waiter_p);
+}
+
+static bool get_entity(ErlNifEnv *env, ERL_NIF_TERM term, waiter_kind_t *kind_p,
+                       void **entity_pp) {
+  if (enif_get_resource(env, term, rt_rcl_subscription_t, entity_pp)) {
+    *kind_p = WAITER_SUBSCRIPTION;
+    return rcl_subscription_is_valid(*entity_pp);
+  }
+  if (enif_get_resource(env, term, rt_rcl_service_t, entity_pp)) {
+    *kind_p = WAITER_SERVICE;
+    return rcl_service_is_valid(*entity_pp);
+  }
+  if (enif_get_resource(env, term, rt_rcl_client_t, entity_pp)) {
+    *kind_p = WAITER_CLIENT;
+    return rcl_client_is_valid(*entity_pp);
+  }
+  if (enif_get_resource(env, term, rt_rcl_event_t, entity_pp)) {
+    *kind_p = WAITER_EVENT;
+    return rcl_event_is_valid(*entity_pp);
+  }
+  if (enif_get_resource(env, term, rt_rcl_node_t, entity_pp)) {
+    *kind_p = WAITER_GRAPH;
+    return rcl_node_is_valid(*entity_pp);
+  }
+  return false;
+}
+
+ERL_NIF_TERM nif_waiter_start(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3) return enif_make_badarg(env);
+
+  rcl_context_t *context_p;
+  if (!enif_get_resource(env, argv[0], rt_rcl_context_t, (void **)&context_p))
+    return enif_make_badarg(env);
+  if (!rcl_context_is_valid(context_p)) return raise(env, __FILE__, __LINE__);
+
+  waiter_kind_t kind;
+  void *entity_p;
+  if (!get_entity(env, argv[1], &kind, &entity_p)) return enif_make_badarg(env);
+
+  rcl_guard_condition_t *guard_condition_p;
+  if (!enif_get_resource(env, argv[2], rt_rcl_guard_condition_t, (void **)&guard_condition_p))
+    return enif_make_badarg(env);
+
+  ErlNifPid pid;
+  if (enif_self(env, &pid) == NULL) return raise(env, __FILE__, __LINE__);
+
+  waiter_t *waiter_p = enif_alloc(sizeof(waiter_t));
+  if (waiter_p == NULL) return raise(env, __FILE__, __LINE__);
+
+  *waiter_p                   = (waiter_t){0};
+  waiter_p->kind              = kind;
+  waiter_p->entity_p          = entity_p;
+  waiter_p->guard_condition_p = guard_condition_p;
+  waiter_p->context_p         = context_p;
+  waiter_p->pid               = pid;
+  waiter_p->armed             = true;
+  waiter_p->mutex             = enif_mutex_create("rclex_waiter");
+  waiter_p->cond              = enif_cond_create("rclex_waiter");
+
+  waiter_t **obj    = enif_alloc_resource(rt_waiter, sizeof(waiter_t *));
+  *obj              = waiter_p;
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  if (waiter_p->mutex == NULL || waiter_p->cond == NULL) return raise(env, __FILE__, __LINE__);
+
+  // the thread uses them until it is joined, even if the owner lets them go first
+  enif_keep_resource(entity_p);
+  enif_keep_resource(guard_condition_p);
+  enif_keep_resource(context_p);
+
+  if (enif_thread_create("rclex_waiter", &waiter_p->tid, waiter_thread, waiter_p, NULL) != 0) {
+    enif_release_resource(entity_p);
+    enif_release_resource(guard_condition_p);
+    enif_release_resource(context_p);
+    return raise(env, __FILE__, __LINE__);
+  }
+  waiter_p->running = true;
+
+  return term;
+}
+
+ERL_NIF_TERM nif_waiter_arm(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  waiter_t **waiter_pp;
+  if (!enif_get_resource(env, argv[0], rt_waiter, (void **)&waiter_pp))
+    return enif_make_badarg(env);
+  waiter_t *waiter_p = *waiter_pp;
+
+  enif_mutex_lock(waiter_p->mutex);
+  waiter_p->armed = true;
+  enif_cond_signal(waiter_p->cond);
+  enif_mutex_unlock(waiter_p->mutex);
+
+  return atom_ok;
+}
+
+ERL_NIF_TERM nif_waiter_stop(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  waiter_t **waiter_pp;
+  if (!enif_get_resource(env, argv[0], rt_waiter, (void **)&waiter_pp))
+    return enif_make_badarg(env);
+
+  waiter_stop(*waiter_pp);
+
+  return atom_ok;
+}
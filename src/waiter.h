@@ -0,0 +1,8 @@
+#include <erl_nif.h>
+
+extern void make_waiter_atoms(ErlNifEnv *env);
+extern void waiter_dtor(ErlNifEnv *env, void *obj);
+
+ERL_NIF_TERM nif_waiter_start(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_waiter_arm(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_waiter_stop(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
@@ -1,5 +1,8 @@
 // clang-format off
 #include "goal_info.h"
+#include "../../unique_identifier_msgs/msg/uuid.h"
+#include "../../builtin_interfaces/msg/time.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +14,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <builtin_interfaces/msg/detail/time__functions.h>
 #include <builtin_interfaces/msg/detail/time__struct.h>
@@ -40,6 +44,12 @@ ERL_NIF_TERM nif_action_msgs_msg_goal_info_type_support(ErlNifEnv *env, int argc
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  action_msgs__msg__GoalInfo__destroy((action_msgs__msg__GoalInfo *)message_p);
+}
+
 ERL_NIF_TERM nif_action_msgs_msg_goal_info_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -48,57 +58,36 @@ ERL_NIF_TERM nif_action_msgs_msg_goal_info_create(ErlNifEnv *env, int argc, cons
   action_msgs__msg__GoalInfo *message_p = action_msgs__msg__GoalInfo__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_action_msgs_msg_goal_info_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  action_msgs__msg__GoalInfo *message_p = (action_msgs__msg__GoalInfo *)*ros_message_pp;
-  action_msgs__msg__GoalInfo__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_action_msgs_msg_goal_info_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  action_msgs__msg__GoalInfo *message_p = (action_msgs__msg__GoalInfo *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  action_msgs__msg__GoalInfo *message_p = (action_msgs__msg__GoalInfo *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   int goal_id_arity;
   const ERL_NIF_TERM *goal_id_tuple;
   if (!enif_get_tuple(env, tuple[0], &goal_id_arity, &goal_id_tuple))
     return enif_make_badarg(env);
 
-  unsigned int goal_id_uuid_i;
-  ERL_NIF_TERM goal_id_uuid_left, goal_id_uuid_head, goal_id_uuid_tail;
-  for (goal_id_uuid_i = 0, goal_id_uuid_left = goal_id_tuple[0]; goal_id_uuid_i < 16; ++goal_id_uuid_i, goal_id_uuid_left = goal_id_uuid_tail)
-  {
-    if (!enif_get_list_cell(env, goal_id_uuid_left, &goal_id_uuid_head, &goal_id_uuid_tail))
-      return enif_make_badarg(env);
-
-    unsigned int goal_id_uuid_uint8;
-    if (!enif_get_uint(env, goal_id_uuid_head, &goal_id_uuid_uint8))
-      return enif_make_badarg(env);
-    message_p->goal_id.uuid[goal_id_uuid_i] = goal_id_uuid_uint8;
-  }
+  conversion_ret_t goal_id_uuid_ret = get_uint8_array(env, goal_id_tuple[0], message_p->goal_id.uuid, 16);
+  if (goal_id_uuid_ret != CONVERSION_OK)
+    return conversion_error(env, goal_id_uuid_ret);
 
   int stamp_arity;
   const ERL_NIF_TERM *stamp_tuple;
@@ -118,25 +107,27 @@ ERL_NIF_TERM nif_action_msgs_msg_goal_info_set(ErlNifEnv *env, int argc, const E
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_action_msgs_msg_goal_info_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+ERL_NIF_TERM nif_action_msgs_msg_goal_info_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  action_msgs__msg__GoalInfo *message_p = (action_msgs__msg__GoalInfo *)*ros_message_pp;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
 
-  ERL_NIF_TERM goal_id_uuid[16];
+  return term;
+}
 
-  for (size_t goal_id_uuid_i = 0; goal_id_uuid_i < 16; ++goal_id_uuid_i)
-  {
-    goal_id_uuid[goal_id_uuid_i] = enif_make_uint(env, message_p->goal_id.uuid[goal_id_uuid_i]);
-  }
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  action_msgs__msg__GoalInfo *message_p = (action_msgs__msg__GoalInfo *)ros_message_p;
 
   return enif_make_tuple(env, 2,
     enif_make_tuple(env, 1,
-      enif_make_list_from_array(env, goal_id_uuid, 16)
+      make_uint8_list(env, message_p->goal_id.uuid, 0, 16)
     ),
     enif_make_tuple(env, 2,
       enif_make_int(env, message_p->stamp.sec),
@@ -144,4 +135,66 @@ ERL_NIF_TERM nif_action_msgs_msg_goal_info_get(ErlNifEnv *env, int argc, const E
     )
   );
 }
+
+ERL_NIF_TERM nif_action_msgs_msg_goal_info_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_action_msgs_msg_goal_info_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const action_msgs__msg__GoalInfo *message_p = (const action_msgs__msg__GoalInfo *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return nif_unique_identifier_msgs_msg_uuid_make_field(env, &message_p->goal_id, rest);
+
+    return enif_make_tuple(env, 1,
+      make_uint8_list(env, message_p->goal_id.uuid, 0, 16)
+    );
+  }
+
+  case 1: {
+    if (!enif_is_empty_list(env, rest))
+      return nif_builtin_interfaces_msg_time_make_field(env, &message_p->stamp, rest);
+
+    return enif_make_tuple(env, 2,
+      enif_make_int(env, message_p->stamp.sec),
+      enif_make_uint(env, message_p->stamp.nanosec)
+    );
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+ERL_NIF_TERM nif_action_msgs_msg_goal_info_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_action_msgs_msg_goal_info_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 // clang-format on
@@ -32,6 +32,67 @@ defmodule Rclex.Pkgs.GeometryMsgs.Msg.Twist do
     Nif.geometry_msgs_msg_twist_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.geometry_msgs_msg_twist_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:linear | rest]) do
+    [0 | Rclex.Pkgs.GeometryMsgs.Msg.Vector3.field_path(rest)]
+  end
+
+  def field_path([:angular | rest]) do
+    [1 | Rclex.Pkgs.GeometryMsgs.Msg.Vector3.field_path(rest)]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:linear | rest], term) do
+    Rclex.Pkgs.GeometryMsgs.Msg.Vector3.field_value(rest, term)
+  end
+
+  def field_value([:angular | rest], term) do
+    Rclex.Pkgs.GeometryMsgs.Msg.Vector3.field_value(rest, term)
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{linear: linear, angular: angular}) do
+    acc
+    |> Rclex.Pkgs.GeometryMsgs.Msg.Vector3.cdr_put(linear)
+    |> Rclex.Pkgs.GeometryMsgs.Msg.Vector3.cdr_put(angular)
+  end
+
+  def cdr_take(cursor) do
+    {linear, cursor} = Rclex.Pkgs.GeometryMsgs.Msg.Vector3.cdr_take(cursor)
+    {angular, cursor} = Rclex.Pkgs.GeometryMsgs.Msg.Vector3.cdr_take(cursor)
+    {%__MODULE__{linear: linear, angular: angular}, cursor}
+  end
+
   def to_tuple(%__MODULE__{linear: linear, angular: angular}) do
     {Rclex.Pkgs.GeometryMsgs.Msg.Vector3.to_tuple(linear),
      Rclex.Pkgs.GeometryMsgs.Msg.Vector3.to_tuple(angular)}
@@ -1,5 +1,6 @@
 // clang-format off
 #include "vector3.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +12,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <geometry_msgs/msg/detail/vector3__functions.h>
 #include <geometry_msgs/msg/detail/vector3__struct.h>
@@ -34,6 +36,12 @@ ERL_NIF_TERM nif_geometry_msgs_msg_vector3_type_support(ErlNifEnv *env, int argc
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  geometry_msgs__msg__Vector3__destroy((geometry_msgs__msg__Vector3 *)message_p);
+}
+
 ERL_NIF_TERM nif_geometry_msgs_msg_vector3_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -42,39 +50,27 @@ ERL_NIF_TERM nif_geometry_msgs_msg_vector3_create(ErlNifEnv *env, int argc, cons
   geometry_msgs__msg__Vector3 *message_p = geometry_msgs__msg__Vector3__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_geometry_msgs_msg_vector3_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  geometry_msgs__msg__Vector3 *message_p = (geometry_msgs__msg__Vector3 *)*ros_message_pp;
-  geometry_msgs__msg__Vector3__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_geometry_msgs_msg_vector3_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  geometry_msgs__msg__Vector3 *message_p = (geometry_msgs__msg__Vector3 *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  geometry_msgs__msg__Vector3 *message_p = (geometry_msgs__msg__Vector3 *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   double x;
   if (!enif_get_double(env, tuple[0], &x))
@@ -94,14 +90,23 @@ ERL_NIF_TERM nif_geometry_msgs_msg_vector3_set(ErlNifEnv *env, int argc, const E
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 
-  geometry_msgs__msg__Vector3 *message_p = (geometry_msgs__msg__Vector3 *)*ros_message_pp;
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  geometry_msgs__msg__Vector3 *message_p = (geometry_msgs__msg__Vector3 *)ros_message_p;
 
   return enif_make_tuple(env, 3,
     enif_make_double(env, message_p->x),
@@ -109,4 +114,68 @@ ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get(ErlNifEnv *env, int argc, const E
     enif_make_double(env, message_p->z)
   );
 }
+
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const geometry_msgs__msg__Vector3 *message_p = (const geometry_msgs__msg__Vector3 *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_double(env, message_p->x);
+  }
+
+  case 1: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_double(env, message_p->y);
+  }
+
+  case 2: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_double(env, message_p->z);
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_geometry_msgs_msg_vector3_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 // clang-format on
@@ -30,6 +30,77 @@ defmodule Rclex.Pkgs.GeometryMsgs.Msg.Vector3 do
     Nif.geometry_msgs_msg_vector3_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.geometry_msgs_msg_vector3_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:x | rest]) do
+    [0 | rest]
+  end
+
+  def field_path([:y | rest]) do
+    [1 | rest]
+  end
+
+  def field_path([:z | rest]) do
+    [2 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:x], term) do
+    term
+  end
+
+  def field_value([:y], term) do
+    term
+  end
+
+  def field_value([:z], term) do
+    term
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{x: x, y: y, z: z}) do
+    acc
+    |> Rclex.CDR.put(:float64, x)
+    |> Rclex.CDR.put(:float64, y)
+    |> Rclex.CDR.put(:float64, z)
+  end
+
+  def cdr_take(cursor) do
+    {x, cursor} = Rclex.CDR.take(cursor, :float64)
+    {y, cursor} = Rclex.CDR.take(cursor, :float64)
+    {z, cursor} = Rclex.CDR.take(cursor, :float64)
+    {%__MODULE__{x: x, y: y, z: z}, cursor}
+  end
+
   def to_tuple(%__MODULE__{x: x, y: y, z: z}) do
     {x, y, z}
   end
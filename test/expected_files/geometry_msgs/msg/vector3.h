@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_geometry_msgs_msg_vector3_create(ErlNifEnv *env, int argc, cons
 ERL_NIF_TERM nif_geometry_msgs_msg_vector3_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_geometry_msgs_msg_vector3_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_geometry_msgs_msg_vector3_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
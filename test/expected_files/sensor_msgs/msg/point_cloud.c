@@ -1,5 +1,9 @@
 // clang-format off
 #include "point_cloud.h"
+#include "../../std_msgs/msg/header.h"
+#include "../../geometry_msgs/msg/point32.h"
+#include "../../sensor_msgs/msg/channel_float32.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +15,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <builtin_interfaces/msg/detail/time__functions.h>
 #include <builtin_interfaces/msg/detail/time__struct.h>
@@ -46,6 +51,12 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_type_support(ErlNifEnv *env, int ar
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  sensor_msgs__msg__PointCloud__destroy((sensor_msgs__msg__PointCloud *)message_p);
+}
+
 ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -54,39 +65,27 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_create(ErlNifEnv *env, int argc, co
   sensor_msgs__msg__PointCloud *message_p = sensor_msgs__msg__PointCloud__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  sensor_msgs__msg__PointCloud *message_p = (sensor_msgs__msg__PointCloud *)*ros_message_pp;
-  sensor_msgs__msg__PointCloud__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  sensor_msgs__msg__PointCloud *message_p = (sensor_msgs__msg__PointCloud *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  sensor_msgs__msg__PointCloud *message_p = (sensor_msgs__msg__PointCloud *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   int header_arity;
   const ERL_NIF_TERM *header_tuple;
@@ -108,21 +107,9 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set(ErlNifEnv *env, int argc, const
     return enif_make_badarg(env);
   message_p->header.stamp.nanosec = header_stamp_nanosec;
 
-  unsigned int header_frame_id_length;
-#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-  if (!enif_get_string_length(env, header_tuple[1], &header_frame_id_length, ERL_NIF_LATIN1))
-    return enif_make_badarg(env);
-#else
-  if (!enif_get_list_length(env, header_tuple[1], &header_frame_id_length))
-    return enif_make_badarg(env);
-#endif
-
-  char header_frame_id[header_frame_id_length + 1];
-  if (enif_get_string(env, header_tuple[1], header_frame_id, header_frame_id_length + 1, ERL_NIF_LATIN1) <= 0)
-    return enif_make_badarg(env);
-
-  if (!rosidl_runtime_c__String__assign(&(message_p->header.frame_id), header_frame_id))
-    return raise(env, __FILE__, __LINE__);
+  conversion_ret_t header_frame_id_ret = get_string(env, header_tuple[1], &(message_p->header.frame_id));
+  if (header_frame_id_ret != CONVERSION_OK)
+    return conversion_error(env, header_frame_id_ret);
 
   unsigned int points_length;
   if (!enif_get_list_length(env, tuple[1], &points_length))
@@ -180,21 +167,9 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set(ErlNifEnv *env, int argc, const
     if (!enif_get_tuple(env, channels_head, &channels_i_arity, &channels_i_tuple))
       return enif_make_badarg(env);
 
-    unsigned int channels_i_name_length;
-#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-    if (!enif_get_string_length(env, channels_i_tuple[0], &channels_i_name_length, ERL_NIF_LATIN1))
-      return enif_make_badarg(env);
-#else
-    if (!enif_get_list_length(env, channels_i_tuple[0], &channels_i_name_length))
-      return enif_make_badarg(env);
-#endif
-
-    char channels_i_name[channels_i_name_length + 1];
-    if (enif_get_string(env, channels_i_tuple[0], channels_i_name, channels_i_name_length + 1, ERL_NIF_LATIN1) <= 0)
-      return enif_make_badarg(env);
-
-    if (!rosidl_runtime_c__String__assign(&(message_p->channels.data[channels_i].name), channels_i_name))
-      return raise(env, __FILE__, __LINE__);
+    conversion_ret_t channels_i_name_ret = get_string(env, channels_i_tuple[0], &(message_p->channels.data[channels_i].name));
+    if (channels_i_name_ret != CONVERSION_OK)
+      return conversion_error(env, channels_i_name_ret);
 
     unsigned int channels_i_values_length;
     if (!enif_get_list_length(env, channels_i_tuple[1], &channels_i_values_length))
@@ -205,58 +180,53 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set(ErlNifEnv *env, int argc, const
       return enif_make_badarg(env);
     message_p->channels.data[channels_i].values = channels_i_values;
 
-    unsigned int channels_i_values_i;
-    ERL_NIF_TERM channels_i_values_left, channels_i_values_head, channels_i_values_tail;
-    for (channels_i_values_i = 0, channels_i_values_left = channels_i_tuple[1]; channels_i_values_i < channels_i_values_length; ++channels_i_values_i, channels_i_values_left = channels_i_values_tail)
-    {
-      if (!enif_get_list_cell(env, channels_i_values_left, &channels_i_values_head, &channels_i_values_tail))
-        return enif_make_badarg(env);
-
-      double channels_i_values_float32;
-      if (!enif_get_double(env, channels_i_values_head, &channels_i_values_float32))
-        return enif_make_badarg(env);
-      message_p->channels.data[channels_i].values.data[channels_i_values_i] = (float)channels_i_values_float32;
-    }
+    conversion_ret_t channels_i_values_ret = get_float32_array(env, channels_i_tuple[1], message_p->channels.data[channels_i].values.data, channels_i_values_length);
+    if (channels_i_values_ret != CONVERSION_OK)
+      return conversion_error(env, channels_i_values_ret);
   }
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+static ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 
-  sensor_msgs__msg__PointCloud *message_p = (sensor_msgs__msg__PointCloud *)*ros_message_pp;
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  sensor_msgs__msg__PointCloud *message_p = (sensor_msgs__msg__PointCloud *)ros_message_p;
 
-  ERL_NIF_TERM points[message_p->points.size];
+  ERL_NIF_TERM points = enif_make_list(env, 0);
 
-  for (size_t points_i = 0; points_i < message_p->points.size; ++points_i)
+  for (size_t points_i = message_p->points.size; points_i-- > 0;)
   {
-    points[points_i] = enif_make_tuple(env, 3,
+    ERL_NIF_TERM points_i_term = enif_make_tuple(env, 3,
       enif_make_double(env, message_p->points.data[points_i].x),
       enif_make_double(env, message_p->points.data[points_i].y),
       enif_make_double(env, message_p->points.data[points_i].z)
     );
+    points = enif_make_list_cell(env, points_i_term, points);
   }
 
-  ERL_NIF_TERM channels[message_p->channels.size];
+  ERL_NIF_TERM channels = enif_make_list(env, 0);
 
-  for (size_t channels_i = 0; channels_i < message_p->channels.size; ++channels_i)
+  for (size_t channels_i = message_p->channels.size; channels_i-- > 0;)
   {
-    ERL_NIF_TERM channels_values[message_p->channels.data[channels_i].values.size];
-
-    for (size_t channels_values_i = 0; channels_values_i < message_p->channels.data[channels_i].values.size; ++channels_values_i)
-    {
-      channels_values[channels_values_i] = enif_make_double(env, message_p->channels.data[channels_i].values.data[channels_values_i]);
-    }
-
-    channels[channels_i] = enif_make_tuple(env, 2,
+    ERL_NIF_TERM channels_i_term = enif_make_tuple(env, 2,
       enif_make_string(env, message_p->channels.data[channels_i].name.data, ERL_NIF_LATIN1),
-      enif_make_list_from_array(env, channels_values, message_p->channels.data[channels_i].values.size)
+      make_float32_list(env, message_p->channels.data[channels_i].values.data, 0, message_p->channels.data[channels_i].values.size)
     );
+    channels = enif_make_list_cell(env, channels_i_term, channels);
   }
 
   return enif_make_tuple(env, 3,
@@ -267,8 +237,229 @@ ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get(ErlNifEnv *env, int argc, const
       ),
       enif_make_string(env, message_p->header.frame_id.data, ERL_NIF_LATIN1)
     ),
-    enif_make_list_from_array(env, points, message_p->points.size),
-    enif_make_list_from_array(env, channels, message_p->channels.size)
+    points,
+    channels
   );
 }
+
+static ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+// The size hint of the message, 0 if it isn't one, the conversion then fails right away.
+static size_t size_hint(ErlNifEnv *env, ERL_NIF_TERM term) {
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, term, rt_ros_message, (void **)&ros_message_p)) return 0;
+  const sensor_msgs__msg__PointCloud *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return 0;
+
+  size_t elements = 0;
+  elements += message_p->points.size;
+  elements += message_p->channels.size;
+  for (size_t i_0 = 0; i_0 < message_p->channels.size; ++i_0) {
+    elements += message_p->channels.data[i_0].values.size;
+  }
+  release_ros_message(ros_message_p);
+
+  return elements;
+}
+
+ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_sensor_msgs_msg_point_cloud_set", term_size_hint(env, argv[1]), nif_sensor_msgs_msg_point_cloud_set_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_sensor_msgs_msg_point_cloud_get", size_hint(env, argv[0]), nif_sensor_msgs_msg_point_cloud_get_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const sensor_msgs__msg__PointCloud *message_p = (const sensor_msgs__msg__PointCloud *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return nif_std_msgs_msg_header_make_field(env, &message_p->header, rest);
+
+    return enif_make_tuple(env, 2,
+      enif_make_tuple(env, 2,
+        enif_make_int(env, message_p->header.stamp.sec),
+        enif_make_uint(env, message_p->header.stamp.nanosec)
+      ),
+      enif_make_string(env, message_p->header.frame_id.data, ERL_NIF_LATIN1)
+    );
+  }
+
+  case 1: {
+    size_t points_size = message_p->points.size;
+
+    if (enif_is_empty_list(env, rest)) {
+      ERL_NIF_TERM points = enif_make_list(env, 0);
+
+      for (size_t points_i = message_p->points.size; points_i-- > 0;)
+      {
+        ERL_NIF_TERM points_i_term = enif_make_tuple(env, 3,
+          enif_make_double(env, message_p->points.data[points_i].x),
+          enif_make_double(env, message_p->points.data[points_i].y),
+          enif_make_double(env, message_p->points.data[points_i].z)
+        );
+        points = enif_make_list_cell(env, points_i_term, points);
+      }
+
+      return points;
+    }
+
+    ERL_NIF_TERM points_head, points_rest;
+    if (!enif_get_list_cell(env, rest, &points_head, &points_rest))
+      return enif_make_badarg(env);
+
+    size_t points_i;
+    unsigned long points_index;
+    if (enif_get_ulong(env, points_head, &points_index)) {
+      if (points_index >= points_size) return enif_make_badarg(env);
+      points_i = points_index;
+
+      if (!enif_is_empty_list(env, points_rest))
+        return nif_geometry_msgs_msg_point32_make_field(env, &message_p->points.data[points_i], points_rest);
+
+      return enif_make_tuple(env, 3,
+        enif_make_double(env, message_p->points.data[points_i].x),
+        enif_make_double(env, message_p->points.data[points_i].y),
+        enif_make_double(env, message_p->points.data[points_i].z)
+      );
+    }
+
+    int points_arity;
+    const ERL_NIF_TERM *points_slice;
+    unsigned long points_start, points_length;
+    if (!enif_get_tuple(env, points_head, &points_arity, &points_slice) || points_arity != 2 ||
+        !enif_get_ulong(env, points_slice[0], &points_start) ||
+        !enif_get_ulong(env, points_slice[1], &points_length) ||
+        !enif_is_empty_list(env, points_rest))
+      return enif_make_badarg(env);
+
+    if (points_start > points_size) points_start = points_size;
+    if (points_length > points_size - points_start) points_length = points_size - points_start;
+
+    ERL_NIF_TERM points = enif_make_list(env, 0);
+
+    for (points_i = points_start + points_length; points_i-- > points_start;)
+    {
+      ERL_NIF_TERM points_i_term = enif_make_tuple(env, 3,
+        enif_make_double(env, message_p->points.data[points_i].x),
+        enif_make_double(env, message_p->points.data[points_i].y),
+        enif_make_double(env, message_p->points.data[points_i].z)
+      );
+      points = enif_make_list_cell(env, points_i_term, points);
+    }
+
+    return points;
+  }
+
+  case 2: {
+    size_t channels_size = message_p->channels.size;
+
+    if (enif_is_empty_list(env, rest)) {
+      ERL_NIF_TERM channels = enif_make_list(env, 0);
+
+      for (size_t channels_i = message_p->channels.size; channels_i-- > 0;)
+      {
+        ERL_NIF_TERM channels_i_term = enif_make_tuple(env, 2,
+          enif_make_string(env, message_p->channels.data[channels_i].name.data, ERL_NIF_LATIN1),
+          make_float32_list(env, message_p->channels.data[channels_i].values.data, 0, message_p->channels.data[channels_i].values.size)
+        );
+        channels = enif_make_list_cell(env, channels_i_term, channels);
+      }
+
+      return channels;
+    }
+
+    ERL_NIF_TERM channels_head, channels_rest;
+    if (!enif_get_list_cell(env, rest, &channels_head, &channels_rest))
+      return enif_make_badarg(env);
+
+    size_t channels_i;
+    unsigned long channels_index;
+    if (enif_get_ulong(env, channels_head, &channels_index)) {
+      if (channels_index >= channels_size) return enif_make_badarg(env);
+      channels_i = channels_index;
+
+      if (!enif_is_empty_list(env, channels_rest))
+        return nif_sensor_msgs_msg_channel_float32_make_field(env, &message_p->channels.data[channels_i], channels_rest);
+
+      return enif_make_tuple(env, 2,
+        enif_make_string(env, message_p->channels.data[channels_i].name.data, ERL_NIF_LATIN1),
+        make_float32_list(env, message_p->channels.data[channels_i].values.data, 0, message_p->channels.data[channels_i].values.size)
+      );
+    }
+
+    int channels_arity;
+    const ERL_NIF_TERM *channels_slice;
+    unsigned long channels_start, channels_length;
+    if (!enif_get_tuple(env, channels_head, &channels_arity, &channels_slice) || channels_arity != 2 ||
+        !enif_get_ulong(env, channels_slice[0], &channels_start) ||
+        !enif_get_ulong(env, channels_slice[1], &channels_length) ||
+        !enif_is_empty_list(env, channels_rest))
+      return enif_make_badarg(env);
+
+    if (channels_start > channels_size) channels_start = channels_size;
+    if (channels_length > channels_size - channels_start) channels_length = channels_size - channels_start;
+
+    ERL_NIF_TERM channels = enif_make_list(env, 0);
+
+    for (channels_i = channels_start + channels_length; channels_i-- > channels_start;)
+    {
+      ERL_NIF_TERM channels_i_term = enif_make_tuple(env, 2,
+        enif_make_string(env, message_p->channels.data[channels_i].name.data, ERL_NIF_LATIN1),
+        make_float32_list(env, message_p->channels.data[channels_i].values.data, 0, message_p->channels.data[channels_i].values.size)
+      );
+      channels = enif_make_list_cell(env, channels_i_term, channels);
+    }
+
+    return channels;
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+static ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get_field_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_sensor_msgs_msg_point_cloud_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_sensor_msgs_msg_point_cloud_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_sensor_msgs_msg_point_cloud_get_field", size_hint(env, argv[0]), nif_sensor_msgs_msg_point_cloud_get_field_impl, argc, argv);
+}
 // clang-format on
@@ -34,6 +34,95 @@ defmodule Rclex.Pkgs.SensorMsgs.Msg.PointCloud do
     Nif.sensor_msgs_msg_point_cloud_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.sensor_msgs_msg_point_cloud_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:header | rest]) do
+    [0 | Rclex.Pkgs.StdMsgs.Msg.Header.field_path(rest)]
+  end
+
+  def field_path([:points, index | rest]) when is_integer(index) do
+    [1, index | Rclex.Pkgs.GeometryMsgs.Msg.Point32.field_path(rest)]
+  end
+
+  def field_path([:points | rest]) do
+    [1 | rest]
+  end
+
+  def field_path([:channels, index | rest]) when is_integer(index) do
+    [2, index | Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32.field_path(rest)]
+  end
+
+  def field_path([:channels | rest]) do
+    [2 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:header | rest], term) do
+    Rclex.Pkgs.StdMsgs.Msg.Header.field_value(rest, term)
+  end
+
+  def field_value([:points, index | rest], term) when is_integer(index) do
+    Rclex.Pkgs.GeometryMsgs.Msg.Point32.field_value(rest, term)
+  end
+
+  def field_value([:points | _], term) do
+    Enum.map(term, &Rclex.Pkgs.GeometryMsgs.Msg.Point32.to_struct/1)
+  end
+
+  def field_value([:channels, index | rest], term) when is_integer(index) do
+    Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32.field_value(rest, term)
+  end
+
+  def field_value([:channels | _], term) do
+    Enum.map(term, &Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32.to_struct/1)
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{header: header, points: points, channels: channels}) do
+    acc
+    |> Rclex.Pkgs.StdMsgs.Msg.Header.cdr_put(header)
+    |> Rclex.CDR.put_sequence(&Rclex.Pkgs.GeometryMsgs.Msg.Point32.cdr_put/2, points)
+    |> Rclex.CDR.put_sequence(&Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32.cdr_put/2, channels)
+  end
+
+  def cdr_take(cursor) do
+    {header, cursor} = Rclex.Pkgs.StdMsgs.Msg.Header.cdr_take(cursor)
+    {points, cursor} =
+      Rclex.CDR.take_sequence(cursor, &Rclex.Pkgs.GeometryMsgs.Msg.Point32.cdr_take/1)
+    {channels, cursor} =
+      Rclex.CDR.take_sequence(cursor, &Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32.cdr_take/1)
+    {%__MODULE__{header: header, points: points, channels: channels}, cursor}
+  end
+
   def to_tuple(%__MODULE__{header: header, points: points, channels: channels}) do
     {Rclex.Pkgs.StdMsgs.Msg.Header.to_tuple(header),
      for struct <- points do
@@ -1,5 +1,6 @@
 // clang-format off
 #include "empty.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +12,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <std_msgs/msg/detail/empty__functions.h>
 #include <std_msgs/msg/detail/empty__struct.h>
@@ -34,6 +36,12 @@ ERL_NIF_TERM nif_std_msgs_msg_empty_type_support(ErlNifEnv *env, int argc, const
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  std_msgs__msg__Empty__destroy((std_msgs__msg__Empty *)message_p);
+}
+
 ERL_NIF_TERM nif_std_msgs_msg_empty_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -42,23 +50,25 @@ ERL_NIF_TERM nif_std_msgs_msg_empty_create(ErlNifEnv *env, int argc, const ERL_N
   std_msgs__msg__Empty *message_p = std_msgs__msg__Empty__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_std_msgs_msg_empty_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  std_msgs__msg__Empty *message_p = (std_msgs__msg__Empty *)*ros_message_pp;
-  std_msgs__msg__Empty__destroy(message_p);
+  destroy_ros_message(ros_message_p);
+
+  return atom_ok;
+}
+
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  ignore_unused(env);
+  ignore_unused(ros_message_p);
+  ignore_unused(term);
 
   return atom_ok;
 }
@@ -66,20 +76,58 @@ ERL_NIF_TERM nif_std_msgs_msg_empty_destroy(ErlNifEnv *env, int argc, const ERL_
 ERL_NIF_TERM nif_std_msgs_msg_empty_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  return atom_ok;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  ignore_unused(ros_message_p);
+
+  return enif_make_tuple(env, 0);
 }
 
 ERL_NIF_TERM nif_std_msgs_msg_empty_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  return enif_make_tuple(env, 0);
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_empty_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  ignore_unused(ros_message_p);
+  ignore_unused(path);
+
+  return enif_make_badarg(env);
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_empty_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_std_msgs_msg_empty_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
 }
 // clang-format on
@@ -28,6 +28,48 @@ defmodule Rclex.Pkgs.StdMsgs.Msg.Empty do
     Nif.std_msgs_msg_empty_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_msgs_msg_empty_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{}) do
+    Rclex.CDR.put(acc, :uint8, 0)
+  end
+
+  def cdr_take(cursor) do
+    {_structure_needs_at_least_one_member, cursor} = Rclex.CDR.take(cursor, :uint8)
+    {%__MODULE__{}, cursor}
+  end
+
   def to_tuple(%__MODULE__{}) do
     {}
   end
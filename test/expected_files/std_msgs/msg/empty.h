@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_std_msgs_msg_empty_create(ErlNifEnv *env, int argc, const ERL_N
 ERL_NIF_TERM nif_std_msgs_msg_empty_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_empty_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_empty_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_empty_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_empty_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
@@ -30,6 +30,77 @@ defmodule Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension do
     Nif.std_msgs_msg_multi_array_dimension_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_msgs_msg_multi_array_dimension_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:label | rest]) do
+    [0 | rest]
+  end
+
+  def field_path([:size | rest]) do
+    [1 | rest]
+  end
+
+  def field_path([:stride | rest]) do
+    [2 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:label], term) do
+    "#{term}"
+  end
+
+  def field_value([:size], term) do
+    term
+  end
+
+  def field_value([:stride], term) do
+    term
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{label: label, size: size, stride: stride}) do
+    acc
+    |> Rclex.CDR.put(:string, label)
+    |> Rclex.CDR.put(:uint32, size)
+    |> Rclex.CDR.put(:uint32, stride)
+  end
+
+  def cdr_take(cursor) do
+    {label, cursor} = Rclex.CDR.take(cursor, :string)
+    {size, cursor} = Rclex.CDR.take(cursor, :uint32)
+    {stride, cursor} = Rclex.CDR.take(cursor, :uint32)
+    {%__MODULE__{label: label, size: size, stride: stride}, cursor}
+  end
+
   def to_tuple(%__MODULE__{label: label, size: size, stride: stride}) do
     {~c"#{label}", size, stride}
   end
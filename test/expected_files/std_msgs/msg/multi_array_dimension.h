@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_create(ErlNifEnv *env, int a
 ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_dimension_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
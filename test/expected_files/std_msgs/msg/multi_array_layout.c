@@ -1,5 +1,7 @@
 // clang-format off
 #include "multi_array_layout.h"
+#include "../../std_msgs/msg/multi_array_dimension.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +13,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <std_msgs/msg/detail/multi_array_dimension__functions.h>
 #include <std_msgs/msg/detail/multi_array_dimension__struct.h>
@@ -37,6 +40,12 @@ ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_type_support(ErlNifEnv *env, in
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  std_msgs__msg__MultiArrayLayout__destroy((std_msgs__msg__MultiArrayLayout *)message_p);
+}
+
 ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -45,39 +54,27 @@ ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_create(ErlNifEnv *env, int argc
   std_msgs__msg__MultiArrayLayout *message_p = std_msgs__msg__MultiArrayLayout__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  std_msgs__msg__MultiArrayLayout *message_p = (std_msgs__msg__MultiArrayLayout *)*ros_message_pp;
-  std_msgs__msg__MultiArrayLayout__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  std_msgs__msg__MultiArrayLayout *message_p = (std_msgs__msg__MultiArrayLayout *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  std_msgs__msg__MultiArrayLayout *message_p = (std_msgs__msg__MultiArrayLayout *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   unsigned int dim_length;
   if (!enif_get_list_length(env, tuple[0], &dim_length))
@@ -99,21 +96,9 @@ ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_set(ErlNifEnv *env, int argc, c
     if (!enif_get_tuple(env, dim_head, &dim_i_arity, &dim_i_tuple))
       return enif_make_badarg(env);
 
-    unsigned int dim_i_label_length;
-#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-    if (!enif_get_string_length(env, dim_i_tuple[0], &dim_i_label_length, ERL_NIF_LATIN1))
-      return enif_make_badarg(env);
-#else
-    if (!enif_get_list_length(env, dim_i_tuple[0], &dim_i_label_length))
-      return enif_make_badarg(env);
-#endif
-
-    char dim_i_label[dim_i_label_length + 1];
-    if (enif_get_string(env, dim_i_tuple[0], dim_i_label, dim_i_label_length + 1, ERL_NIF_LATIN1) <= 0)
-      return enif_make_badarg(env);
-
-    if (!rosidl_runtime_c__String__assign(&(message_p->dim.data[dim_i].label), dim_i_label))
-      return raise(env, __FILE__, __LINE__);
+    conversion_ret_t dim_i_label_ret = get_string(env, dim_i_tuple[0], &(message_p->dim.data[dim_i].label));
+    if (dim_i_label_ret != CONVERSION_OK)
+      return conversion_error(env, dim_i_label_ret);
 
     unsigned int dim_i_size;
     if (!enif_get_uint(env, dim_i_tuple[1], &dim_i_size))
@@ -134,29 +119,187 @@ ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_set(ErlNifEnv *env, int argc, c
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+static ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_set_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  std_msgs__msg__MultiArrayLayout *message_p = (std_msgs__msg__MultiArrayLayout *)*ros_message_pp;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
 
-  ERL_NIF_TERM dim[message_p->dim.size];
+  return term;
+}
+
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  std_msgs__msg__MultiArrayLayout *message_p = (std_msgs__msg__MultiArrayLayout *)ros_message_p;
+
+  ERL_NIF_TERM dim = enif_make_list(env, 0);
 
-  for (size_t dim_i = 0; dim_i < message_p->dim.size; ++dim_i)
+  for (size_t dim_i = message_p->dim.size; dim_i-- > 0;)
   {
-    dim[dim_i] = enif_make_tuple(env, 3,
+    ERL_NIF_TERM dim_i_term = enif_make_tuple(env, 3,
       enif_make_string(env, message_p->dim.data[dim_i].label.data, ERL_NIF_LATIN1),
       enif_make_uint(env, message_p->dim.data[dim_i].size),
       enif_make_uint(env, message_p->dim.data[dim_i].stride)
     );
+    dim = enif_make_list_cell(env, dim_i_term, dim);
   }
 
   return enif_make_tuple(env, 2,
-    enif_make_list_from_array(env, dim, message_p->dim.size),
+    dim,
     enif_make_uint(env, message_p->data_offset)
   );
 }
+
+static ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_get_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+// The size hint of the message, 0 if it isn't one, the conversion then fails right away.
+static size_t size_hint(ErlNifEnv *env, ERL_NIF_TERM term) {
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, term, rt_ros_message, (void **)&ros_message_p)) return 0;
+  const std_msgs__msg__MultiArrayLayout *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return 0;
+
+  size_t elements = 0;
+  elements += message_p->dim.size;
+  release_ros_message(ros_message_p);
+
+  return elements;
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_multi_array_layout_set", term_size_hint(env, argv[1]), nif_std_msgs_msg_multi_array_layout_set_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_multi_array_layout_get", size_hint(env, argv[0]), nif_std_msgs_msg_multi_array_layout_get_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const std_msgs__msg__MultiArrayLayout *message_p = (const std_msgs__msg__MultiArrayLayout *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    size_t dim_size = message_p->dim.size;
+
+    if (enif_is_empty_list(env, rest)) {
+      ERL_NIF_TERM dim = enif_make_list(env, 0);
+
+      for (size_t dim_i = message_p->dim.size; dim_i-- > 0;)
+      {
+        ERL_NIF_TERM dim_i_term = enif_make_tuple(env, 3,
+          enif_make_string(env, message_p->dim.data[dim_i].label.data, ERL_NIF_LATIN1),
+          enif_make_uint(env, message_p->dim.data[dim_i].size),
+          enif_make_uint(env, message_p->dim.data[dim_i].stride)
+        );
+        dim = enif_make_list_cell(env, dim_i_term, dim);
+      }
+
+      return dim;
+    }
+
+    ERL_NIF_TERM dim_head, dim_rest;
+    if (!enif_get_list_cell(env, rest, &dim_head, &dim_rest))
+      return enif_make_badarg(env);
+
+    size_t dim_i;
+    unsigned long dim_index;
+    if (enif_get_ulong(env, dim_head, &dim_index)) {
+      if (dim_index >= dim_size) return enif_make_badarg(env);
+      dim_i = dim_index;
+
+      if (!enif_is_empty_list(env, dim_rest))
+        return nif_std_msgs_msg_multi_array_dimension_make_field(env, &message_p->dim.data[dim_i], dim_rest);
+
+      return enif_make_tuple(env, 3,
+        enif_make_string(env, message_p->dim.data[dim_i].label.data, ERL_NIF_LATIN1),
+        enif_make_uint(env, message_p->dim.data[dim_i].size),
+        enif_make_uint(env, message_p->dim.data[dim_i].stride)
+      );
+    }
+
+    int dim_arity;
+    const ERL_NIF_TERM *dim_slice;
+    unsigned long dim_start, dim_length;
+    if (!enif_get_tuple(env, dim_head, &dim_arity, &dim_slice) || dim_arity != 2 ||
+        !enif_get_ulong(env, dim_slice[0], &dim_start) ||
+        !enif_get_ulong(env, dim_slice[1], &dim_length) ||
+        !enif_is_empty_list(env, dim_rest))
+      return enif_make_badarg(env);
+
+    if (dim_start > dim_size) dim_start = dim_size;
+    if (dim_length > dim_size - dim_start) dim_length = dim_size - dim_start;
+
+    ERL_NIF_TERM dim = enif_make_list(env, 0);
+
+    for (dim_i = dim_start + dim_length; dim_i-- > dim_start;)
+    {
+      ERL_NIF_TERM dim_i_term = enif_make_tuple(env, 3,
+        enif_make_string(env, message_p->dim.data[dim_i].label.data, ERL_NIF_LATIN1),
+        enif_make_uint(env, message_p->dim.data[dim_i].size),
+        enif_make_uint(env, message_p->dim.data[dim_i].stride)
+      );
+      dim = enif_make_list_cell(env, dim_i_term, dim);
+    }
+
+    return dim;
+  }
+
+  case 1: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_uint(env, message_p->data_offset);
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+static ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_get_field_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_std_msgs_msg_multi_array_layout_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_multi_array_layout_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_multi_array_layout_get_field", size_hint(env, argv[0]), nif_std_msgs_msg_multi_array_layout_get_field_impl, argc, argv);
+}
 // clang-format on
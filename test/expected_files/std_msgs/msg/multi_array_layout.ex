@@ -32,6 +32,76 @@ defmodule Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout do
     Nif.std_msgs_msg_multi_array_layout_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_msgs_msg_multi_array_layout_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:dim, index | rest]) when is_integer(index) do
+    [0, index | Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.field_path(rest)]
+  end
+
+  def field_path([:dim | rest]) do
+    [0 | rest]
+  end
+
+  def field_path([:data_offset | rest]) do
+    [1 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:dim, index | rest], term) when is_integer(index) do
+    Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.field_value(rest, term)
+  end
+
+  def field_value([:dim | _], term) do
+    Enum.map(term, &Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.to_struct/1)
+  end
+
+  def field_value([:data_offset], term) do
+    term
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{dim: dim, data_offset: data_offset}) do
+    acc
+    |> Rclex.CDR.put_sequence(&Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.cdr_put/2, dim)
+    |> Rclex.CDR.put(:uint32, data_offset)
+  end
+
+  def cdr_take(cursor) do
+    {dim, cursor} =
+      Rclex.CDR.take_sequence(cursor, &Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.cdr_take/1)
+    {data_offset, cursor} = Rclex.CDR.take(cursor, :uint32)
+    {%__MODULE__{dim: dim, data_offset: data_offset}, cursor}
+  end
+
   def to_tuple(%__MODULE__{dim: dim, data_offset: data_offset}) do
     {for struct <- dim do
        Rclex.Pkgs.StdMsgs.Msg.MultiArrayDimension.to_tuple(struct)
@@ -1,5 +1,6 @@
 // clang-format off
 #include "string.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +12,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <std_msgs/msg/detail/string__functions.h>
 #include <std_msgs/msg/detail/string__struct.h>
@@ -34,6 +36,12 @@ ERL_NIF_TERM nif_std_msgs_msg_string_type_support(ErlNifEnv *env, int argc, cons
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  std_msgs__msg__String__destroy((std_msgs__msg__String *)message_p);
+}
+
 ERL_NIF_TERM nif_std_msgs_msg_string_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -42,23 +50,31 @@ ERL_NIF_TERM nif_std_msgs_msg_string_create(ErlNifEnv *env, int argc, const ERL_
   std_msgs__msg__String *message_p = std_msgs__msg__String__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_std_msgs_msg_string_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  std_msgs__msg__String *message_p = (std_msgs__msg__String *)*ros_message_pp;
-  std_msgs__msg__String__destroy(message_p);
+  destroy_ros_message(ros_message_p);
+
+  return atom_ok;
+}
+
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  std_msgs__msg__String *message_p = (std_msgs__msg__String *)ros_message_p;
+
+  int arity;
+  const ERL_NIF_TERM *tuple;
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
+
+  conversion_ret_t data_ret = get_string(env, tuple[0], &(message_p->data));
+  if (data_ret != CONVERSION_OK)
+    return conversion_error(env, data_ret);
 
   return atom_ok;
 }
@@ -66,46 +82,73 @@ ERL_NIF_TERM nif_std_msgs_msg_string_destroy(ErlNifEnv *env, int argc, const ERL
 ERL_NIF_TERM nif_std_msgs_msg_string_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  std_msgs__msg__String *message_p = (std_msgs__msg__String *)*ros_message_pp;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
 
-  int arity;
-  const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  return term;
+}
 
-  unsigned int data_length;
-#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-  if (!enif_get_string_length(env, tuple[0], &data_length, ERL_NIF_LATIN1))
-    return enif_make_badarg(env);
-#else
-  if (!enif_get_list_length(env, tuple[0], &data_length))
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  std_msgs__msg__String *message_p = (std_msgs__msg__String *)ros_message_p;
+
+  return enif_make_tuple(env, 1,
+    enif_make_string(env, message_p->data.data, ERL_NIF_LATIN1)
+  );
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_string_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
-#endif
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 
-  char data[data_length + 1];
-  if (enif_get_string(env, tuple[0], data, data_length + 1, ERL_NIF_LATIN1) <= 0)
+ERL_NIF_TERM nif_std_msgs_msg_string_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const std_msgs__msg__String *message_p = (const std_msgs__msg__String *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
     return enif_make_badarg(env);
 
-  if (!rosidl_runtime_c__String__assign(&(message_p->data), data))
-    return raise(env, __FILE__, __LINE__);
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
 
-  return atom_ok;
+    return enif_make_string(env, message_p->data.data, ERL_NIF_LATIN1);
+  }
+  }
+
+  return enif_make_badarg(env);
 }
 
-ERL_NIF_TERM nif_std_msgs_msg_string_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+ERL_NIF_TERM nif_std_msgs_msg_string_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  std_msgs__msg__String *message_p = (std_msgs__msg__String *)*ros_message_pp;
+  ERL_NIF_TERM term = nif_std_msgs_msg_string_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
 
-  return enif_make_tuple(env, 1,
-    enif_make_string(env, message_p->data.data, ERL_NIF_LATIN1)
-  );
+  return term;
 }
 // clang-format on
@@ -28,6 +28,57 @@ defmodule Rclex.Pkgs.StdMsgs.Msg.String do
     Nif.std_msgs_msg_string_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_msgs_msg_string_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:data | rest]) do
+    [0 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:data], term) do
+    "#{term}"
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{data: data}) do
+    acc
+    |> Rclex.CDR.put(:string, data)
+  end
+
+  def cdr_take(cursor) do
+    {data, cursor} = Rclex.CDR.take(cursor, :string)
+    {%__MODULE__{data: data}, cursor}
+  end
+
   def to_tuple(%__MODULE__{data: data}) do
     {~c"#{data}"}
   end
@@ -0,0 +1,25 @@
+// clang-format off
+#include "string.h"
+#include "../../../macros.h"
+#include "../../../resource_types.h"
+
+#include <erl_nif.h>
+
+#include <rosidl_runtime_c/message_type_support_struct.h>
+
+#include <std_msgs/msg/detail/string__type_support.h>
+
+ERL_NIF_TERM nif_std_msgs_msg_string_type_support(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  ignore_unused(argv);
+
+  if (argc != 0) return enif_make_badarg(env);
+
+  const rosidl_message_type_support_t *ts_p = ROSIDL_GET_MSG_TYPE_SUPPORT(std_msgs, msg, String);
+  rosidl_message_type_support_t *obj = enif_alloc_resource(rt_rosidl_message_type_support_t, sizeof(rosidl_message_type_support_t));
+  *obj = *ts_p;
+  ERL_NIF_TERM term = enif_make_resource(env, obj);
+  enif_release_resource(obj);
+
+  return term;
+}
+// clang-format on
@@ -0,0 +1,5 @@
+#include <erl_nif.h>
+
+// clang-format off
+ERL_NIF_TERM nif_std_msgs_msg_string_type_support(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+// clang-format on
@@ -1,5 +1,7 @@
 // clang-format off
 #include "u_int32_multi_array.h"
+#include "../../std_msgs/msg/multi_array_layout.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +13,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <std_msgs/msg/detail/multi_array_dimension__functions.h>
 #include <std_msgs/msg/detail/multi_array_dimension__struct.h>
@@ -40,6 +43,12 @@ ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_type_support(ErlNifEnv *env, i
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  std_msgs__msg__UInt32MultiArray__destroy((std_msgs__msg__UInt32MultiArray *)message_p);
+}
+
 ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -48,39 +57,27 @@ ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_create(ErlNifEnv *env, int arg
   std_msgs__msg__UInt32MultiArray *message_p = std_msgs__msg__UInt32MultiArray__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  std_msgs__msg__UInt32MultiArray *message_p = (std_msgs__msg__UInt32MultiArray *)*ros_message_pp;
-  std_msgs__msg__UInt32MultiArray__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  std_msgs__msg__UInt32MultiArray *message_p = (std_msgs__msg__UInt32MultiArray *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  std_msgs__msg__UInt32MultiArray *message_p = (std_msgs__msg__UInt32MultiArray *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   int layout_arity;
   const ERL_NIF_TERM *layout_tuple;
@@ -107,21 +104,9 @@ ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set(ErlNifEnv *env, int argc,
     if (!enif_get_tuple(env, layout_dim_head, &layout_dim_i_arity, &layout_dim_i_tuple))
       return enif_make_badarg(env);
 
-    unsigned int layout_dim_i_label_length;
-#if (ERL_NIF_MAJOR_VERSION == 2 && ERL_NIF_MINOR_VERSION >= 17) // OTP-26 and later
-    if (!enif_get_string_length(env, layout_dim_i_tuple[0], &layout_dim_i_label_length, ERL_NIF_LATIN1))
-      return enif_make_badarg(env);
-#else
-    if (!enif_get_list_length(env, layout_dim_i_tuple[0], &layout_dim_i_label_length))
-      return enif_make_badarg(env);
-#endif
-
-    char layout_dim_i_label[layout_dim_i_label_length + 1];
-    if (enif_get_string(env, layout_dim_i_tuple[0], layout_dim_i_label, layout_dim_i_label_length + 1, ERL_NIF_LATIN1) <= 0)
-      return enif_make_badarg(env);
-
-    if (!rosidl_runtime_c__String__assign(&(message_p->layout.dim.data[layout_dim_i].label), layout_dim_i_label))
-      return raise(env, __FILE__, __LINE__);
+    conversion_ret_t layout_dim_i_label_ret = get_string(env, layout_dim_i_tuple[0], &(message_p->layout.dim.data[layout_dim_i].label));
+    if (layout_dim_i_label_ret != CONVERSION_OK)
+      return conversion_error(env, layout_dim_i_label_ret);
 
     unsigned int layout_dim_i_size;
     if (!enif_get_uint(env, layout_dim_i_tuple[1], &layout_dim_i_size))
@@ -148,55 +133,185 @@ ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set(ErlNifEnv *env, int argc,
     return enif_make_badarg(env);
   message_p->data = data;
 
-  unsigned int data_i;
-  ERL_NIF_TERM data_left, data_head, data_tail;
-  for (data_i = 0, data_left = tuple[1]; data_i < data_length; ++data_i, data_left = data_tail)
-  {
-    if (!enif_get_list_cell(env, data_left, &data_head, &data_tail))
-      return enif_make_badarg(env);
-
-    unsigned int data_uint32;
-    if (!enif_get_uint(env, data_head, &data_uint32))
-      return enif_make_badarg(env);
-    message_p->data.data[data_i] = data_uint32;
-  }
+  conversion_ret_t data_ret = get_uint32_array(env, tuple[1], message_p->data.data, data_length);
+  if (data_ret != CONVERSION_OK)
+    return conversion_error(env, data_ret);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+static ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  std_msgs__msg__UInt32MultiArray *message_p = (std_msgs__msg__UInt32MultiArray *)*ros_message_pp;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 
-  ERL_NIF_TERM layout_dim[message_p->layout.dim.size];
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  std_msgs__msg__UInt32MultiArray *message_p = (std_msgs__msg__UInt32MultiArray *)ros_message_p;
 
-  for (size_t layout_dim_i = 0; layout_dim_i < message_p->layout.dim.size; ++layout_dim_i)
+  ERL_NIF_TERM layout_dim = enif_make_list(env, 0);
+
+  for (size_t layout_dim_i = message_p->layout.dim.size; layout_dim_i-- > 0;)
   {
-    layout_dim[layout_dim_i] = enif_make_tuple(env, 3,
+    ERL_NIF_TERM layout_dim_i_term = enif_make_tuple(env, 3,
       enif_make_string(env, message_p->layout.dim.data[layout_dim_i].label.data, ERL_NIF_LATIN1),
       enif_make_uint(env, message_p->layout.dim.data[layout_dim_i].size),
       enif_make_uint(env, message_p->layout.dim.data[layout_dim_i].stride)
     );
-  }
-
-  ERL_NIF_TERM data[message_p->data.size];
-
-  for (size_t data_i = 0; data_i < message_p->data.size; ++data_i)
-  {
-    data[data_i] = enif_make_uint(env, message_p->data.data[data_i]);
+    layout_dim = enif_make_list_cell(env, layout_dim_i_term, layout_dim);
   }
 
   return enif_make_tuple(env, 2,
     enif_make_tuple(env, 2,
-      enif_make_list_from_array(env, layout_dim, message_p->layout.dim.size),
+      layout_dim,
       enif_make_uint(env, message_p->layout.data_offset)
     ),
-    enif_make_list_from_array(env, data, message_p->data.size)
+    make_uint32_list(env, message_p->data.data, 0, message_p->data.size)
   );
 }
+
+static ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+// The size hint of the message, 0 if it isn't one, the conversion then fails right away.
+static size_t size_hint(ErlNifEnv *env, ERL_NIF_TERM term) {
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, term, rt_ros_message, (void **)&ros_message_p)) return 0;
+  const std_msgs__msg__UInt32MultiArray *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return 0;
+
+  size_t elements = 0;
+  elements += message_p->layout.dim.size;
+  elements += message_p->data.size;
+  release_ros_message(ros_message_p);
+
+  return elements;
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_u_int32_multi_array_set", term_size_hint(env, argv[1]), nif_std_msgs_msg_u_int32_multi_array_set_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_u_int32_multi_array_get", size_hint(env, argv[0]), nif_std_msgs_msg_u_int32_multi_array_get_impl, argc, argv);
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const std_msgs__msg__UInt32MultiArray *message_p = (const std_msgs__msg__UInt32MultiArray *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return nif_std_msgs_msg_multi_array_layout_make_field(env, &message_p->layout, rest);
+
+    ERL_NIF_TERM layout_dim = enif_make_list(env, 0);
+
+    for (size_t layout_dim_i = message_p->layout.dim.size; layout_dim_i-- > 0;)
+    {
+      ERL_NIF_TERM layout_dim_i_term = enif_make_tuple(env, 3,
+        enif_make_string(env, message_p->layout.dim.data[layout_dim_i].label.data, ERL_NIF_LATIN1),
+        enif_make_uint(env, message_p->layout.dim.data[layout_dim_i].size),
+        enif_make_uint(env, message_p->layout.dim.data[layout_dim_i].stride)
+      );
+      layout_dim = enif_make_list_cell(env, layout_dim_i_term, layout_dim);
+    }
+
+    return enif_make_tuple(env, 2,
+      layout_dim,
+      enif_make_uint(env, message_p->layout.data_offset)
+    );
+  }
+
+  case 1: {
+    size_t data_size = message_p->data.size;
+
+    if (enif_is_empty_list(env, rest)) {
+      return make_uint32_list(env, message_p->data.data, 0, message_p->data.size);
+    }
+
+    ERL_NIF_TERM data_head, data_rest;
+    if (!enif_get_list_cell(env, rest, &data_head, &data_rest))
+      return enif_make_badarg(env);
+
+    size_t data_i;
+    unsigned long data_index;
+    if (enif_get_ulong(env, data_head, &data_index)) {
+      if (data_index >= data_size) return enif_make_badarg(env);
+      data_i = data_index;
+
+      if (!enif_is_empty_list(env, data_rest))
+        return enif_make_badarg(env);
+
+      return enif_make_uint(env, message_p->data.data[data_i]);
+    }
+
+    int data_arity;
+    const ERL_NIF_TERM *data_slice;
+    unsigned long data_start, data_length;
+    if (!enif_get_tuple(env, data_head, &data_arity, &data_slice) || data_arity != 2 ||
+        !enif_get_ulong(env, data_slice[0], &data_start) ||
+        !enif_get_ulong(env, data_slice[1], &data_length) ||
+        !enif_is_empty_list(env, data_rest))
+      return enif_make_badarg(env);
+
+    if (data_start > data_size) data_start = data_size;
+    if (data_length > data_size - data_start) data_length = data_size - data_start;
+
+    return make_uint32_list(env, message_p->data.data, data_start, data_length);
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+static ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get_field_impl(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_std_msgs_msg_u_int32_multi_array_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  return schedule_conversion(env, "nif_std_msgs_msg_u_int32_multi_array_get_field", size_hint(env, argv[0]), nif_std_msgs_msg_u_int32_multi_array_get_field_impl, argc, argv);
+}
 // clang-format on
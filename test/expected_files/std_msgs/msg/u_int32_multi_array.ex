@@ -32,6 +32,67 @@ defmodule Rclex.Pkgs.StdMsgs.Msg.UInt32MultiArray do
     Nif.std_msgs_msg_u_int32_multi_array_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_msgs_msg_u_int32_multi_array_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:layout | rest]) do
+    [0 | Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout.field_path(rest)]
+  end
+
+  def field_path([:data | rest]) do
+    [1 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:layout | rest], term) do
+    Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout.field_value(rest, term)
+  end
+
+  def field_value([:data | _], term) do
+    term
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{layout: layout, data: data}) do
+    acc
+    |> Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout.cdr_put(layout)
+    |> Rclex.CDR.put_sequence(:uint32, data)
+  end
+
+  def cdr_take(cursor) do
+    {layout, cursor} = Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout.cdr_take(cursor)
+    {data, cursor} = Rclex.CDR.take_sequence(cursor, :uint32)
+    {%__MODULE__{layout: layout, data: data}, cursor}
+  end
+
   def to_tuple(%__MODULE__{layout: layout, data: data}) do
     {Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout.to_tuple(layout), data}
   end
@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_create(ErlNifEnv *env, int arg
 ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_msgs_msg_u_int32_multi_array_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
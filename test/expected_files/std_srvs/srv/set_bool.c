@@ -1,5 +1,6 @@
 // clang-format off
 #include "set_bool.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
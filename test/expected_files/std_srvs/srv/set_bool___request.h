@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_create(ErlNifEnv *env, int argc
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___request_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
@@ -1,5 +1,6 @@
 // clang-format off
 #include "set_bool___response.h"
+#include "../../../conversion.h"
 #include "../../../macros.h"
 #include "../../../resource_types.h"
 #include "../../../terms.h"
@@ -11,6 +12,7 @@
 #include <rosidl_runtime_c/primitives_sequence_functions.h>
 #include <rosidl_runtime_c/string.h>
 #include <rosidl_runtime_c/string_functions.h>
+#include <rosidl_runtime_c/u16string_functions.h>
 
 #include <std_srvs/srv/detail/set_bool__functions.h>
 #include <std_srvs/srv/detail/set_bool__struct.h>
@@ -34,6 +36,12 @@ ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_type_support(ErlNifEnv *env, i
   return term;
 }
 
+static void destroy_message(void *message_p, void *owner_p) {
+  ignore_unused(owner_p);
+
+  std_srvs__srv__SetBool_Response__destroy((std_srvs__srv__SetBool_Response *)message_p);
+}
+
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_create(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   ignore_unused(argv);
 
@@ -42,39 +50,27 @@ ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_create(ErlNifEnv *env, int arg
   std_srvs__srv__SetBool_Response *message_p = std_srvs__srv__SetBool_Response__create();
   if (message_p == NULL) return raise(env, __FILE__, __LINE__);
 
-  void **obj = enif_alloc_resource(rt_ros_message, sizeof(void *));
-  *obj = (void *)message_p;
-  ERL_NIF_TERM term = enif_make_resource(env, obj);
-  enif_release_resource(obj);
-
-  return term;
+  return make_ros_message_resource(env, message_p, sizeof(*message_p), destroy_message, NULL);
 }
 
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
 
-  std_srvs__srv__SetBool_Response *message_p = (std_srvs__srv__SetBool_Response *)*ros_message_pp;
-  std_srvs__srv__SetBool_Response__destroy(message_p);
+  destroy_ros_message(ros_message_p);
 
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2) return enif_make_badarg(env);
-
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
-    return enif_make_badarg(env);
-
-  std_srvs__srv__SetBool_Response *message_p = (std_srvs__srv__SetBool_Response *)*ros_message_pp;
+static ERL_NIF_TERM set_message(ErlNifEnv *env, void *ros_message_p, ERL_NIF_TERM term) {
+  std_srvs__srv__SetBool_Response *message_p = (std_srvs__srv__SetBool_Response *)ros_message_p;
 
   int arity;
   const ERL_NIF_TERM *tuple;
-  if (!enif_get_tuple(env, argv[1], &arity, &tuple)) return enif_make_badarg(env);
+  if (!enif_get_tuple(env, term, &arity, &tuple)) return enif_make_badarg(env);
 
   unsigned int success_length;
   if (!enif_get_atom_length(env, tuple[0], &success_length, ERL_NIF_LATIN1))
@@ -105,18 +101,84 @@ ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_set(ErlNifEnv *env, int argc,
   return atom_ok;
 }
 
-ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1) return enif_make_badarg(env);
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
 
-  void **ros_message_pp;
-  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_pp))
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
     return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
 
-  std_srvs__srv__SetBool_Response *message_p = (std_srvs__srv__SetBool_Response *)*ros_message_pp;
+  ERL_NIF_TERM term = set_message(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+static ERL_NIF_TERM make_message(ErlNifEnv *env, void *ros_message_p) {
+  std_srvs__srv__SetBool_Response *message_p = (std_srvs__srv__SetBool_Response *)ros_message_p;
 
   return enif_make_tuple(env, 2,
     enif_make_atom(env, message_p->success ? "true" : "false"),
     enif_make_string(env, message_p->message.data, ERL_NIF_LATIN1)
   );
 }
+
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = make_message(env, message_p);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
+
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path) {
+  const std_srvs__srv__SetBool_Response *message_p = (const std_srvs__srv__SetBool_Response *)ros_message_p;
+
+  int index;
+  ERL_NIF_TERM head, rest;
+  if (!enif_get_list_cell(env, path, &head, &rest) || !enif_get_int(env, head, &index))
+    return enif_make_badarg(env);
+
+  switch (index) {
+  case 0: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_atom(env, message_p->success ? "true" : "false");
+  }
+
+  case 1: {
+    if (!enif_is_empty_list(env, rest))
+      return enif_make_badarg(env);
+
+    return enif_make_string(env, message_p->message.data, ERL_NIF_LATIN1);
+  }
+  }
+
+  return enif_make_badarg(env);
+}
+
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) return enif_make_badarg(env);
+
+  ros_message_t *ros_message_p;
+  if (!enif_get_resource(env, argv[0], rt_ros_message, (void **)&ros_message_p))
+    return enif_make_badarg(env);
+  void *message_p = acquire_ros_message(ros_message_p);
+  if (message_p == NULL) return enif_make_badarg(env);
+
+  ERL_NIF_TERM term = nif_std_srvs_srv_set_bool___response_make_field(env, message_p, argv[1]);
+  release_ros_message(ros_message_p);
+
+  return term;
+}
 // clang-format on
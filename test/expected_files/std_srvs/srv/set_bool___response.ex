@@ -32,6 +32,67 @@ defmodule Rclex.Pkgs.StdSrvs.Srv.SetBoolResponse do
     Nif.std_srvs_srv_set_bool___response_get!(message) |> to_struct()
   end
 
+  def get_field!(message, []) do
+    get!(message)
+  end
+
+  def get_field!(message, path) do
+    term = Nif.std_srvs_srv_set_bool___response_get_field!(message, field_path(path))
+    field_value(path, term)
+  end
+
+  def serialize!(%__MODULE__{} = struct) do
+    Rclex.Serialization.serialize!(__MODULE__, struct)
+  end
+
+  def deserialize!(binary) do
+    Rclex.Serialization.deserialize!(__MODULE__, binary)
+  end
+
+  def field_path([]) do
+    []
+  end
+
+  def field_path([:success | rest]) do
+    [0 | rest]
+  end
+
+  def field_path([:message | rest]) do
+    [1 | rest]
+  end
+
+  def field_value([], term) do
+    to_struct(term)
+  end
+
+  def field_value([:success], term) do
+    term
+  end
+
+  def field_value([:message], term) do
+    "#{term}"
+  end
+
+  def encode_cdr(%__MODULE__{} = struct) do
+    Rclex.CDR.encode(struct, &cdr_put/2)
+  end
+
+  def decode_cdr(binary) do
+    Rclex.CDR.decode(binary, &cdr_take/1)
+  end
+
+  def cdr_put(acc, %__MODULE__{success: success, message: message}) do
+    acc
+    |> Rclex.CDR.put(:bool, success)
+    |> Rclex.CDR.put(:string, message)
+  end
+
+  def cdr_take(cursor) do
+    {success, cursor} = Rclex.CDR.take(cursor, :bool)
+    {message, cursor} = Rclex.CDR.take(cursor, :string)
+    {%__MODULE__{success: success, message: message}, cursor}
+  end
+
   def to_tuple(%__MODULE__{success: success, message: message}) do
     {
       success,
@@ -6,4 +6,6 @@ ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_create(ErlNifEnv *env, int arg
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_destroy(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_set(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
 ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_get(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_get_field(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+ERL_NIF_TERM nif_std_srvs_srv_set_bool___response_make_field(ErlNifEnv *env, const void *ros_message_p, ERL_NIF_TERM path);
 // clang-format on
@@ -47,4 +47,30 @@ defmodule Mix.Tasks.Rclex.Gen.MsgsTest do
       end
     end
   end
+
+  describe "get_ros2_message_type_map_async/3" do
+    test "equals get_ros2_message_type_map/3 merged over the types" do
+      types = ["geometry_msgs/msg/Twist", "sensor_msgs/msg/PointCloud", "std_msgs/msg/String"]
+
+      expected =
+        Enum.reduce(types, %{}, &Msgs.get_ros2_message_type_map(&1, @ros_share_path, &2))
+
+      assert {^expected, cache} = Msgs.get_ros2_message_type_map_async(types, @ros_share_path)
+      assert map_size(cache) == map_size(expected)
+
+      assert {^expected, ^cache} =
+               Msgs.get_ros2_message_type_map_async(types, @ros_share_path, cache)
+    end
+
+    test "uses the cached fields of unchanged definitions" do
+      type = "std_msgs/msg/String"
+      {_type_map, cache} = Msgs.get_ros2_message_type_map_async([type], @ros_share_path)
+
+      fields = [[{:builtin_type, "int8"}, "cached"]]
+      cache = Map.new(cache, fn {key, _fields} -> {key, fields} end)
+
+      assert {%{{:msg_type, ^type} => ^fields}, _cache} =
+               Msgs.get_ros2_message_type_map_async([type], @ros_share_path, cache)
+    end
+  end
 end
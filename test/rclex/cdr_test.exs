@@ -0,0 +1,52 @@
+defmodule Rclex.CDRTest do
+  use ExUnit.Case
+
+  alias Rclex.CDR
+
+  test "put/3 aligns primitives to their size" do
+    assert <<1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 3, 0>> =
+             <<>>
+             |> CDR.put(:uint8, 1)
+             |> CDR.put(:int64, 2)
+             |> CDR.put(:int16, 3)
+  end
+
+  test "put/3 writes strings with their length including the NUL" do
+    assert <<0, 0, 0, 0, 6, 0, 0, 0, "hello", 0>> =
+             <<>> |> CDR.put(:bool, false) |> CDR.put(:string, "hello")
+  end
+
+  test "take/2 reads what put/3 writes" do
+    binary =
+      <<>>
+      |> CDR.put(:bool, true)
+      |> CDR.put(:float64, 1.5)
+      |> CDR.put(:string, "")
+      |> CDR.put_sequence(:int32, [-1, 0, 1])
+      |> CDR.put_bytes(<<1, 2, 3>>)
+
+    cursor = {binary, 0}
+    assert {true, cursor} = CDR.take(cursor, :bool)
+    assert {1.5, cursor} = CDR.take(cursor, :float64)
+    assert {"", cursor} = CDR.take(cursor, :string)
+    assert {[-1, 0, 1], cursor} = CDR.take_sequence(cursor, :int32)
+    assert {<<1, 2, 3>>, {<<>>, _offset}} = CDR.take_bytes(cursor)
+  end
+
+  test "put/3 writes char as an unsigned byte" do
+    assert <<200>> = CDR.put(<<>>, :char, 200)
+    assert {200, {<<>>, 1}} = CDR.take({<<200>>, 0}, :char)
+  end
+
+  test "put/3 writes wstrings as their UTF-16 code units" do
+    assert <<0, 0, 0, 0, 4, 0, 0, 0, ?h, 0, 0xE9, 0, 0x3D, 0xD8, 0x00, 0xDE>> =
+             binary = <<>> |> CDR.put(:bool, false) |> CDR.put(:wstring, "hé😀")
+
+    {false, cursor} = CDR.take({binary, 0}, :bool)
+    assert {"hé😀", {<<>>, 16}} = CDR.take(cursor, :wstring)
+  end
+
+  test "decode/2 rejects big-endian payloads" do
+    assert_raise ArgumentError, fn -> CDR.decode(<<0, 0, 0, 0, 0>>, & &1) end
+  end
+end
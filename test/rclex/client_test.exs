@@ -9,6 +9,7 @@ defmodule Rclex.ClientTest do
 
   setup do
     capture_log(fn -> Application.stop(:rclex) end)
+    start_supervised!(Rclex.Registry)
     Process.flag(:trap_exit, true)
 
     name = "name"
@@ -39,6 +39,19 @@ defmodule Rclex.Generators.MsgCTest do
     end
   end
 
+  test "generate/2 with message_converter: :introspection" do
+    ros2_message_type = "std_msgs/msg/String"
+    ros2_message_type_map = Msgs.get_ros2_message_type_map(ros2_message_type, @ros_share_path)
+
+    Application.put_env(:rclex, :message_converter, :introspection)
+    on_exit(fn -> Application.delete_env(:rclex, :message_converter) end)
+
+    assert MsgC.generate(ros2_message_type, ros2_message_type_map) ==
+             File.read!(
+               Path.join(File.cwd!(), "test/expected_files/std_msgs/msg/string_type_support.c")
+             )
+  end
+
   for ros2_message_type <- [
         "sensor_msgs/msg/PointCloud",
         "std_msgs/msg/Empty",
@@ -37,6 +37,25 @@ defmodule Rclex.Generators.MsgExTest do
     end
   end
 
+  test "generate/2 with type_support: :lazy" do
+    ros2_message_type = "std_msgs/msg/String"
+    ros2_message_type_map = Msgs.get_ros2_message_type_map(ros2_message_type, @ros_share_path)
+
+    Application.put_env(:rclex, :message_converter, :introspection)
+    Application.put_env(:rclex, :type_support, :lazy)
+
+    on_exit(fn ->
+      Application.delete_env(:rclex, :message_converter)
+      Application.delete_env(:rclex, :type_support)
+    end)
+
+    binary = MsgEx.generate(ros2_message_type, ros2_message_type_map)
+
+    assert binary =~ ~s|Rclex.TypeSupport.fetch!("std_msgs/msg/String")|
+    assert binary =~ "Rclex.Introspection.create!(__MODULE__)"
+    refute binary =~ "Nif."
+  end
+
   describe "fields functions," do
     setup do
       %{
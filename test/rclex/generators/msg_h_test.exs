@@ -32,4 +32,17 @@ defmodule Rclex.Generators.MsgHTest do
                File.read!(Path.join(File.cwd!(), "test/expected_files/#{type_path}.h"))
     end
   end
+
+  test "generate/2 with message_converter: :introspection" do
+    ros2_message_type = "std_msgs/msg/String"
+    ros2_message_type_map = Msgs.get_ros2_message_type_map(ros2_message_type, @ros_share_path)
+
+    Application.put_env(:rclex, :message_converter, :introspection)
+    on_exit(fn -> Application.delete_env(:rclex, :message_converter) end)
+
+    assert MsgH.generate(ros2_message_type, ros2_message_type_map) ==
+             File.read!(
+               Path.join(File.cwd!(), "test/expected_files/std_msgs/msg/string_type_support.h")
+             )
+  end
 end
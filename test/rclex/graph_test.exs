@@ -71,6 +71,20 @@ defmodule Rclex.GraphTest do
     assert 1 = Graph.count_subscribers(node, topic_name)
   end
 
+  test "get_graph_snapshot/1", %{node: node, name: name, namespace: namespace} do
+    assert %{nodes: [{^name, ^namespace, ~c"/"}], topics: topics, services: services} =
+             snapshot = Graph.get_graph_snapshot(node)
+
+    assert {~c"/chatter", [~c"std_msgs/msg/String"]} in topics
+    assert {~c"/set_test_bool", [~c"std_srvs/srv/SetBool"]} in services
+
+    assert [{~c"/chatter", [publisher], [subscription]}] =
+             Enum.filter(snapshot.endpoints, &(elem(&1, 0) == ~c"/chatter"))
+
+    assert %{node_name: ^name, endpoint_type: :publisher, endpoint_gid: _} = publisher
+    assert %{node_name: ^name, endpoint_type: :subscription, qos_profile: _} = subscription
+  end
+
   test "get_node_names/1", %{node: node, name: name, namespace: namespace} do
     assert [{^name, ^namespace}] = Graph.get_node_names(node)
   end
@@ -0,0 +1,119 @@
+defmodule Rclex.IntrospectionTest do
+  use ExUnit.Case
+
+  alias Rclex.Introspection
+  alias Rclex.Pkgs.SensorMsgs.Msg.PointCloud
+  alias Rclex.Pkgs.StdMsgs.Msg.UInt32MultiArray
+
+  @point_cloud %Rclex.Pkgs.SensorMsgs.Msg.PointCloud{
+    header: %Rclex.Pkgs.StdMsgs.Msg.Header{
+      stamp: %Rclex.Pkgs.BuiltinInterfaces.Msg.Time{sec: -1, nanosec: 1},
+      frame_id: "frame_id"
+    },
+    points:
+      for i <- 0..9 do
+        %Rclex.Pkgs.GeometryMsgs.Msg.Point32{x: i * 1.0, y: 0.0, z: 0.0}
+      end,
+    channels: [
+      %Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32{name: "name", values: [0.0, 1.0, 2.0]}
+    ]
+  }
+
+  test "plan!/1 is cached per message type" do
+    assert Introspection.plan!(PointCloud) == Introspection.plan!(PointCloud)
+  end
+
+  test "set!/3, get!/2 sensor_msgs/msg/PointCloud" do
+    message = Introspection.create!(PointCloud)
+
+    try do
+      assert :ok = Introspection.set!(PointCloud, message, PointCloud.to_tuple(@point_cloud))
+      assert @point_cloud == Introspection.get!(PointCloud, message) |> PointCloud.to_struct()
+    after
+      :ok = Introspection.destroy!(PointCloud, message)
+    end
+  end
+
+  test "get_field!/3 sensor_msgs/msg/PointCloud" do
+    message = Introspection.create!(PointCloud)
+
+    get_field! = fn path ->
+      term = Introspection.get_field!(PointCloud, message, PointCloud.field_path(path))
+      PointCloud.field_value(path, term)
+    end
+
+    try do
+      :ok = Introspection.set!(PointCloud, message, PointCloud.to_tuple(@point_cloud))
+
+      assert @point_cloud.header.stamp == get_field!.([:header, :stamp])
+      assert "frame_id" = get_field!.([:header, :frame_id])
+      assert Enum.slice(@point_cloud.points, 2, 3) == get_field!.([:points, {2, 3}])
+      assert 4.0 = get_field!.([:points, 4, :x])
+      assert [1.0, 2.0] = get_field!.([:channels, 0, :values, {1, 2}])
+      assert_raise ArgumentError, fn -> get_field!.([:points, 10]) end
+    after
+      :ok = Introspection.destroy!(PointCloud, message)
+    end
+  end
+
+  test "interoperates with the generated converter" do
+    message = PointCloud.create!()
+
+    try do
+      :ok = PointCloud.set!(message, @point_cloud)
+      assert @point_cloud == Introspection.get!(PointCloud, message) |> PointCloud.to_struct()
+    after
+      :ok = PointCloud.destroy!(message)
+    end
+  end
+
+  test "set!/3, get!/2 std_msgs/msg/UInt32MultiArray with a large sequence" do
+    struct = %UInt32MultiArray{
+      layout: %Rclex.Pkgs.StdMsgs.Msg.MultiArrayLayout{dim: [], data_offset: 0},
+      data: Enum.to_list(1..100_000)
+    }
+
+    message = Introspection.create!(UInt32MultiArray)
+
+    try do
+      :ok = Introspection.set!(UInt32MultiArray, message, UInt32MultiArray.to_tuple(struct))
+      term = Introspection.get!(UInt32MultiArray, message)
+      assert struct == UInt32MultiArray.to_struct(term)
+    after
+      :ok = Introspection.destroy!(UInt32MultiArray, message)
+    end
+  end
+
+  test "get_map!/2 with a type string" do
+    message = Introspection.create!("sensor_msgs/msg/PointCloud")
+
+    try do
+      :ok =
+        Introspection.set!(
+          "sensor_msgs/msg/PointCloud",
+          message,
+          PointCloud.to_tuple(@point_cloud)
+        )
+
+      assert %{
+               header: %{stamp: %{sec: -1, nanosec: 1}, frame_id: "frame_id"},
+               points: [%{x: +0.0, y: +0.0, z: +0.0} | _],
+               channels: [%{name: "name", values: [+0.0, 1.0, 2.0]}]
+             } = Introspection.get_map!("sensor_msgs/msg/PointCloud", message)
+    after
+      :ok = Introspection.destroy!("sensor_msgs/msg/PointCloud", message)
+    end
+  end
+
+  test "set!/3 raises ArgumentError on a malformed term" do
+    message = Introspection.create!(UInt32MultiArray)
+
+    try do
+      assert_raise ArgumentError, fn ->
+        Introspection.set!(UInt32MultiArray, message, {{[], 0}, [-1]})
+      end
+    after
+      :ok = Introspection.destroy!(UInt32MultiArray, message)
+    end
+  end
+end
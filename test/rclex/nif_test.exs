@@ -33,6 +33,40 @@ defmodule Rclex.NifTest do
       assert is_reference(context)
       assert Nif.rcl_fini!(context) == :ok
     end
+
+    test "entities left without finalizing are finalized by their destructors" do
+      %{messages: messages, entities: entities} = Nif.memory_stats!()
+
+      # the publisher keeps the node and the node the context, they are finalized in that order
+      # once the process which holds them is gone
+      {pid, ref} =
+        spawn_monitor(fn ->
+          context = Nif.rcl_init!()
+          node = Nif.rcl_node_init!(context, ~c"name", ~c"/namespace")
+          type_support = Nif.std_msgs_msg_string_type_support!()
+          qos = QoS.profile_default()
+          _publisher = Nif.rcl_publisher_init!(node, type_support, ~c"/chatter", qos)
+          _message = Nif.std_msgs_msg_string_create!()
+          %{messages: held} = Nif.memory_stats!()
+          exit({:held, held.live_allocations})
+        end)
+
+      assert_receive {:DOWN, ^ref, :process, ^pid, {:held, held}}
+      assert held == messages.live_allocations + 1
+
+      assert eventually(fn ->
+               %{messages: %{live_allocations: live}} = Nif.memory_stats!()
+               live == messages.live_allocations
+             end)
+
+      assert eventually(fn ->
+               %{entities: %{live_allocations: live}} = Nif.memory_stats!()
+               live == entities.live_allocations
+             end)
+
+      context = Nif.rcl_init!()
+      assert Nif.rcl_fini!(context) == :ok
+    end
   end
 
   describe "node" do
@@ -109,6 +143,8 @@ defmodule Rclex.NifTest do
       message = Nif.std_msgs_msg_string_create!()
       assert is_reference(message)
       assert Nif.std_msgs_msg_string_destroy!(message) == :ok
+      # destroyed only once
+      assert Nif.std_msgs_msg_string_destroy!(message) == :ok
     end
 
     test "std_msgs_msg_string_set!/1, std_msgs_msg_string_get!/1" do
@@ -188,6 +224,17 @@ defmodule Rclex.NifTest do
 
       :ok = Nif.std_msgs_msg_u_int32_multi_array_destroy!(message)
     end
+
+    test "std_msgs_msg_u_int32_multi_array_get!/1 with a large sequence" do
+      message = Nif.std_msgs_msg_u_int32_multi_array_create!()
+      data = Enum.to_list(1..1_000_000)
+
+      :ok = Nif.std_msgs_msg_u_int32_multi_array_set!(message, {{[], 0}, data})
+
+      assert Nif.std_msgs_msg_u_int32_multi_array_get!(message) == {{[], 0}, data}
+
+      :ok = Nif.std_msgs_msg_u_int32_multi_array_destroy!(message)
+    end
   end
 
   describe "geometry_msgs_msg_vector3" do
@@ -228,6 +275,41 @@ defmodule Rclex.NifTest do
     end
   end
 
+  describe "clock" do
+    test "rcl_clock_init!/1, rcl_clock_get_now!/1, rcl_clock_fini!/1" do
+      for clock_type <- [:ros, :system, :steady] do
+        clock = Nif.rcl_clock_init!(clock_type)
+        assert is_integer(Nif.rcl_clock_get_now!(clock))
+        assert :ok = Nif.rcl_clock_fini!(clock)
+      end
+    end
+
+    test "rcl_clock_init!/1 raise due to wrong clock type" do
+      assert_raise ArgumentError, fn -> Nif.rcl_clock_init!(:wrong) end
+    end
+
+    test "rcl_enable_ros_time_override!/1, rcl_set_ros_time_override!/2" do
+      clock = Nif.rcl_clock_init!(:ros)
+
+      assert :ok = Nif.rcl_enable_ros_time_override!(clock)
+      assert :ok = Nif.rcl_set_ros_time_override!(clock, 1_000_000_000)
+      assert Nif.rcl_clock_get_now!(clock) == 1_000_000_000
+      assert :ok = Nif.rcl_disable_ros_time_override!(clock)
+      assert Nif.rcl_clock_get_now!(clock) > 1_000_000_000
+
+      :ok = Nif.rcl_clock_fini!(clock)
+    end
+
+    test "rcl_set_ros_time_override!/2 raise due to not a ROS clock" do
+      clock = Nif.rcl_clock_init!(:steady)
+
+      assert_raise ArgumentError, fn -> Nif.rcl_enable_ros_time_override!(clock) end
+      assert_raise ArgumentError, fn -> Nif.rcl_set_ros_time_override!(clock, 0) end
+
+      :ok = Nif.rcl_clock_fini!(clock)
+    end
+  end
+
   describe "publisher" do
     setup do
       context = Nif.rcl_init!()
@@ -264,6 +346,52 @@ defmodule Rclex.NifTest do
     end
   end
 
+  describe "allocator" do
+    test "pool_allocator_stats!/0 counts the blocks reused by rmw_serialize!/2" do
+      type_support = Nif.std_msgs_msg_string_type_support!()
+      message = Nif.std_msgs_msg_string_create!()
+      :ok = Nif.std_msgs_msg_string_set!(message, {~c"Hello from Rclex"})
+
+      binary = Nif.rmw_serialize!(type_support, message)
+      %{reuses: reuses} = Nif.pool_allocator_stats!()
+      assert Nif.rmw_serialize!(type_support, message) == binary
+
+      assert %{reuses: reuses_after, cached_bytes: cached_bytes, size_classes: size_classes} =
+               Nif.pool_allocator_stats!()
+
+      assert reuses_after > reuses
+      assert cached_bytes > 0
+      assert Enum.map(size_classes, & &1.size) == Enum.map(4..12, &Integer.pow(2, &1))
+
+      :ok = Nif.std_msgs_msg_string_destroy!(message)
+    end
+  end
+
+  describe "memory" do
+    test "memory_stats!/0 accounts the messages" do
+      %{messages: %{total_allocations: total, total_bytes: total_bytes}} = Nif.memory_stats!()
+
+      message = Nif.std_msgs_msg_string_create!()
+      %{messages: messages} = Nif.memory_stats!()
+      assert messages.total_allocations > total
+      assert messages.total_bytes > total_bytes
+      assert messages.live_allocations > 0
+      assert messages.live_bytes > 0
+
+      :ok = Nif.std_msgs_msg_string_destroy!(message)
+    end
+
+    test "memory_stats!/0 has the counters of each subsystem" do
+      stats = Nif.memory_stats!()
+      assert Map.keys(stats) |> Enum.sort() == [:entities, :graph, :messages, :middleware]
+
+      for {_subsystem, counters} <- stats do
+        assert %{live_bytes: _, live_allocations: _, total_bytes: _, total_allocations: _} =
+                 counters
+      end
+    end
+  end
+
   describe "publish/take" do
     setup do
       context = Nif.rcl_init!()
@@ -294,10 +422,41 @@ defmodule Rclex.NifTest do
       assert Nif.rcl_publish!(publisher, message) == :ok
     end
 
+    test "publish_with_stamp!/4 rejects an offset outside the message", %{
+      publisher: publisher,
+      message: message
+    } do
+      clock = Nif.rcl_clock_init!(:steady)
+
+      assert_raise ArgumentError, fn ->
+        Nif.rcl_publish_with_stamp!(publisher, message, clock, 1_000_000)
+      end
+
+      assert_raise ArgumentError, fn ->
+        Nif.rcl_publish_with_stamp!(publisher, message, clock, 1)
+      end
+
+      :ok = Nif.rcl_clock_fini!(clock)
+    end
+
     test "take!/2 return :error", %{subscription: subscription, message: message} do
       assert Nif.rcl_take!(subscription, message) == :subscription_take_failed
     end
 
+    test "a destroyed message is rejected, not used", %{publisher: publisher} do
+      message = Nif.std_msgs_msg_string_create!()
+      :ok = Nif.std_msgs_msg_string_destroy!(message)
+      :ok = Nif.std_msgs_msg_string_destroy!(message)
+
+      assert_raise ArgumentError, fn -> Nif.rcl_publish!(publisher, message) end
+      assert_raise ArgumentError, fn -> Nif.std_msgs_msg_string_get!(message) end
+      assert_raise ArgumentError, fn -> Nif.std_msgs_msg_string_set!(message, {~c"a"}) end
+      assert_raise ArgumentError, fn -> Nif.std_msgs_msg_string_get_field!(message, [0]) end
+
+      type_support = Nif.std_msgs_msg_string_type_support!()
+      assert_raise ArgumentError, fn -> Nif.rmw_serialize!(type_support, message) end
+    end
+
     test "take!/2", %{
       publisher: publisher,
       subscription: subscription,
@@ -549,6 +708,206 @@ defmodule Rclex.NifTest do
     end
   end
 
+  describe "waiter" do
+    setup do
+      context = Nif.rcl_init!()
+      node = Nif.rcl_node_init!(context, ~c"name", ~c"/namespace")
+      type_support = Nif.std_msgs_msg_string_type_support!()
+      publisher = Nif.rcl_publisher_init!(node, type_support, ~c"/chatter", QoS.profile_default())
+
+      subscription =
+        Nif.rcl_subscription_init!(node, type_support, ~c"/chatter", QoS.profile_default())
+
+      guard_condition = Nif.rcl_guard_condition_init!(context)
+      message = Nif.std_msgs_msg_string_create!()
+      :ok = Nif.std_msgs_msg_string_set!(message, {~c"Hello from Rclex"})
+
+      on_exit(fn ->
+        Nif.std_msgs_msg_string_destroy!(message)
+        Nif.rcl_guard_condition_fini!(guard_condition)
+        Nif.rcl_publisher_fini!(publisher, node)
+        Nif.rcl_subscription_fini!(subscription, node)
+        Nif.rcl_node_fini!(node)
+        Nif.rcl_fini!(context)
+      end)
+
+      %{
+        context: context,
+        publisher: publisher,
+        subscription: subscription,
+        guard_condition: guard_condition,
+        message: message
+      }
+    end
+
+    test "rcl_trigger_guard_condition!/1", %{guard_condition: guard_condition} do
+      assert :ok = Nif.rcl_trigger_guard_condition!(guard_condition)
+    end
+
+    test "waiter_start!/3, waiter_arm!/1, waiter_stop!/1", %{
+      context: context,
+      publisher: publisher,
+      subscription: subscription,
+      guard_condition: guard_condition,
+      message: message
+    } do
+      waiter = Nif.waiter_start!(context, subscription, guard_condition)
+      refute_receive {:new_message, _}, 50
+
+      :ok = Nif.rcl_publish!(publisher, message)
+      :ok = Nif.rcl_publish!(publisher, message)
+      assert_receive {:new_message, 1}, 1000
+
+      # disarmed until the owner has taken
+      refute_receive {:new_message, _}, 50
+      assert Nif.rcl_take!(subscription, message) == :ok
+      assert :ok = Nif.waiter_arm!(waiter)
+      assert_receive {:new_message, 1}, 1000
+      assert Nif.rcl_take!(subscription, message) == :ok
+
+      # a triggered guard condition doesn't wake the owner, stopping the waiter is immediate
+      assert :ok = Nif.waiter_arm!(waiter)
+      :ok = Nif.rcl_trigger_guard_condition!(guard_condition)
+      refute_receive {:new_message, _}, 50
+
+      {time_us, :ok} = :timer.tc(fn -> Nif.waiter_stop!(waiter) end)
+      assert time_us < 100_000
+    end
+
+    test "waiter_start!/3 raise due to not an entity", %{
+      context: context,
+      guard_condition: guard_condition
+    } do
+      assert_raise ArgumentError, fn -> Nif.waiter_start!(context, context, guard_condition) end
+    end
+  end
+
+  describe "event" do
+    setup do
+      context = Nif.rcl_init!()
+      node = Nif.rcl_node_init!(context, ~c"name", ~c"/namespace")
+      type_support = Nif.std_msgs_msg_string_type_support!()
+      qos = %{QoS.profile_default() | reliability: :best_effort}
+      publisher = Nif.rcl_publisher_init!(node, type_support, ~c"/chatter", qos)
+
+      subscription =
+        Nif.rcl_subscription_init!(node, type_support, ~c"/chatter", QoS.profile_default())
+
+      on_exit(fn ->
+        Nif.rcl_publisher_fini!(publisher, node)
+        Nif.rcl_subscription_fini!(subscription, node)
+        Nif.rcl_node_fini!(node)
+        Nif.rcl_fini!(context)
+      end)
+
+      %{context: context, publisher: publisher, subscription: subscription}
+    end
+
+    test "rcl_publisher_event_init!/2, rcl_take_event!/1, rcl_event_fini!/1", %{
+      publisher: publisher
+    } do
+      event = Nif.rcl_publisher_event_init!(publisher, :offered_deadline_missed)
+      assert Nif.rcl_take_event!(event) in [
+               :event_take_failed,
+               %{total_count: 0, total_count_change: 0}
+             ]
+      assert :ok = Nif.rcl_event_fini!(event)
+    end
+
+    test "rcl_subscription_event_init!/2 raise due to a publisher event type", %{
+      subscription: subscription
+    } do
+      assert_raise ArgumentError, fn ->
+        Nif.rcl_subscription_event_init!(subscription, :offered_deadline_missed)
+      end
+    end
+
+    test "waiter_start!/3 on an incompatible QoS event", %{
+      context: context,
+      subscription: subscription
+    } do
+      event = Nif.rcl_subscription_event_init!(subscription, :requested_incompatible_qos)
+      guard_condition = Nif.rcl_guard_condition_init!(context)
+      waiter = Nif.waiter_start!(context, event, guard_condition)
+
+      # the best effort publisher doesn't offer the reliability the subscription requests
+      assert_receive {:new_event, :requested_incompatible_qos, 1}, 5000
+
+      assert %{total_count: 1, total_count_change: 1, last_policy_kind: :reliability} =
+               Nif.rcl_take_event!(event)
+
+      :ok = Nif.waiter_stop!(waiter)
+      :ok = Nif.rcl_guard_condition_fini!(guard_condition)
+      :ok = Nif.rcl_event_fini!(event)
+    end
+  end
+
+  describe "timer_service" do
+    setup do
+      context = Nif.rcl_init!()
+      clock = Nif.rcl_clock_init!(:steady)
+      service = Nif.timer_service_start!(context)
+
+      on_exit(fn ->
+        Nif.timer_service_stop!(service)
+        Nif.rcl_clock_fini!(clock)
+        Nif.rcl_fini!(context)
+      end)
+
+      %{context: context, clock: clock, service: service}
+    end
+
+    test "timer_service_add!/2, timer_service_remove!/2", %{
+      context: context,
+      clock: clock,
+      service: service
+    } do
+      fast = Nif.rcl_timer_init!(context, clock, 10)
+      slow = Nif.rcl_timer_init!(context, clock, 10_000)
+
+      assert :ok = Nif.timer_service_add!(service, slow)
+      assert :ok = Nif.timer_service_add!(service, fast)
+
+      for _ <- 1..3 do
+        assert_receive {:tick, since_last_call, lateness}, 100
+        assert since_last_call > 0 and lateness >= 0
+      end
+
+      assert :ok = Nif.timer_service_remove!(service, fast)
+      flush_ticks()
+      refute_receive {:tick, _, _}, 50
+
+      assert :ok = Nif.timer_service_remove!(service, slow)
+      assert_raise ArgumentError, fn -> Nif.timer_service_remove!(service, slow) end
+
+      :ok = Nif.rcl_timer_fini!(fast)
+      :ok = Nif.rcl_timer_fini!(slow)
+    end
+
+    test "timer_service_add!/2, a timer on an overridden ROS clock", %{
+      context: context,
+      service: service
+    } do
+      clock = Nif.rcl_clock_init!(:ros)
+      :ok = Nif.rcl_enable_ros_time_override!(clock)
+      :ok = Nif.rcl_set_ros_time_override!(clock, 1_000_000_000)
+
+      timer = Nif.rcl_timer_init!(context, clock, 1000)
+      assert :ok = Nif.timer_service_add!(service, timer)
+      refute_receive {:tick, _, _}, 50
+
+      :ok = Nif.rcl_set_ros_time_override!(clock, 2_000_000_000)
+      assert_receive {:tick, 1_000_000_000, 0}, 100
+
+      :ok = Nif.rcl_set_ros_time_override!(clock, 3_500_000_000)
+      assert_receive {:tick, 1_500_000_000, 500_000_000}, 100
+
+      :ok = Nif.timer_service_remove!(service, timer)
+      :ok = Nif.rcl_timer_fini!(timer)
+      :ok = Nif.rcl_clock_fini!(clock)
+    end
+  end
+
   describe "qos" do
     test "struct should be profile default" do
       assert %Rclex.QoS{} == Rclex.QoS.profile_default()
@@ -583,4 +942,23 @@ defmodule Rclex.NifTest do
       assert Nif.test_qos_profile!(qos) == qos
     end
   end
+
+  # the destructors run once the garbage collector has released the resources
+  defp eventually(fun, retries \\ 50) do
+    cond do
+      fun.() -> true
+      retries == 0 -> false
+      true ->
+        Process.sleep(10)
+        eventually(fun, retries - 1)
+    end
+  end
+
+  defp flush_ticks() do
+    receive do
+      {:tick, _, _} -> flush_ticks()
+    after
+      0 -> :ok
+    end
+  end
 end
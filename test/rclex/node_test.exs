@@ -8,6 +8,7 @@ defmodule Rclex.NodeTest do
 
   setup do
     capture_log(fn -> Application.stop(:rclex) end)
+    start_supervised!(Rclex.Registry)
 
     context = Nif.rcl_init!()
     on_exit(fn -> :ok = Nif.rcl_fini!(context) end)
@@ -112,6 +112,101 @@ defmodule Rclex.Pkgs.MsgsTest do
     |> tap(&Rclex.Pkgs.SensorMsgs.Msg.PointCloud.destroy!(&1))
   end
 
+  test "sensor_msgs/msg/PointCloud get_field!/2" do
+    struct = %Rclex.Pkgs.SensorMsgs.Msg.PointCloud{
+      header: %Rclex.Pkgs.StdMsgs.Msg.Header{
+        stamp: %Rclex.Pkgs.BuiltinInterfaces.Msg.Time{sec: -1, nanosec: 1},
+        frame_id: "frame_id"
+      },
+      points:
+        for i <- 0..9 do
+          %Rclex.Pkgs.GeometryMsgs.Msg.Point32{x: i * 1.0, y: 0.0, z: 0.0}
+        end,
+      channels: [
+        %Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32{name: "name", values: [0.0, 1.0, 2.0]}
+      ]
+    }
+
+    alias Rclex.Pkgs.SensorMsgs.Msg.PointCloud
+
+    PointCloud.create!()
+    |> tap(&PointCloud.set!(&1, struct))
+    |> tap(fn message ->
+      assert ^struct = PointCloud.get_field!(message, [])
+      assert struct.header == PointCloud.get_field!(message, [:header])
+      assert struct.header.stamp == PointCloud.get_field!(message, [:header, :stamp])
+      assert "frame_id" = PointCloud.get_field!(message, [:header, :frame_id])
+      assert struct.points == PointCloud.get_field!(message, [:points])
+      assert Enum.slice(struct.points, 2, 3) == PointCloud.get_field!(message, [:points, {2, 3}])
+      assert Enum.slice(struct.points, 8, 2) == PointCloud.get_field!(message, [:points, {8, 5}])
+      assert 4.0 = PointCloud.get_field!(message, [:points, 4, :x])
+      assert [1.0, 2.0] = PointCloud.get_field!(message, [:channels, 0, :values, {1, 2}])
+      assert_raise ArgumentError, fn -> PointCloud.get_field!(message, [:points, 10]) end
+    end)
+    |> tap(&PointCloud.destroy!(&1))
+  end
+
+  test "std_msgs/msg/String encode_cdr/1 and decode_cdr/1" do
+    struct = %Rclex.Pkgs.StdMsgs.Msg.String{data: "hello"}
+
+    assert <<0, 1, 0, 0, 6, 0, 0, 0, "hello", 0>> =
+             binary = Rclex.Pkgs.StdMsgs.Msg.String.encode_cdr(struct)
+
+    assert ^struct = Rclex.Pkgs.StdMsgs.Msg.String.decode_cdr(binary)
+  end
+
+  test "sensor_msgs/msg/PointCloud encode_cdr/1 and decode_cdr/1" do
+    struct = %Rclex.Pkgs.SensorMsgs.Msg.PointCloud{
+      header: %Rclex.Pkgs.StdMsgs.Msg.Header{
+        stamp: %Rclex.Pkgs.BuiltinInterfaces.Msg.Time{sec: -1, nanosec: 1},
+        frame_id: "frame_id"
+      },
+      points: [%Rclex.Pkgs.GeometryMsgs.Msg.Point32{x: 1.0, y: 2.0, z: 3.0}],
+      channels: [
+        %Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32{name: "name", values: [0.0, 1.0, 2.0]}
+      ]
+    }
+
+    binary = Rclex.Pkgs.SensorMsgs.Msg.PointCloud.encode_cdr(struct)
+    assert ^struct = Rclex.Pkgs.SensorMsgs.Msg.PointCloud.decode_cdr(binary)
+  end
+
+  test "std_msgs/msg/Empty encode_cdr/1 and decode_cdr/1" do
+    struct = %Rclex.Pkgs.StdMsgs.Msg.Empty{}
+
+    assert <<0, 1, 0, 0, 0>> = binary = Rclex.Pkgs.StdMsgs.Msg.Empty.encode_cdr(struct)
+    assert ^struct = Rclex.Pkgs.StdMsgs.Msg.Empty.decode_cdr(binary)
+  end
+
+  test "std_msgs/msg/String serialize!/1 and deserialize!/1" do
+    struct = %Rclex.Pkgs.StdMsgs.Msg.String{data: "hello"}
+
+    binary = Rclex.Pkgs.StdMsgs.Msg.String.serialize!(struct)
+    assert ^struct = Rclex.Pkgs.StdMsgs.Msg.String.deserialize!(binary)
+    assert ^struct = Rclex.Pkgs.StdMsgs.Msg.String.decode_cdr(binary)
+  end
+
+  test "sensor_msgs/msg/PointCloud serialize!/1 and deserialize!/1" do
+    struct = %Rclex.Pkgs.SensorMsgs.Msg.PointCloud{
+      header: %Rclex.Pkgs.StdMsgs.Msg.Header{
+        stamp: %Rclex.Pkgs.BuiltinInterfaces.Msg.Time{sec: -1, nanosec: 1},
+        frame_id: "frame_id"
+      },
+      points: [%Rclex.Pkgs.GeometryMsgs.Msg.Point32{x: 1.0, y: 2.0, z: 3.0}],
+      channels: [
+        %Rclex.Pkgs.SensorMsgs.Msg.ChannelFloat32{name: "name", values: [0.0, 1.0, 2.0]}
+      ]
+    }
+
+    binary = Rclex.Pkgs.SensorMsgs.Msg.PointCloud.serialize!(struct)
+    assert byte_size(binary) < byte_size(:erlang.term_to_binary(struct))
+    assert ^struct = Rclex.Pkgs.SensorMsgs.Msg.PointCloud.deserialize!(binary)
+
+    assert_raise ErlangError, fn ->
+      Rclex.Pkgs.SensorMsgs.Msg.PointCloud.deserialize!(binary_part(binary, 0, 8))
+    end
+  end
+
   test "diagnostic_msgs/msg/DiagnosticStatus" do
     struct = %Rclex.Pkgs.DiagnosticMsgs.Msg.DiagnosticStatus{
       level: 3,
@@ -9,6 +9,7 @@ defmodule Rclex.SubscriptionTest do
 
   setup do
     capture_log(fn -> Application.stop(:rclex) end)
+    start_supervised!(Rclex.Registry)
 
     name = "name"
     namespace = "/namespace"
@@ -8,6 +8,7 @@ defmodule Rclex.TimerTest do
 
   setup do
     capture_log(fn -> Application.stop(:rclex) end)
+    start_supervised!(Rclex.Registry)
 
     start_supervised!(
       {PartitionSupervisor, child_spec: Task.Supervisor, name: Rclex.TaskSupervisors}
@@ -0,0 +1,22 @@
+defmodule Rclex.TypeSupportTest do
+  use ExUnit.Case
+
+  alias Rclex.TypeSupport
+
+  test "fetch!/1 resolves a type support once" do
+    type_support = TypeSupport.fetch!("geometry_msgs/msg/Vector3")
+
+    assert is_reference(type_support)
+    assert type_support == TypeSupport.fetch!("geometry_msgs/msg/Vector3")
+    assert "geometry_msgs/msg/Vector3" in TypeSupport.loaded()
+  end
+
+  test "fetch!/1 of a service request type" do
+    assert is_reference(TypeSupport.fetch!("std_srvs/srv/SetBool_Request"))
+  end
+
+  test "fetch!/1 raises on an invalid type" do
+    assert_raise ArgumentError, fn -> TypeSupport.fetch!("geometry_msgs/Vector3") end
+    assert_raise ErlangError, fn -> TypeSupport.fetch!("geometry_msgs/msg/None") end
+  end
+end
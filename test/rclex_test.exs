@@ -3,6 +3,8 @@ defmodule RclexTest do
 
   import ExUnit.CaptureLog
 
+  alias Rclex.Pkgs.BuiltinInterfaces
+  alias Rclex.Pkgs.SensorMsgs
   alias Rclex.Pkgs.StdMsgs
   alias Rclex.Pkgs.StdSrvs
   alias Rclex.Pkgs.RclInterfaces
@@ -77,6 +79,11 @@ defmodule RclexTest do
       assert {:error, _} = Rclex.start_publisher(StdMsgs.Msg.String, "chatter", "name")
     end
 
+    test "start_publisher/4 with stamp:, message type without header" do
+      assert {:error, _} =
+               Rclex.start_publisher(StdMsgs.Msg.String, "/chatter", "name", stamp: :ros)
+    end
+
     test "stop_publisher/3" do
       :ok = Rclex.start_publisher(StdMsgs.Msg.String, "/chatter", "name")
 
@@ -160,6 +167,127 @@ defmodule RclexTest do
         assert_receive ^message
       end
     end
+
+    test "start_subscription/5 with lazy: true", %{name: name} do
+      me = self()
+      topic_name = "/lazy_chatter"
+
+      callback = fn message ->
+        send(me, StdMsgs.Msg.String.get_field!(message, [:data]))
+      end
+
+      :ok = Rclex.start_subscription(callback, StdMsgs.Msg.String, topic_name, name, lazy: true)
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, topic_name, name)
+
+      for i <- 1..10 do
+        data = "lazy #{i}"
+        :ok = Rclex.publish(struct(StdMsgs.Msg.String, %{data: data}), topic_name, name)
+        assert_receive ^data
+      end
+    end
+
+    test "start_subscription/5 with a type string", %{name: name} do
+      me = self()
+      topic_name = "/dynamic_chatter"
+
+      :ok = Rclex.start_subscription(&send(me, &1), "std_msgs/msg/String", topic_name, name)
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, topic_name, name)
+
+      for i <- 1..10 do
+        data = "dynamic #{i}"
+        :ok = Rclex.publish(struct(StdMsgs.Msg.String, %{data: data}), topic_name, name)
+        assert_receive %{data: ^data}
+      end
+
+      :ok = Rclex.stop_subscription("std_msgs/msg/String", topic_name, name)
+    end
+
+    test "start_publisher/4 with stamp: :ros", %{name: name} do
+      me = self()
+      topic_name = "/stamped"
+
+      :ok = Rclex.start_subscription(&send(me, &1), SensorMsgs.Msg.PointCloud, topic_name, name)
+      :ok = Rclex.start_publisher(SensorMsgs.Msg.PointCloud, topic_name, name, stamp: :ros)
+
+      zero = %BuiltinInterfaces.Msg.Time{sec: 0, nanosec: 0}
+      header = %StdMsgs.Msg.Header{stamp: zero, frame_id: ""}
+      message = %SensorMsgs.Msg.PointCloud{header: header, points: [], channels: []}
+
+      before = Rclex.now(:ros)
+      :ok = Rclex.publish(message, topic_name, name)
+
+      assert_receive %SensorMsgs.Msg.PointCloud{header: %StdMsgs.Msg.Header{stamp: stamp}}
+      assert stamp.sec * 1_000_000_000 + stamp.nanosec in before..Rclex.now(:ros)
+    end
+  end
+
+  describe "QoS events" do
+    setup do
+      name = "name"
+      :ok = Rclex.start_node(name)
+      on_exit(fn -> capture_log(fn -> Rclex.stop_node(name) end) end)
+
+      %{name: name}
+    end
+
+    test "start_subscription/5 with events:", %{name: name} do
+      me = self()
+      topic_name = "/incompatible"
+      qos = %{Rclex.QoS.profile_default() | reliability: :best_effort}
+
+      opts = [events: [:requested_incompatible_qos], event_callback: &send(me, {&1, &2})]
+      :ok = Rclex.start_subscription(&send(me, &1), StdMsgs.Msg.String, topic_name, name, opts)
+
+      # the best effort publisher doesn't offer the reliability the subscription requests
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, topic_name, name, qos: qos)
+
+      assert_receive {:requested_incompatible_qos, status}, 5000
+      assert %{last_policy_kind: :reliability, total_count: total_count} = status
+      assert total_count >= 1
+    end
+
+    test "start_publisher/4 with events:, unknown event type", %{name: name} do
+      assert_raise MatchError, fn ->
+        Rclex.start_publisher(StdMsgs.Msg.String, "/chatter", name, events: [:message_lost])
+      end
+    end
+
+    if System.fetch_env!("ROS_DISTRO") == "foxy" do
+      test "start_subscription/5 with events: [:message_lost] on foxy", %{name: name} do
+        assert_raise MatchError, fn ->
+          Rclex.start_subscription(fn _ -> nil end, StdMsgs.Msg.String, "/chatter", name,
+            events: [:message_lost]
+          )
+        end
+      end
+    end
+  end
+
+  describe "clock" do
+    test "now/1" do
+      for clock_type <- [:ros, :system, :steady] do
+        before = Rclex.now(clock_type)
+        assert before <= Rclex.now(clock_type)
+      end
+
+      assert_in_delta Rclex.now(:system), System.os_time(:nanosecond), 1_000_000_000
+    end
+
+    test "start_node/2 with use_sim_time: true" do
+      :ok = Rclex.start_node("sim", use_sim_time: true)
+      assert Rclex.now(:ros) == 0
+
+      me = self()
+      :ok = Rclex.start_timer(1000, fn -> send(me, :tick) end, "timer", "sim", clock: :ros)
+      refute_receive :tick, 50
+
+      :ok = Rclex.Clock.set_ros_time!(1_000_000_000)
+      assert_receive :tick, 100
+      assert Rclex.now(:ros) == 1_000_000_000
+
+      capture_log(fn -> :ok = Rclex.stop_node("sim") end)
+      assert Rclex.now(:ros) > 1_000_000_000
+    end
   end
 
   describe "service" do
@@ -333,6 +461,18 @@ defmodule RclexTest do
       assert {:error, :already_started} = Rclex.start_timer(10, callback, "timer", "name")
     end
 
+    test "start_timer/4, callbacks of many timers" do
+      me = self()
+
+      for i <- 1..50 do
+        :ok = Rclex.start_timer(10 * i, fn -> send(me, {:tick, i}) end, "timer#{i}", "name")
+      end
+
+      assert_receive {:tick, 1}, 100
+      assert_receive {:tick, 1}, 100
+      assert_receive {:tick, 5}, 200
+    end
+
     test "start_timer/4, node doesn't exist", %{callback: callback} do
       assert {:noproc, _} = catch_exit(Rclex.start_timer(10, callback, "timer", "notexists"))
     end
@@ -341,6 +481,85 @@ defmodule RclexTest do
       assert {:error, _} = Rclex.start_timer(10, fn _wrong_args -> nil end, "timer", "name")
     end
 
+    test "start_timer/4, overrun: :skip_if_busy" do
+      me = self()
+      callback = fn -> send(me, :called) && Process.sleep(100) end
+
+      :ok = Rclex.start_timer(10, callback, "timer", "name", overrun: :skip_if_busy)
+
+      assert_receive :called, 100
+      refute_receive :called, 50
+
+      assert %{skipped: skipped} = Rclex.timer_stats("timer", "name")
+      assert skipped > 0
+    end
+
+    test "timer_stats/3", %{callback: callback} do
+      :ok = Rclex.start_timer(10, callback, "timer", "name")
+      Process.sleep(100)
+
+      assert %{
+               ticks: ticks,
+               missed: _,
+               skipped: 0,
+               period_histogram: histogram,
+               jitter: %{max: _, mean: _},
+               callback: %{count: count, max: _, mean: _}
+             } = Rclex.timer_stats("timer", "name")
+
+      assert ticks > 0 and count > 0
+      assert histogram |> Map.values() |> Enum.sum() == ticks
+      assert {:error, :not_found} = Rclex.timer_stats("notexists", "name")
+    end
+
+    test "cancel_timer/3, reset_timer/3" do
+      me = self()
+      :ok = Rclex.start_timer(10, fn -> send(me, :tick) end, "timer", "name")
+      assert_receive :tick, 100
+
+      assert :ok = Rclex.cancel_timer("timer", "name")
+      Process.sleep(20)
+      flush_ticks()
+      refute_receive :tick, 50
+
+      assert :ok = Rclex.reset_timer("timer", "name")
+      assert_receive :tick, 100
+
+      assert {:error, :not_found} = Rclex.cancel_timer("notexists", "name")
+      assert {:error, :not_found} = Rclex.reset_timer("notexists", "name")
+    end
+
+    test "change_timer_period/4" do
+      me = self()
+      :ok = Rclex.start_timer(10_000, fn -> send(me, :tick) end, "timer", "name")
+
+      assert :ok = Rclex.change_timer_period(10, "timer", "name")
+      assert :ok = Rclex.reset_timer("timer", "name")
+      assert_receive :tick, 100
+      assert_receive :tick, 100
+
+      assert {:error, :not_found} = Rclex.change_timer_period(10, "notexists", "name")
+      assert_raise FunctionClauseError, fn -> Rclex.change_timer_period(0, "timer", "name") end
+    end
+
+    test "start_timer/4, a period of 0" do
+      assert_raise FunctionClauseError, fn ->
+        Rclex.start_timer(0, fn -> nil end, "timer", "name")
+      end
+    end
+
+    test "start_timer/4, one_shot: true" do
+      me = self()
+      :ok = Rclex.start_timer(10, fn -> send(me, :tick) end, "timer", "name", one_shot: true)
+
+      assert_receive :tick, 100
+      refute_receive :tick, 50
+      assert %{ticks: 1} = Rclex.timer_stats("timer", "name")
+
+      assert :ok = Rclex.reset_timer("timer", "name")
+      assert_receive :tick, 100
+    end
+
     test "stop_timer/3", %{callback: callback} do
       :ok = Rclex.start_timer(10, callback, "timer", "name")
 
@@ -403,6 +622,94 @@ defmodule RclexTest do
       assert 1 = Rclex.count_subscribers(name, topic_name)
     end
 
+    test "graph queries of a node not started", %{topic_name: topic_name} do
+      assert {:error, :not_found} = Rclex.count_publishers("not_started", topic_name)
+      assert {:error, :not_found} = Rclex.get_topic_names_and_types("not_started")
+    end
+
+    test "graph queries run concurrently, not in the node process", %{name: name} do
+      :sys.suspend(Rclex.Node.name(name))
+
+      try do
+        tasks = for _ <- 1..10, do: Task.async(fn -> Rclex.get_node_names(name) end)
+        assert Enum.all?(Task.await_many(tasks), &({name, "/"} in &1))
+      after
+        :sys.resume(Rclex.Node.name(name))
+      end
+    end
+
+    test "graph queries are cached until the graph changes", %{name: name} do
+      generation = Rclex.graph_generation(name)
+      assert 0 = Rclex.count_publishers(name, "/cached")
+      assert 0 = Rclex.count_publishers(name, "/cached")
+      assert ^generation = Rclex.graph_generation(name)
+
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, "/cached", name)
+      :timer.sleep(50)
+
+      assert Rclex.graph_generation(name) > generation
+      assert 1 = Rclex.count_publishers(name, "/cached")
+      assert {:error, :not_found} = Rclex.graph_generation("not_started")
+    end
+
+    test "subscribe_graph_events/2", %{name: name, topic_name: topic_name} do
+      assert :ok = Rclex.subscribe_graph_events(name)
+      assert {:error, :already_subscribed} = Rclex.subscribe_graph_events(name)
+      assert_receive {:graph_event, {:node_added, ^name, "/"}}
+      assert_receive {:graph_event, {:topic_added, ^topic_name, ["std_msgs/msg/String"]}}
+
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, "/events", name)
+      assert_receive {:graph_event, {:topic_added, "/events", ["std_msgs/msg/String"]}}
+      assert_receive {:graph_event, {:endpoint_added, %{topic_name: "/events"} = info}}
+      assert %{node_name: ^name, endpoint_type: :publisher} = info
+
+      :ok = Rclex.stop_publisher(StdMsgs.Msg.String, "/events", name)
+      assert_receive {:graph_event, {:endpoint_removed, %{topic_name: "/events"}}}
+      assert_receive {:graph_event, {:topic_removed, "/events", ["std_msgs/msg/String"]}}
+
+      assert :ok = Rclex.unsubscribe_graph_events(name)
+      assert {:error, :not_found} = Rclex.unsubscribe_graph_events(name)
+    end
+
+    test "the graph watcher doesn't hold up the node process", %{name: name} do
+      :ok = Rclex.subscribe_graph_events(name)
+      :sys.suspend(Rclex.GraphWatcher.name(name))
+
+      try do
+        assert :ok = Rclex.start_publisher(StdMsgs.Msg.String, "/unblocked", name)
+      after
+        :sys.resume(Rclex.GraphWatcher.name(name))
+      end
+
+      assert_receive {:graph_event, {:topic_added, "/unblocked", ["std_msgs/msg/String"]}}
+    end
+
+    test "wait_for_publishers/4", %{name: name, topic_name: topic_name} do
+      assert {:ok, ref} = Rclex.wait_for_publishers(name, topic_name, 1)
+      assert_receive {:graph_wait, ^ref, :ok}
+
+      assert {:ok, ref} = Rclex.wait_for_publishers(name, topic_name, 2, timeout: 10)
+      assert_receive {:graph_wait, ^ref, {:error, :timeout}}
+
+      assert {:ok, ref} = Rclex.wait_for_publishers(name, "/waited", 1, timeout: 5_000)
+      refute_received {:graph_wait, ^ref, _}
+      :ok = Rclex.start_publisher(StdMsgs.Msg.String, "/waited", name)
+      assert_receive {:graph_wait, ^ref, :ok}, 1_000
+    end
+
+    test "wait_for_subscribers/4", %{name: name, topic_name: topic_name} do
+      assert {:ok, ref} = Rclex.wait_for_subscribers(name, topic_name, 1)
+      assert_receive {:graph_wait, ^ref, :ok}
+
+      assert {:ok, ref} = Rclex.wait_for_subscribers(name, topic_name, 2, timeout: 10)
+      assert_receive {:graph_wait, ^ref, {:error, :timeout}}
+
+      assert {:ok, ref} = Rclex.wait_for_subscribers(name, "/waited", 1, timeout: 5_000)
+      refute_received {:graph_wait, ^ref, _}
+      :ok = Rclex.start_subscription(fn _msg -> nil end, StdMsgs.Msg.String, "/waited", name)
+      assert_receive {:graph_wait, ^ref, :ok}, 1_000
+    end
+
     test "get_client_names_and_types_by_node/4", %{name: name, service_name: service_name} do
       assert [{^service_name, ["rcl_interfaces/srv/GetParameterTypes"]}] =
                Rclex.get_client_names_and_types_by_node(
@@ -412,6 +719,16 @@ defmodule RclexTest do
                )
     end
 
+    test "get_graph_snapshot/2", %{name: name, topic_name: topic_name} do
+      assert %{nodes: [{^name, "/", "/"}], topics: topics, endpoints: endpoints} =
+               Rclex.get_graph_snapshot(name)
+
+      assert {topic_name, ["std_msgs/msg/String"]} in topics
+      assert [:publisher, :subscription] =
+               for(%{topic_name: ^topic_name} = info <- endpoints, do: info.endpoint_type)
+               |> Enum.sort()
+    end
+
     test "get_node_names/2", %{} do
       assert [{"name", "/"}] = Rclex.get_node_names("name")
     end
@@ -495,4 +812,12 @@ defmodule RclexTest do
         Rclex.service_server_available?(service_type, "/does_not_exist", name)
     end
   end
+
+  defp flush_ticks() do
+    receive do
+      :tick -> flush_ticks()
+    after
+      0 -> :ok
+    end
+  end
 end